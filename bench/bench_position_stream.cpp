@@ -0,0 +1,96 @@
+// Microbenchmark de Utils::positionBounds y Utils::normalizePositions frente a las tres pasadas
+// escalares que hacía Model::Process antes (AABB, reescalado y AABB final). Comprueba además
+// que el resultado es idéntico al bit.
+//
+//   bench_position_stream [vértices] [repeticiones]
+#include "Scene/PositionStream.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+    // Referencia: Model::Normalize y el cálculo de localMin/MaxBounds de Process antes de PositionStream
+    void ReferenceThreePass(std::vector<float>& vertices, glm::vec3& outMin, glm::vec3& outMax) {
+        glm::vec3 minBounds(std::numeric_limits<float>::max());
+        glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i < vertices.size(); i += 8) {
+            glm::vec3 pos(vertices[i], vertices[i + 1], vertices[i + 2]);
+            minBounds = glm::min(minBounds, pos);
+            maxBounds = glm::max(maxBounds, pos);
+        }
+
+        glm::vec3 size = maxBounds - minBounds;
+        float scale = 1.0f / std::max(size.x, std::max(size.y, size.z));
+        glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+        for (size_t i = 0; i < vertices.size(); i += 8) {
+            vertices[i + 0] = (vertices[i + 0] - center.x) * scale;
+            vertices[i + 1] = (vertices[i + 1] - center.y) * scale;
+            vertices[i + 2] = (vertices[i + 2] - center.z) * scale;
+        }
+
+        outMin = glm::vec3(FLT_MAX);
+        outMax = glm::vec3(-FLT_MAX);
+        for (size_t i = 0; i < vertices.size(); i += 8) {
+            glm::vec3 pos(vertices[i], vertices[i + 1], vertices[i + 2]);
+            outMin = glm::min(outMin, pos);
+            outMax = glm::max(outMax, pos);
+        }
+    }
+
+    void Fused(std::vector<float>& vertices, glm::vec3& outMin, glm::vec3& outMax) {
+        size_t vertexCount = vertices.size() / 8;
+        Utils::positionBounds(vertices.data(), vertexCount, outMin, outMax);
+        Utils::normalizePositions(vertices.data(), vertexCount, outMin, outMax);
+    }
+
+    // Mejor tiempo de 'repeats' ejecuciones, cada una sobre una copia fresca de 'source'
+    template <typename Pass>
+    double BestMs(const std::vector<float>& source, int repeats, Pass pass,
+                  std::vector<float>& result, glm::vec3& minBounds, glm::vec3& maxBounds) {
+        double best = std::numeric_limits<double>::max();
+        for (int r = 0; r < repeats; ++r) {
+            result = source;
+            auto start = std::chrono::high_resolution_clock::now();
+            pass(result, minBounds, maxBounds);
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t vertexCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 6000000;
+    int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    // Posiciones, normales y UV aleatorias con el stride de Model::vertices
+    std::vector<float> source(vertexCount * 8);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-50.0f, 80.0f), unit(-1.0f, 1.0f);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        float* vertex = &source[v * 8];
+        for (int k = 0; k < 3; ++k) vertex[k] = position(rng);
+        for (int k = 3; k < 8; ++k) vertex[k] = unit(rng);
+    }
+
+    std::vector<float> reference, fused;
+    glm::vec3 referenceMin, referenceMax, fusedMin, fusedMax;
+    double referenceMs = BestMs(source, repeats, ReferenceThreePass, reference, referenceMin, referenceMax);
+    double fusedMs = BestMs(source, repeats, Fused, fused, fusedMin, fusedMax);
+
+    bool identical = std::memcmp(reference.data(), fused.data(), reference.size() * sizeof(float)) == 0 &&
+                     referenceMin == fusedMin && referenceMax == fusedMax;
+
+    std::printf("%zu vértices, mejor de %d\n", vertexCount, repeats);
+    std::printf("  tres pasadas escalares (referencia)  %8.2f ms\n", referenceMs);
+    std::printf("  positionBounds + normalizePositions  %8.2f ms  (%.2fx)\n", fusedMs, referenceMs / fusedMs);
+    std::printf("  resultado %s\n", identical ? "idéntico" : "DISTINTO");
+    return identical ? 0 : 1;
+}
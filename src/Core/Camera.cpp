@@ -17,6 +17,7 @@ Camera::Camera(int screenWidth, int screenHeight, glm::vec3 startEye, glm::vec3
 void Camera::updateScreenSize(int newWidth, int newHeight) {
     this->width = (float)newWidth;
     this->height = (float)newHeight;
+    generation++;
 }
 
 glm::mat4 Camera::getViewMatrix() const {
@@ -54,6 +55,7 @@ void Camera::handleInput(GLFWwindow* window) {
             if (eye.y < 0.1f) {
                 eye.y = 0.1f;
             }
+            if (deltaMouse != glm::vec2(0.0f)) generation++;
         }
     } else {           
         isDragging = false; 
@@ -76,4 +78,5 @@ void Camera::ProcessMouseScroll(float yoffset) {
         eye.y = minHeight;
 
     }
+    generation++;
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ public:
     float speed;
     float width;
     float height;
+    unsigned long long generation = 0; // Aumenta cada vez que cambia la vista o la proyección
 
     Camera(int screenWidth, int screenHeight, glm::vec3 startEye, glm::vec3 startTarget);
 
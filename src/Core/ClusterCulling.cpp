@@ -0,0 +1,65 @@
+#include "ClusterCulling.h"
+#include "../Scene/Transform.h"
+#include <algorithm>
+
+namespace Utils {
+    void cullClusters(Model& mesh, const glm::mat4& worldMatrix, const Frustum& frustum, const glm::vec3& cameraPos,
+                      bool useMeshlets, bool backfaceCulling, ClusterStats& stats) {
+        mesh.clearBatches();
+        if (mesh.materialRanges.empty()) return;
+
+        glm::mat3 linear(worldMatrix);
+        float scale = std::max(glm::length(linear[0]), std::max(glm::length(linear[1]), glm::length(linear[2])));
+
+        // La orientación de una cara respecto a la cámara no cambia con una transformación afín,
+        // así que el cono se prueba en espacio local. Un espejo invierte el orden de vértices.
+        bool testCones = backfaceCulling && glm::determinant(linear) > 0.0f;
+        glm::vec3 localCamera = glm::vec3(glm::inverse(worldMatrix) * glm::vec4(cameraPos, 1.0f));
+
+        bool testSubmeshes = mesh.submeshes.size() > 1; // Con una sola, ya la probó el culling del modelo
+        for (const Submesh& submesh : mesh.submeshes) {
+            if (!submesh.visible) continue;
+            stats.submeshesTested++;
+
+            if (testSubmeshes) {
+                glm::vec3 worldMin, worldMax;
+                Transform::TransformBounds(worldMatrix, submesh.minBounds, submesh.maxBounds, worldMin, worldMax);
+                if (!isBoxInFrustum(frustum, worldMin, worldMax)) {
+                    stats.submeshesCulled++;
+                    continue;
+                }
+            }
+
+            for (unsigned int r = submesh.firstRange; r < submesh.firstRange + submesh.rangeCount; ++r) {
+                const MaterialRange& range = mesh.materialRanges[r];
+                if (!useMeshlets || range.meshletCount == 0) {
+                    mesh.addToBatch(range.slot, range.firstIndex, range.indexCount);
+                    continue;
+                }
+
+                for (unsigned int m = range.firstMeshlet; m < range.firstMeshlet + range.meshletCount; ++m) {
+                    const Meshlet& meshlet = mesh.meshlets[m];
+                    stats.tested++;
+
+                    glm::vec3 worldCenter = glm::vec3(worldMatrix * glm::vec4(meshlet.center, 1.0f));
+                    if (!isSphereInFrustum(frustum, worldCenter, meshlet.radius * scale)) {
+                        stats.frustumCulled++;
+                        continue;
+                    }
+
+                    if (testCones) {
+                        glm::vec3 toCluster = meshlet.center - localCamera;
+                        if (glm::dot(toCluster, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCluster) + meshlet.radius) {
+                            stats.backfaceCulled++;
+                            continue;
+                        }
+                    }
+                    mesh.addToBatch(range.slot, meshlet.firstIndex, meshlet.indexCount);
+                }
+            }
+        }
+        for (const MaterialBatch& batch : mesh.batches) {
+            stats.drawRanges += static_cast<int>(batch.counts.size());
+        }
+    }
+}
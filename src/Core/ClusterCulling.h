@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "FrustumCulling.h"
+#include "../Scene/Model.h"
+
+struct ClusterStats {
+    int submeshesTested = 0; // Submallas visibles (no ocultas) evaluadas este frame
+    int submeshesCulled = 0; // Descartadas por quedar su AABB fuera del frustum
+    int tested = 0;          // Meshlets evaluados este frame
+    int frustumCulled = 0;   // Descartados por quedar fuera del frustum
+    int backfaceCulled = 0;  // Descartados porque su cono de normales mira en dirección contraria
+    int drawRanges = 0;      // Rangos enviados en los glMultiDrawElements
+};
+
+namespace Utils {
+    // Deja en los lotes de material de 'mesh' los rangos visibles del nivel 0: se saltan las
+    // submallas ocultas o fuera del frustum y, si 'useMeshlets', dentro de las que quedan los
+    // meshlets fuera de cámara o de espaldas. Los rangos contiguos se fusionan.
+    // 'backfaceCulling' debe reflejar si GL descarta las caras traseras; si no, un cluster de
+    // espaldas sigue siendo visible.
+    void cullClusters(Model& mesh, const glm::mat4& worldMatrix, const Frustum& frustum, const glm::vec3& cameraPos,
+                      bool useMeshlets, bool backfaceCulling, ClusterStats& stats);
+}
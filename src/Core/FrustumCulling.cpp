@@ -1,12 +1,8 @@
 #include "FrustumCulling.h"
+#include <cfloat>
 
 namespace Utils {
-    bool isAABBInFrustum(const Model& model, const glm::mat4& viewProj) {
-        glm::vec3 min = model.localMinBounds;
-        glm::vec3 max = model.localMaxBounds;
-        
-        glm::mat4 MVP = viewProj * model.transformMatrix;
-
+    bool isBoxInFrustum(const glm::vec3& min, const glm::vec3& max, const glm::mat4& MVP) {
         glm::vec4 corners[8] = {
             MVP * glm::vec4(min.x, min.y, min.z, 1.0f),
             MVP * glm::vec4(max.x, min.y, min.z, 1.0f),
@@ -31,4 +27,58 @@ namespace Utils {
 
         return !(outLeft == 8 || outRight == 8 || outBottom == 8 || outTop == 8 || outNear == 8 || outFar == 8);
     }
-}
\ No newline at end of file
+
+    Frustum extractFrustum(const glm::mat4& viewProj) {
+        // Método de Gribb-Hartmann: cada plano es la 4ª fila más o menos una de las otras
+        glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+        glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+        glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+        glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+        Frustum frustum;
+        frustum.planes[0] = row3 + row0; // Izquierda
+        frustum.planes[1] = row3 - row0; // Derecha
+        frustum.planes[2] = row3 + row1; // Abajo
+        frustum.planes[3] = row3 - row1; // Arriba
+        frustum.planes[4] = row3 + row2; // Cerca
+        frustum.planes[5] = row3 - row2; // Lejos
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool isSphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius) {
+        for (const glm::vec4& plane : frustum.planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    bool isBoxInFrustum(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max) {
+        for (const glm::vec4& plane : frustum.planes) {
+            // Vértice de la caja más adentrado en el semiespacio interior del plano
+            glm::vec3 positive(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    bool isAABBInFrustum(const Bounds& bounds, const glm::mat4& viewProj) {
+        return isBoxInFrustum(bounds.worldMin, bounds.worldMax, viewProj);
+    }
+
+    float projectedScreenSize(const glm::vec3& min, const glm::vec3& max, const glm::mat4& viewProj, const glm::vec2& viewport) {
+        glm::vec2 ndcMin(FLT_MAX), ndcMax(-FLT_MAX);
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+            glm::vec4 clip = viewProj * glm::vec4(corner, 1.0f);
+            if (clip.w <= 0.0f) return FLT_MAX;
+            glm::vec2 ndc = glm::vec2(clip) / clip.w;
+            ndcMin = glm::min(ndcMin, ndc);
+            ndcMax = glm::max(ndcMax, ndc);
+        }
+        glm::vec2 pixels = (ndcMax - ndcMin) * 0.5f * viewport;
+        return glm::max(pixels.x, pixels.y);
+    }
+}
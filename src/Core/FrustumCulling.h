@@ -1,9 +1,26 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include "../Scene/Model.h"
+#include "../Scene/Scene.h"
 
 namespace Utils {
-    
-    bool isAABBInFrustum(const Model& model, const glm::mat4& viewProj);
+    // Planos (ax + by + cz + d >= 0 dentro) extraídos de una matriz vista-proyección
+    struct Frustum {
+        glm::vec4 planes[6];
+    };
+
+    Frustum extractFrustum(const glm::mat4& viewProj);
+    bool isSphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+    bool isBoxInFrustum(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max);
+
+
+    // Prueba una caja [min, max] transformada por MVP contra los 6 planos del volumen de recorte
+    bool isBoxInFrustum(const glm::vec3& min, const glm::vec3& max, const glm::mat4& MVP);
+
+    // Prueba la AABB de mundo ya cacheada de un modelo
+    bool isAABBInFrustum(const Bounds& bounds, const glm::mat4& viewProj);
+
+    // Lado mayor, en píxeles, del rectángulo que ocupa la caja proyectada. Si algún vértice queda
+    // detrás del plano cercano la proyección no es fiable y se devuelve FLT_MAX.
+    float projectedScreenSize(const glm::vec3& min, const glm::vec3& max, const glm::mat4& viewProj, const glm::vec2& viewport);
 }
\ No newline at end of file
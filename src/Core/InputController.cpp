@@ -1,6 +1,6 @@
 #include "InputController.h"
 
-void InputController::handleModelRotation(GLFWwindow* window, Model& model, glm::vec2& lastMousePos, float sensitivity) {
+void InputController::handleModelRotation(GLFWwindow* window, Transform& transform, glm::vec2& lastMousePos, float sensitivity) {
     static bool isRotating = false;
 
     if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
@@ -20,10 +20,10 @@ void InputController::handleModelRotation(GLFWwindow* window, Model& model, glm:
         glm::vec2 currentMousePos(mouseX, mouseY);
         glm::vec2 delta = currentMousePos - lastMousePos;
         lastMousePos = currentMousePos; 
-        model.rotation.y += delta.x * sensitivity;
-        model.rotation.x += delta.y * sensitivity;
+        transform.rotation.y += delta.x * sensitivity;
+        transform.rotation.x += delta.y * sensitivity;
         
-        model.updateTransformMatrix();
+        transform.MarkDirty();
 
     } else if (isRotating) {
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
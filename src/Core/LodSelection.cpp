@@ -0,0 +1,36 @@
+#include "LodSelection.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Utils {
+    float lodPixelScale(const glm::mat4& projection, float screenHeight) {
+        return projection[1][1] * 0.5f * screenHeight;
+    }
+
+    float pixelsPerLocalUnit(const Bounds& bounds, const glm::mat4& worldMatrix, const glm::vec3& cameraPos, float pixelScale) {
+        glm::vec3 closest = glm::clamp(cameraPos, bounds.worldMin, bounds.worldMax);
+        float distance = glm::length(closest - cameraPos);
+        if (distance <= 0.0f) return std::numeric_limits<float>::infinity();
+
+        // Las medidas están en espacio local: se escala por el mayor factor de escala del modelo
+        float scale = std::max(glm::length(glm::vec3(worldMatrix[0])),
+                      std::max(glm::length(glm::vec3(worldMatrix[1])), glm::length(glm::vec3(worldMatrix[2]))));
+        return scale * pixelScale / distance;
+    }
+
+    int selectLod(const Model& mesh, const Bounds& bounds, const glm::mat4& worldMatrix,
+                  const glm::vec3& cameraPos, float pixelScale, float maxPixelError) {
+        if (mesh.lods.size() < 2) return 0;
+
+        float pixelsPerLocalUnit = Utils::pixelsPerLocalUnit(bounds, worldMatrix, cameraPos, pixelScale);
+        if (std::isinf(pixelsPerLocalUnit)) return 0; // Cámara dentro de la caja
+
+        int selected = 0;
+        for (int lod = 1; lod < static_cast<int>(mesh.lods.size()); ++lod) {
+            if (mesh.lods[lod].error * pixelsPerLocalUnit > maxPixelError) break;
+            selected = lod;
+        }
+        return selected;
+    }
+}
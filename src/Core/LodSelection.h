@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "../Scene/Scene.h"
+
+struct LodStats {
+    int fullTriangles = 0;  // Triángulos de los modelos visibles a resolución completa
+    int drawnTriangles = 0; // Triángulos realmente enviados con el LOD elegido
+};
+
+namespace Utils {
+    // Píxeles que ocupa una unidad de mundo a distancia 1: alto / (2 * tan(fov / 2))
+    float lodPixelScale(const glm::mat4& projection, float screenHeight);
+
+    // Píxeles que ocupa una unidad local del modelo en el punto de su AABB más cercano a la
+    // cámara; infinito si la cámara está dentro de la caja
+    float pixelsPerLocalUnit(const Bounds& bounds, const glm::mat4& worldMatrix, const glm::vec3& cameraPos, float pixelScale);
+
+    // Elige el nivel más simple cuyo error, proyectado desde el punto de la AABB más cercano
+    // a la cámara, no supera 'maxPixelError' píxeles
+    int selectLod(const Model& mesh, const Bounds& bounds, const glm::mat4& worldMatrix,
+                  const glm::vec3& cameraPos, float pixelScale, float maxPixelError);
+}
@@ -0,0 +1,332 @@
+#include "OcclusionCulling.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE 1
+#endif
+
+namespace {
+    const float NEAR_W = 0.1f;               // Plano cercano de la cámara: w menor queda recortado
+    const size_t TRIANGLES_PER_JOB = 4096;
+
+    glm::vec3 GetPosition(const Model& model, unsigned int index) {
+        const float* v = &model.vertices[static_cast<size_t>(index) * 8];
+        return glm::vec3(v[0], v[1], v[2]);
+    }
+}
+
+OcclusionCulling::OcclusionCulling() {
+    tilesX = BUFFER_WIDTH / TILE_SIZE;
+    tilesY = BUFFER_HEIGHT / TILE_SIZE;
+
+    glm::ivec2 size(BUFFER_WIDTH, BUFFER_HEIGHT);
+    while (true) {
+        levelSizes.push_back(size);
+        depthLevels.emplace_back(static_cast<size_t>(size.x) * size.y, 1.0f);
+        if (size.x == 1 && size.y == 1) break;
+        size = glm::max(size / 2, glm::ivec2(1));
+    }
+}
+
+bool OcclusionCulling::ProjectBounds(const Bounds& bounds, const glm::mat4& viewProj, ScreenRect& rect) const {
+    // AABB de mundo ya cacheada: algo más holgada que la local rotada, pero sin matriz por modelo
+    glm::vec3 min = bounds.worldMin;
+    glm::vec3 max = bounds.worldMax;
+    const glm::mat4& MVP = viewProj;
+
+    glm::vec3 ndcMin(FLT_MAX);
+    glm::vec3 ndcMax(-FLT_MAX);
+
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z, 1.0f);
+        glm::vec4 clip = MVP * corner;
+        if (clip.w < NEAR_W) {
+            rect.crossesNear = true;
+            return false;
+        }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+
+    glm::vec2 bufferSize(BUFFER_WIDTH, BUFFER_HEIGHT);
+    rect.min = (glm::vec2(ndcMin) * 0.5f + 0.5f) * bufferSize;
+    rect.max = (glm::vec2(ndcMax) * 0.5f + 0.5f) * bufferSize;
+    rect.minDepth = glm::clamp(ndcMin.z * 0.5f + 0.5f, 0.0f, 1.0f);
+    rect.crossesNear = false;
+    return true;
+}
+
+void OcclusionCulling::SetupTriangles(const Model& model, const glm::mat4& mvp, SetupJob& job) const {
+    job.triangles.clear();
+    job.bins.assign(tilesX * tilesY, {});
+
+    glm::vec2 bufferSize(BUFFER_WIDTH, BUFFER_HEIGHT);
+
+    for (size_t t = job.firstTriangle; t < job.lastTriangle; ++t) {
+        ScreenTriangle tri;
+        bool valid = true;
+
+        for (int k = 0; k < 3; ++k) {
+            glm::vec4 clip = mvp * glm::vec4(GetPosition(model, model.indices[t * 3 + k]), 1.0f);
+            // Los triángulos que cruzan el plano cercano se descartan: omitir un oclusor siempre es seguro
+            if (clip.w < NEAR_W) { valid = false; break; }
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            glm::vec2 screen = (glm::vec2(ndc) * 0.5f + 0.5f) * bufferSize;
+            tri.v[k] = glm::vec3(screen, glm::clamp(ndc.z * 0.5f + 0.5f, 0.0f, 1.0f));
+        }
+        if (!valid) continue;
+
+        // Caras traseras y degenerados (en pantalla con Y hacia arriba, CCW tiene área positiva)
+        float area = (tri.v[1].x - tri.v[0].x) * (tri.v[2].y - tri.v[0].y) - (tri.v[2].x - tri.v[0].x) * (tri.v[1].y - tri.v[0].y);
+        if (area <= 0.0f) continue;
+
+        float minX = std::min(tri.v[0].x, std::min(tri.v[1].x, tri.v[2].x));
+        float maxX = std::max(tri.v[0].x, std::max(tri.v[1].x, tri.v[2].x));
+        float minY = std::min(tri.v[0].y, std::min(tri.v[1].y, tri.v[2].y));
+        float maxY = std::max(tri.v[0].y, std::max(tri.v[1].y, tri.v[2].y));
+        if (maxX < 0.0f || maxY < 0.0f || minX >= BUFFER_WIDTH || minY >= BUFFER_HEIGHT) continue;
+
+        int tileMinX = static_cast<int>(std::max(minX, 0.0f)) / TILE_SIZE;
+        int tileMaxX = static_cast<int>(std::min(maxX, BUFFER_WIDTH - 1.0f)) / TILE_SIZE;
+        int tileMinY = static_cast<int>(std::max(minY, 0.0f)) / TILE_SIZE;
+        int tileMaxY = static_cast<int>(std::min(maxY, BUFFER_HEIGHT - 1.0f)) / TILE_SIZE;
+
+        uint32_t triIndex = static_cast<uint32_t>(job.triangles.size());
+        job.triangles.push_back(tri);
+        for (int ty = tileMinY; ty <= tileMaxY; ++ty) {
+            for (int tx = tileMinX; tx <= tileMaxX; ++tx) {
+                job.bins[ty * tilesX + tx].push_back(triIndex);
+            }
+        }
+    }
+}
+
+void OcclusionCulling::RasterizeTile(int tile) {
+    float* depth = depthLevels[0].data();
+    int tileX0 = (tile % tilesX) * TILE_SIZE;
+    int tileY0 = (tile / tilesX) * TILE_SIZE;
+    int tileX1 = tileX0 + TILE_SIZE - 1;
+    int tileY1 = tileY0 + TILE_SIZE - 1;
+
+    for (const SetupJob& job : jobs) {
+        for (uint32_t triIndex : job.bins[tile]) {
+            const ScreenTriangle& tri = job.triangles[triIndex];
+            const glm::vec3& v0 = tri.v[0];
+            const glm::vec3& v1 = tri.v[1];
+            const glm::vec3& v2 = tri.v[2];
+
+            // Funciones de arista E(p) = A*x + B*y + C, positivas dentro del triángulo
+            float A01 = v0.y - v1.y, B01 = v1.x - v0.x, C01 = (v1.y - v0.y) * v0.x - (v1.x - v0.x) * v0.y;
+            float A12 = v1.y - v2.y, B12 = v2.x - v1.x, C12 = (v2.y - v1.y) * v1.x - (v2.x - v1.x) * v1.y;
+            float A20 = v2.y - v0.y, B20 = v0.x - v2.x, C20 = (v0.y - v2.y) * v2.x - (v0.x - v2.x) * v2.y;
+            float area = C01 + C12 + C20;
+            if (area <= 0.0f) continue;
+
+            // Plano de profundidad interpolado con baricéntricas
+            float invArea = 1.0f / area;
+            float dzdx = (v0.z * A12 + v1.z * A20 + v2.z * A01) * invArea;
+            float dzdy = (v0.z * B12 + v1.z * B20 + v2.z * B01) * invArea;
+            float z0 = (v0.z * C12 + v1.z * C20 + v2.z * C01) * invArea;
+
+            // Se recorta en flotante antes de convertir para no desbordar con vértices muy lejanos
+            int minX = static_cast<int>(std::floor(glm::clamp(std::min(v0.x, std::min(v1.x, v2.x)), (float)tileX0, (float)tileX1 + 1.0f)));
+            int maxX = static_cast<int>(std::ceil(glm::clamp(std::max(v0.x, std::max(v1.x, v2.x)), (float)tileX0 - 1.0f, (float)tileX1)));
+            int minY = static_cast<int>(std::floor(glm::clamp(std::min(v0.y, std::min(v1.y, v2.y)), (float)tileY0, (float)tileY1 + 1.0f)));
+            int maxY = static_cast<int>(std::ceil(glm::clamp(std::max(v0.y, std::max(v1.y, v2.y)), (float)tileY0 - 1.0f, (float)tileY1)));
+            if (minX > maxX || minY > maxY) continue;
+            minX &= ~3; // Grupos de 4 píxeles alineados dentro del tile
+
+#ifdef OCCLUSION_USE_SSE
+            const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 a01 = _mm_set1_ps(A01), a12 = _mm_set1_ps(A12), a20 = _mm_set1_ps(A20);
+            const __m128 dzdxV = _mm_set1_ps(dzdx);
+
+            for (int y = minY; y <= maxY; ++y) {
+                float py = y + 0.5f;
+                __m128 row01 = _mm_set1_ps(B01 * py + C01);
+                __m128 row12 = _mm_set1_ps(B12 * py + C12);
+                __m128 row20 = _mm_set1_ps(B20 * py + C20);
+                __m128 rowZ = _mm_set1_ps(dzdy * py + z0);
+                float* row = depth + y * BUFFER_WIDTH;
+
+                for (int x = minX; x <= maxX; x += 4) {
+                    __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pixelOffsets);
+                    __m128 e01 = _mm_add_ps(_mm_mul_ps(a01, px), row01);
+                    __m128 e12 = _mm_add_ps(_mm_mul_ps(a12, px), row12);
+                    __m128 e20 = _mm_add_ps(_mm_mul_ps(a20, px), row20);
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e01, zero), _mm_cmpge_ps(e12, zero)), _mm_cmpge_ps(e20, zero));
+                    if (_mm_movemask_ps(inside) == 0) continue;
+
+                    __m128 z = _mm_add_ps(_mm_mul_ps(dzdxV, px), rowZ);
+                    __m128 old = _mm_loadu_ps(row + x);
+                    __m128 nearest = _mm_min_ps(old, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+                }
+            }
+#else
+            for (int y = minY; y <= maxY; ++y) {
+                float py = y + 0.5f;
+                float* row = depth + y * BUFFER_WIDTH;
+                for (int x = minX; x <= maxX; ++x) {
+                    float px = x + 0.5f;
+                    if (A01 * px + B01 * py + C01 < 0.0f) continue;
+                    if (A12 * px + B12 * py + C12 < 0.0f) continue;
+                    if (A20 * px + B20 * py + C20 < 0.0f) continue;
+                    float z = dzdx * px + dzdy * py + z0;
+                    if (z < row[x]) row[x] = z;
+                }
+            }
+#endif
+        }
+    }
+}
+
+void OcclusionCulling::BuildHierarchy() {
+    for (size_t level = 1; level < depthLevels.size(); ++level) {
+        const std::vector<float>& src = depthLevels[level - 1];
+        std::vector<float>& dst = depthLevels[level];
+        glm::ivec2 srcSize = levelSizes[level - 1];
+        glm::ivec2 dstSize = levelSizes[level];
+
+        // Cada texel guarda la profundidad más lejana de su bloque 2x2
+        for (int y = 0; y < dstSize.y; ++y) {
+            int sy0 = std::min(y * 2, srcSize.y - 1);
+            int sy1 = std::min(y * 2 + 1, srcSize.y - 1);
+            for (int x = 0; x < dstSize.x; ++x) {
+                int sx0 = std::min(x * 2, srcSize.x - 1);
+                int sx1 = std::min(x * 2 + 1, srcSize.x - 1);
+                float a = std::max(src[sy0 * srcSize.x + sx0], src[sy0 * srcSize.x + sx1]);
+                float b = std::max(src[sy1 * srcSize.x + sx0], src[sy1 * srcSize.x + sx1]);
+                dst[y * dstSize.x + x] = std::max(a, b);
+            }
+        }
+    }
+}
+
+bool OcclusionCulling::IsOccluded(const ScreenRect& rect) const {
+    if (rect.crossesNear) return false;
+    if (rect.max.x < 0.0f || rect.max.y < 0.0f || rect.min.x >= BUFFER_WIDTH || rect.min.y >= BUFFER_HEIGHT) return false;
+
+    int x0 = glm::clamp(static_cast<int>(std::floor(rect.min.x)), 0, BUFFER_WIDTH - 1);
+    int x1 = glm::clamp(static_cast<int>(std::floor(rect.max.x)), 0, BUFFER_WIDTH - 1);
+    int y0 = glm::clamp(static_cast<int>(std::floor(rect.min.y)), 0, BUFFER_HEIGHT - 1);
+    int y1 = glm::clamp(static_cast<int>(std::floor(rect.max.y)), 0, BUFFER_HEIGHT - 1);
+
+    // Nivel de la pirámide donde el rectángulo ocupa como mucho 4x4 texels
+    size_t level = 0;
+    while (level + 1 < depthLevels.size() && ((x1 >> level) - (x0 >> level) >= 4 || (y1 >> level) - (y0 >> level) >= 4)) {
+        ++level;
+    }
+
+    const std::vector<float>& depth = depthLevels[level];
+    int width = levelSizes[level].x;
+    float maxDepth = 0.0f;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+            maxDepth = std::max(maxDepth, depth[y * width + x]);
+        }
+    }
+    return rect.minDepth > maxDepth;
+}
+
+void OcclusionCulling::Cull(const Scene& scene, std::vector<int>& visibleIndices, const glm::mat4& viewProj) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    ThreadPool& pool = ThreadPool::Get();
+    stats = OcclusionStats();
+
+    std::fill(depthLevels[0].begin(), depthLevels[0].end(), 1.0f);
+
+    // 1. Proyectar las AABB de todos los candidatos
+    std::vector<ScreenRect> rects(visibleIndices.size());
+    std::vector<char> projected(visibleIndices.size(), 0);
+    pool.ParallelFor(visibleIndices.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int index = visibleIndices[i];
+            if (!scene.IsLight(index)) projected[i] = ProjectBounds(scene.bounds[index], viewProj, rects[i]) ? 1 : 0;
+        }
+    });
+
+    // 2. Elegir oclusores: los que más pantalla cubren, dentro del presupuesto de triángulos
+    std::vector<size_t> occluderCandidates;
+    float minArea = minOccluderArea * BUFFER_WIDTH * BUFFER_HEIGHT;
+    auto clippedArea = [&](const ScreenRect& r) {
+        glm::vec2 lo = glm::max(r.min, glm::vec2(0.0f));
+        glm::vec2 hi = glm::min(r.max, glm::vec2(BUFFER_WIDTH, BUFFER_HEIGHT));
+        return std::max(0.0f, hi.x - lo.x) * std::max(0.0f, hi.y - lo.y);
+    };
+    for (size_t i = 0; i < visibleIndices.size(); ++i) {
+        const Model& model = scene.meshes[visibleIndices[i]];
+        if (scene.IsLight(visibleIndices[i]) || model.indices.empty()) continue;
+        if (static_cast<int>(model.indices.size() / 3) > maxOccluderTriangles) continue;
+        // Un oclusor que atraviesa el plano cercano aún puede tapar: se rasterizan sus triángulos válidos
+        if (projected[i] && clippedArea(rects[i]) < minArea) continue;
+        occluderCandidates.push_back(i);
+    }
+    std::sort(occluderCandidates.begin(), occluderCandidates.end(), [&](size_t a, size_t b) {
+        float areaA = projected[a] ? clippedArea(rects[a]) : FLT_MAX;
+        float areaB = projected[b] ? clippedArea(rects[b]) : FLT_MAX;
+        return areaA > areaB;
+    });
+
+    jobs.clear();
+    for (size_t candidate : occluderCandidates) {
+        int modelIndex = visibleIndices[candidate];
+        int triangles = static_cast<int>(scene.meshes[modelIndex].indices.size() / 3);
+        if (stats.occluderTriangles + triangles > triangleBudget) continue;
+        stats.occluderTriangles += triangles;
+        stats.occluders++;
+
+        for (size_t first = 0; first < static_cast<size_t>(triangles); first += TRIANGLES_PER_JOB) {
+            SetupJob job;
+            job.modelIndex = modelIndex;
+            job.firstTriangle = first;
+            job.lastTriangle = std::min(static_cast<size_t>(triangles), first + TRIANGLES_PER_JOB);
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    // 3. Transformar y clasificar por tiles, 4. rasterizar cada tile en su hilo
+    if (!jobs.empty()) {
+        pool.ParallelFor(jobs.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                int modelIndex = jobs[j].modelIndex;
+                SetupTriangles(scene.meshes[modelIndex], viewProj * scene.transforms[modelIndex].worldMatrix, jobs[j]);
+            }
+        });
+        pool.ParallelFor(static_cast<size_t>(tilesX * tilesY), 1, [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; ++tile) RasterizeTile(static_cast<int>(tile));
+        });
+    }
+    BuildHierarchy();
+
+    // 5. Probar cada candidato contra el Hi-Z y compactar la lista conservando el orden
+    std::vector<char> occluded(visibleIndices.size(), 0);
+    if (!jobs.empty()) {
+        pool.ParallelFor(visibleIndices.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (projected[i]) occluded[i] = IsOccluded(rects[i]) ? 1 : 0;
+            }
+        });
+    }
+
+    size_t writeIndex = 0;
+    for (size_t i = 0; i < visibleIndices.size(); ++i) {
+        if (occluded[i]) {
+            stats.occluded++;
+        } else {
+            visibleIndices[writeIndex++] = visibleIndices[i];
+        }
+    }
+    visibleIndices.resize(writeIndex);
+    stats.drawn = static_cast<int>(writeIndex);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
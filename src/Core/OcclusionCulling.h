@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "../Scene/Scene.h"
+
+struct OcclusionStats {
+    int occluders = 0;
+    int occluderTriangles = 0;
+    int occluded = 0;
+    int drawn = 0;
+    double timeMs = 0.0;
+};
+
+// Culling por oclusión en CPU: los modelos que más pantalla ocupan (oclusores) se rasterizan
+// en un Z-buffer de baja resolución repartido en tiles entre los hilos del pool, y con él se
+// construye una pirámide de profundidades máximas (Hi-Z) contra la que se prueban las AABB.
+class OcclusionCulling {
+public:
+    static constexpr int BUFFER_WIDTH = 256;
+    static constexpr int BUFFER_HEIGHT = 128;
+    static constexpr int TILE_SIZE = 32;
+
+    int maxOccluderTriangles = 20000; // Modelos más densos no se rasterizan como oclusores
+    int triangleBudget = 150000;      // Triángulos de oclusores por frame
+    float minOccluderArea = 0.01f;    // Fracción de pantalla mínima para ser oclusor
+
+    OcclusionCulling();
+
+    // Elimina de 'visibleIndices' (ya filtrado por el frustum) los modelos totalmente tapados
+    void Cull(const Scene& scene, std::vector<int>& visibleIndices, const glm::mat4& viewProj);
+
+    const OcclusionStats& GetStats() const { return stats; }
+
+private:
+    struct ScreenRect {
+        glm::vec2 min = glm::vec2(0.0f);
+        glm::vec2 max = glm::vec2(0.0f);
+        float minDepth = 0.0f;
+        bool crossesNear = false;
+    };
+
+    struct ScreenTriangle {
+        glm::vec3 v[3]; // x, y en píxeles del buffer; z profundidad en [0, 1]
+    };
+
+    // Bloque de triángulos de un oclusor que un hilo transforma y clasifica por tiles
+    struct SetupJob {
+        int modelIndex = -1;
+        size_t firstTriangle = 0;
+        size_t lastTriangle = 0;
+        std::vector<ScreenTriangle> triangles;
+        std::vector<std::vector<uint32_t>> bins;
+    };
+
+    bool ProjectBounds(const Bounds& bounds, const glm::mat4& viewProj, ScreenRect& rect) const;
+    void SetupTriangles(const Model& model, const glm::mat4& mvp, SetupJob& job) const;
+    void RasterizeTile(int tile);
+    void BuildHierarchy();
+    bool IsOccluded(const ScreenRect& rect) const;
+
+    int tilesX, tilesY;
+    std::vector<std::vector<float>> depthLevels; // Nivel 0 a resolución completa
+    std::vector<glm::ivec2> levelSizes;
+    std::vector<SetupJob> jobs;
+    OcclusionStats stats;
+};
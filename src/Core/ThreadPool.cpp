@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool& ThreadPool::Get() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1; // El hilo principal también trabaja
+
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front().fn);
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+bool ThreadPool::RunPendingTask(const void* batch) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find_if(tasks.begin(), tasks.end(), [batch](const Task& t) { return t.batch == batch; });
+        if (it == tasks.end()) return false;
+        task = std::move(it->fn);
+        tasks.erase(it);
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& fn) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    size_t blockCount = (count + grain - 1) / grain;
+    if (blockCount == 1 || workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // El contador se protege con el mutex para que ningún bloque toque esta pila tras el retorno
+    size_t remaining = blockCount;
+    auto runBlock = [&](size_t block) {
+        size_t begin = block * grain;
+        size_t end = std::min(count, begin + grain);
+        fn(begin, end);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--remaining == 0) taskFinished.notify_all();
+    };
+
+    const void* batch = &remaining;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t block = 1; block < blockCount; ++block) {
+            Task task;
+            task.batch = batch;
+            task.fn = [&runBlock, block]() { runBlock(block); };
+            tasks.push_back(std::move(task));
+        }
+    }
+    taskAvailable.notify_all();
+
+    runBlock(0);
+
+    // Mientras quedan bloques, ayudar con la cola en lugar de dormir
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (remaining == 0) return;
+        }
+        if (RunPendingTask(batch)) continue;
+
+        // Los bloques que faltan ya están en manos de otros hilos
+        std::unique_lock<std::mutex> lock(mutex);
+        taskFinished.wait(lock, [&]() { return remaining == 0; });
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos persistente compartido por los sistemas que reparten trabajo por frame
+// (culling, rasterizado por software) y por los hilos de carga.
+class ThreadPool {
+public:
+    static ThreadPool& Get();
+
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetWorkerCount() const { return workers.size(); }
+
+    // Divide [0, count) en bloques de 'grain' elementos y los ejecuta en paralelo.
+    // El hilo que llama también procesa bloques de su propio lote (nunca los de otro, para que
+    // el hilo principal no quede atrapado en un trabajo largo de un hilo de carga), por lo que
+    // se puede anidar sin bloqueos.
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& fn);
+
+private:
+    ThreadPool();
+    void WorkerLoop();
+    bool RunPendingTask(const void* batch);
+
+    struct Task {
+        const void* batch = nullptr; // Identifica la llamada a ParallelFor que lo encoló
+        std::function<void()> fn;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable taskFinished;
+    bool stopping = false;
+};
@@ -0,0 +1,88 @@
+#include "VisibilityCache.h"
+#include "FrustumCulling.h"
+#include <chrono>
+
+char VisibilityCache::TestModel(const Scene& scene, int index, const glm::mat4& viewProj) const {
+    // Los grupos no tienen geometría que dibujar
+    if (scene.meshes[index].indices.empty()) return MODEL_OUTSIDE;
+    if (scene.IsLight(index)) return MODEL_VISIBLE;
+
+    const Bounds& b = scene.bounds[index];
+    if (!Utils::isAABBInFrustum(b, viewProj)) return MODEL_OUTSIDE;
+    if (minScreenSize > 0.0f &&
+        Utils::projectedScreenSize(b.worldMin, b.worldMax, viewProj, viewportSize) < minScreenSize) {
+        return MODEL_TOO_SMALL;
+    }
+    return MODEL_VISIBLE;
+}
+
+void VisibilityCache::CullSubtree(const Scene& scene, int node, const glm::mat4& viewProj) {
+    const Bounds& b = scene.bounds[node];
+    bool emptySubtree = b.subtreeMin.x > b.subtreeMax.x;
+    if (!scene.IsLight(node) && (emptySubtree || !Utils::isBoxInFrustum(b.subtreeMin, b.subtreeMax, viewProj))) {
+        stats.culledSubtrees++;
+        return; // modelState ya está a MODEL_OUTSIDE para todo el subárbol
+    }
+
+    modelState[node] = TestModel(scene, node, viewProj);
+    stats.retested++;
+    for (int child : scene.transforms[node].children) {
+        CullSubtree(scene, child, viewProj);
+    }
+}
+
+const std::vector<int>& VisibilityCache::Resolve(const Scene& scene, const std::vector<int>& changedModels,
+                                                 const glm::mat4& viewProj, unsigned long long cameraGeneration,
+                                                 const VisibilitySettings& settings) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    stats = VisibilityStats();
+    stats.dirty = static_cast<int>(changedModels.size());
+
+    // Añadir o quitar modelos desplaza los índices: se invalida todo
+    bool sceneChanged = !valid || scene.generation != lastSceneGeneration || modelState.size() != scene.Size();
+    bool cameraChanged = !valid || cameraGeneration != lastCameraGeneration;
+    bool occlusionEnabled = settings.occlusion != nullptr;
+    bool occlusionChanged = occlusionEnabled != lastOcclusionEnabled;
+    // El umbral de tamaño y el viewport afectan a cada modelo por separado: se prueba todo de nuevo
+    bool sizeChanged = settings.minScreenSize != minScreenSize ||
+                       (settings.minScreenSize > 0.0f && settings.viewportSize != viewportSize);
+    bool settingsChanged = occlusionChanged || sizeChanged;
+    minScreenSize = settings.minScreenSize;
+    viewportSize = settings.viewportSize;
+
+    if (!sceneChanged && !cameraChanged && !settingsChanged && changedModels.empty()) {
+        stats.reused = true;
+    } else {
+        // Con la cámara nueva hay que probar todo; si no, solo los modelos que se movieron
+        if (sceneChanged || cameraChanged || sizeChanged) {
+            modelState.assign(scene.Size(), MODEL_OUTSIDE);
+            for (size_t i = 0; i < scene.Size(); ++i) {
+                if (scene.transforms[i].parent == -1) CullSubtree(scene, static_cast<int>(i), viewProj);
+            }
+        } else {
+            for (int i : changedModels) {
+                modelState[i] = TestModel(scene, i, viewProj);
+            }
+            stats.retested = static_cast<int>(changedModels.size());
+        }
+
+        frustumVisible.clear();
+        for (size_t i = 0; i < scene.Size(); ++i) {
+            if (modelState[i] == MODEL_VISIBLE) frustumVisible.push_back(static_cast<int>(i));
+            else if (modelState[i] == MODEL_TOO_SMALL) stats.smallCulled++;
+        }
+
+        // La oclusión depende de todos los oclusores, así que se repite sobre la lista del frustum
+        visibleModels = frustumVisible;
+        if (settings.occlusion) settings.occlusion->Cull(scene, visibleModels, viewProj);
+    }
+
+    lastSceneGeneration = scene.generation;
+    lastCameraGeneration = cameraGeneration;
+    lastOcclusionEnabled = occlusionEnabled;
+    valid = true;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.timeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return visibleModels;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "../Scene/Scene.h"
+#include "OcclusionCulling.h"
+
+struct VisibilityStats {
+    bool reused = false; // Se reutilizó la lista del frame anterior sin volver a probar nada
+    int retested = 0;    // Modelos probados de nuevo contra el frustum
+    int culledSubtrees = 0; // Subárboles descartados enteros por su AABB acumulada
+    int dirty = 0;       // Modelos cuya transformación cambió este frame
+    int smallCulled = 0; // Modelos descartados por ocupar menos píxeles que el umbral
+    double timeMs = 0.0;
+};
+
+// Opciones de culling que, al cambiar, obligan a recalcular toda la visibilidad
+struct VisibilitySettings {
+    OcclusionCulling* occlusion = nullptr; // nullptr si el culling por oclusión está apagado
+    float minScreenSize = 0.0f;            // Píxeles; 0 desactiva el descarte por tamaño en pantalla
+    glm::vec2 viewportSize = glm::vec2(0.0f);
+};
+
+// Caché temporal de visibilidad. Guarda el resultado del culling y lo recalcula solo cuando
+// cambia la generación de la cámara o de la escena, o cuando se movió algún modelo; en ese
+// caso únicamente se vuelven a probar los modelos modificados. Los índices devueltos son
+// densos y solo valen hasta el siguiente cambio estructural de la escena.
+class VisibilityCache {
+public:
+    // Devuelve los índices visibles. 'changedModels' son los modelos cuya transformación se
+    // actualizó este frame.
+    const std::vector<int>& Resolve(const Scene& scene, const std::vector<int>& changedModels,
+                                    const glm::mat4& viewProj, unsigned long long cameraGeneration,
+                                    const VisibilitySettings& settings);
+
+    const VisibilityStats& GetStats() const { return stats; }
+
+private:
+    // Recorre el grafo desde 'node': si la AABB del subárbol queda fuera no se visitan sus hijos
+    void CullSubtree(const Scene& scene, int node, const glm::mat4& viewProj);
+    // Estado de un modelo: fuera del frustum, visible o dentro pero demasiado pequeño
+    enum ModelVisibility : char { MODEL_OUTSIDE = 0, MODEL_VISIBLE = 1, MODEL_TOO_SMALL = 2 };
+    char TestModel(const Scene& scene, int index, const glm::mat4& viewProj) const;
+
+    bool valid = false;
+    unsigned long long lastSceneGeneration = 0;
+    unsigned long long lastCameraGeneration = 0;
+    bool lastOcclusionEnabled = false;
+    float minScreenSize = 0.0f;
+    glm::vec2 viewportSize = glm::vec2(0.0f);
+
+    std::vector<char> modelState;
+    std::vector<int> frustumVisible;
+    std::vector<int> visibleModels;
+    VisibilityStats stats;
+};
@@ -0,0 +1,157 @@
+#include "DebugDraw.h"
+#include "DebugDrawShader.h"
+#include "Shader.h"
+#include "../Scene/Model.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+GLuint DebugDraw::lineProgram = 0;
+GLuint DebugDraw::normalsProgram = 0;
+GLuint DebugDraw::streamVAO = 0;
+GLuint DebugDraw::streamVBO = 0;
+GLuint DebugDraw::normalsVAO = 0;
+size_t DebugDraw::streamCapacity = 0;
+std::vector<DebugVertex> DebugDraw::lines;
+std::vector<DebugVertex> DebugDraw::points;
+std::vector<DebugDraw::NormalsBatch> DebugDraw::normals;
+
+// Aristas de la caja como pares de esquinas; el bit 0 de la esquina elige x, el 1 y y el 2 z
+static const int BOX_EDGES[24] = {
+    0, 1, 1, 5, 5, 4, 4, 0, // Base
+    2, 3, 3, 7, 7, 6, 6, 2, // Tope
+    0, 2, 1, 3, 5, 7, 4, 6, // Columnas
+};
+
+void DebugDraw::Init() {
+    Shader lineShader(debugVertexShaderSource, debugFragmentShaderSource);
+    Shader normalsShader(debugNormalsVertexShaderSource, debugFragmentShaderSource);
+    lineProgram = lineShader.ID;
+    normalsProgram = normalsShader.ID;
+
+    std::vector<DebugVertex> empty;
+    Utils::uploadVertices(empty, streamVAO, streamVBO, GL_STREAM_DRAW);
+    streamCapacity = 0;
+
+    // Los atributos de este VAO se apuntan al VBO de cada modelo en FlushNormals; los divisores
+    // son estado del VAO y no cambian
+    glGenVertexArrays(1, &normalsVAO);
+    glBindVertexArray(normalsVAO);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribDivisor(1, 1);
+    glBindVertexArray(0);
+}
+
+void DebugDraw::Shutdown() {
+    glDeleteProgram(lineProgram);
+    glDeleteProgram(normalsProgram);
+    glDeleteBuffers(1, &streamVBO);
+    glDeleteVertexArrays(1, &streamVAO);
+    glDeleteVertexArrays(1, &normalsVAO);
+    lineProgram = normalsProgram = streamVAO = streamVBO = normalsVAO = 0;
+    streamCapacity = 0;
+    lines.clear();
+    points.clear();
+    normals.clear();
+}
+
+DebugVertex DebugDraw::MakeVertex(const glm::vec3& position, const glm::vec3& color) {
+    glm::vec3 scaled = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    DebugVertex vertex;
+    vertex.position = position;
+    vertex.color[0] = static_cast<uint8_t>(scaled.r);
+    vertex.color[1] = static_cast<uint8_t>(scaled.g);
+    vertex.color[2] = static_cast<uint8_t>(scaled.b);
+    vertex.color[3] = 255;
+    return vertex;
+}
+
+void DebugDraw::Line(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color) {
+    lines.push_back(MakeVertex(from, color));
+    lines.push_back(MakeVertex(to, color));
+}
+
+void DebugDraw::Box(const glm::vec3& min, const glm::vec3& max, const glm::mat4& matrix, const glm::vec3& color) {
+    glm::vec3 corners[8];
+    for (int c = 0; c < 8; ++c) {
+        glm::vec3 local((c & 1) ? max.x : min.x, (c & 2) ? max.y : min.y, (c & 4) ? max.z : min.z);
+        corners[c] = glm::vec3(matrix * glm::vec4(local, 1.0f));
+    }
+    for (int edge : BOX_EDGES) lines.push_back(MakeVertex(corners[edge], color));
+}
+
+void DebugDraw::Point(const glm::vec3& position, const glm::vec3& color) {
+    points.push_back(MakeVertex(position, color));
+}
+
+void DebugDraw::Normals(const Model& model, const glm::mat4& worldMatrix, float length, const glm::vec3& color) {
+    if (model.VBO == 0 || model.vertices.empty()) return;
+    NormalsBatch batch;
+    batch.vbo = model.VBO;
+    batch.format = model.vertexFormat;
+    batch.decode = model.vertexDecode;
+    batch.vertexCount = static_cast<GLsizei>(model.vertices.size() / 8);
+    batch.worldMatrix = worldMatrix;
+    batch.length = length;
+    batch.color = color;
+    normals.push_back(batch);
+}
+
+GLsizei DebugDraw::Upload(const std::vector<DebugVertex>& vertices) {
+    glBindBuffer(GL_ARRAY_BUFFER, streamVBO);
+    // Buffer nuevo cada frame para no esperar a que la GPU termine con el anterior; solo crece
+    streamCapacity = std::max(streamCapacity, vertices.size());
+    glBufferData(GL_ARRAY_BUFFER, streamCapacity * sizeof(DebugVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(DebugVertex), vertices.data());
+    return static_cast<GLsizei>(vertices.size());
+}
+
+void DebugDraw::FlushNormals(const glm::mat4& viewProj) {
+    glUseProgram(normalsProgram);
+    glUniformMatrix4fv(glGetUniformLocation(normalsProgram, "viewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+    GLint modelLoc = glGetUniformLocation(normalsProgram, "model");
+    GLint lengthLoc = glGetUniformLocation(normalsProgram, "normalLength");
+    GLint colorLoc = glGetUniformLocation(normalsProgram, "normalsColor");
+
+    glBindVertexArray(normalsVAO);
+    for (const NormalsBatch& batch : normals) {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.vbo);
+        Utils::setupVertexAttributes(batch.format);
+        glDisableVertexAttribArray(2);
+        Utils::applyVertexDecode(normalsProgram, batch.decode);
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(batch.worldMatrix));
+        glUniform1f(lengthLoc, batch.length);
+        glUniform3fv(colorLoc, 1, glm::value_ptr(batch.color));
+        glDrawArraysInstanced(GL_LINES, 0, 2, batch.vertexCount);
+    }
+    glBindVertexArray(0);
+}
+
+void DebugDraw::Flush(const glm::mat4& view, const glm::mat4& projection) {
+    if (lines.empty() && points.empty() && normals.empty()) return;
+
+    GLint previousProgram;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glm::mat4 viewProj = projection * view;
+
+    if (!normals.empty()) FlushNormals(viewProj);
+
+    if (!lines.empty() || !points.empty()) {
+        // Líneas y puntos comparten buffer: los puntos van detrás de las líneas
+        GLsizei lineCount = static_cast<GLsizei>(lines.size());
+        lines.insert(lines.end(), points.begin(), points.end());
+
+        glUseProgram(lineProgram);
+        glUniformMatrix4fv(glGetUniformLocation(lineProgram, "viewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+        glUniform1f(glGetUniformLocation(lineProgram, "pointSize"), POINT_SIZE);
+        glBindVertexArray(streamVAO);
+        GLsizei total = Upload(lines);
+        if (lineCount > 0) glDrawArrays(GL_LINES, 0, lineCount);
+        if (total > lineCount) glDrawArrays(GL_POINTS, lineCount, total - lineCount);
+        glBindVertexArray(0);
+    }
+
+    lines.clear();
+    points.clear();
+    normals.clear();
+    glUseProgram(previousProgram);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "VertexFormat.h"
+#include "VertexLayout.h"
+
+class Model;
+
+// Dibujo de depuración en modo inmediato. Cualquier parte del código encola durante el frame
+// líneas, cajas y puntos en espacio mundo; Flush los sube a un único buffer de streaming y los
+// dibuja con una llamada para las líneas y otra para los puntos. Las normales no se guardan en
+// CPU: se generan en el vertex shader leyendo el VBO del propio modelo, una línea instanciada
+// por vértice. Solo se usa desde el hilo principal.
+class DebugDraw {
+public:
+    static constexpr float POINT_SIZE = 6.0f;
+
+    // Crea los programas y el buffer; requiere contexto de OpenGL
+    static void Init();
+    static void Shutdown();
+
+    static void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color);
+    // Caja [min, max] en espacio local llevada a mundo con 'matrix'
+    static void Box(const glm::vec3& min, const glm::vec3& max, const glm::mat4& matrix, const glm::vec3& color);
+    static void Point(const glm::vec3& position, const glm::vec3& color);
+    // Un segmento de 'length' unidades locales por vértice del modelo, en la dirección de su normal
+    static void Normals(const Model& model, const glm::mat4& worldMatrix, float length, const glm::vec3& color);
+
+    // Dibuja todo lo encolado en el frame y vacía las colas
+    static void Flush(const glm::mat4& view, const glm::mat4& projection);
+
+private:
+    // Se copia lo necesario del modelo: la escena puede reubicar sus modelos antes de Flush
+    struct NormalsBatch {
+        GLuint vbo = 0;
+        VertexFormat format = VertexFormat::Float;
+        VertexDecode decode;
+        GLsizei vertexCount = 0;
+        glm::mat4 worldMatrix = glm::mat4(1.0f);
+        float length = 0.0f;
+        glm::vec3 color = glm::vec3(1.0f);
+    };
+
+    static DebugVertex MakeVertex(const glm::vec3& position, const glm::vec3& color);
+    // Sube 'vertices' al buffer de streaming (orphaning) y devuelve cuántos hay
+    static GLsizei Upload(const std::vector<DebugVertex>& vertices);
+    static void FlushNormals(const glm::mat4& viewProj);
+
+    static GLuint lineProgram, normalsProgram;
+    static GLuint streamVAO, streamVBO;
+    static GLuint normalsVAO;
+    static size_t streamCapacity; // Vértices que caben en streamVBO
+    static std::vector<DebugVertex> lines;
+    static std::vector<DebugVertex> points;
+    static std::vector<NormalsBatch> normals;
+};
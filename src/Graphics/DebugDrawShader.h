@@ -0,0 +1,62 @@
+#pragma once
+
+// Líneas y puntos encolados: ya vienen en espacio mundo con su color
+const char* debugVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 3) in vec4 aColor;
+
+    out vec4 Color;
+
+    uniform mat4 viewProj;
+    uniform float pointSize;
+
+    void main() {
+        Color = aColor;
+        gl_Position = viewProj * vec4(aPos, 1.0);
+        gl_PointSize = pointSize;
+    }
+)";
+
+// Normales: una instancia por vértice del VBO del modelo (atributos con divisor 1) y dos
+// vértices por instancia, el origen (gl_VertexID 0) y el extremo (gl_VertexID 1)
+const char* debugNormalsVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 1) in vec3 aNormal;
+
+    out vec4 Color;
+
+    uniform mat4 model;
+    uniform mat4 viewProj;
+    uniform float normalLength;
+    uniform vec3 normalsColor;
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
+
+    vec3 octDecode(vec2 e) {
+        vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        float t = max(-n.z, 0.0);
+        n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+        return normalize(n);
+    }
+
+    void main() {
+        vec3 position = packedVertices ? positionOffset + aPos * positionScale : aPos;
+        vec3 normal = packedVertices ? octDecode(aNormal.xy) : aNormal;
+        position += normal * (normalLength * float(gl_VertexID));
+        Color = vec4(normalsColor, 1.0);
+        gl_Position = viewProj * model * vec4(position, 1.0);
+    }
+)";
+
+const char* debugFragmentShaderSource = R"(
+    #version 330 core
+    in vec4 Color;
+    out vec4 FragColor;
+
+    void main() {
+        FragColor = Color;
+    }
+)";
@@ -0,0 +1,105 @@
+#pragma once
+
+const char* debugViewVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+
+    out vec3 VertexWorldPos;
+
+    uniform mat4 model;
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
+
+    void main() {
+        vec3 position = packedVertices ? positionOffset + aPos * positionScale : aPos;
+        VertexWorldPos = vec3(model * vec4(position, 1.0));
+        gl_Position = projection * view * vec4(VertexWorldPos, 1.0);
+    }
+)";
+
+// Cada triángulo recibe su área en píxeles y su normal geométrica. Si algún vértice queda
+// detrás de la cámara el área proyectada no tiene sentido y se da por grande.
+const char* debugViewGeometryShaderSource = R"(
+    #version 330 core
+    layout (triangles) in;
+    layout (triangle_strip, max_vertices = 3) out;
+
+    in vec3 VertexWorldPos[];
+    out vec3 WorldPos;
+    flat out vec3 FaceNormal;
+    flat out float TriangleArea;
+
+    uniform vec2 viewportSize;
+
+    void main() {
+        vec2 screen[3];
+        bool behindCamera = false;
+        for (int i = 0; i < 3; ++i) {
+            vec4 clip = gl_in[i].gl_Position;
+            behindCamera = behindCamera || clip.w <= 0.0;
+            screen[i] = clip.xy / clip.w * 0.5 * viewportSize;
+        }
+        vec2 e1 = screen[1] - screen[0];
+        vec2 e2 = screen[2] - screen[0];
+        float area = behindCamera ? 1e6 : 0.5 * abs(e1.x * e2.y - e1.y * e2.x);
+
+        vec3 normal = cross(VertexWorldPos[1] - VertexWorldPos[0], VertexWorldPos[2] - VertexWorldPos[0]);
+        normal = dot(normal, normal) > 0.0 ? normalize(normal) : vec3(0.0);
+
+        for (int i = 0; i < 3; ++i) {
+            gl_Position = gl_in[i].gl_Position;
+            WorldPos = VertexWorldPos[i];
+            FaceNormal = normal;
+            TriangleArea = area;
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+)";
+
+// Los colores llegan de DebugViews para que la leyenda use exactamente los mismos
+const char* debugViewFragmentShaderSource = R"(
+    #version 330 core
+    in vec3 WorldPos;
+    flat in vec3 FaceNormal;
+    flat in float TriangleArea;
+    out vec4 FragColor;
+
+    uniform int debugView;          // DebugView
+    uniform vec3 viewPos;
+    uniform vec3 overdrawStep;      // Se suma con blending aditivo por cada fragmento
+    uniform vec3 densityColors[5];  // 1, 4, 16, 64 y 256 píxeles por triángulo
+    uniform vec3 lodColors[5];
+    uniform int lodLevel;
+    uniform int clusterModel;
+    uniform int clusterId;          // Meshlet, o -1 si el modelo se dibuja entero
+
+    vec3 hashColor(int model, int id) {
+        uint h = uint(id + 1) * 2654435761u ^ uint(model) * 2246822519u;
+        h ^= h >> 15;
+        h *= 2246822519u;
+        h ^= h >> 13;
+        return vec3(uvec3(h, h >> 8, h >> 16) & 255u) / 255.0 * 0.75 + 0.25;
+    }
+
+    void main() {
+        if (debugView == 0) {
+            FragColor = vec4(overdrawStep, 1.0);
+            return;
+        }
+        if (debugView == 1) {
+            float t = clamp(log2(max(TriangleArea, 1e-6)) * 0.5, 0.0, 4.0);
+            int band = min(int(t), 3);
+            FragColor = vec4(mix(densityColors[band], densityColors[band + 1], t - float(band)), 1.0);
+            return;
+        }
+
+        // Niveles y meshlets se sombrean un poco para que se lea la forma
+        vec3 color = debugView == 2 ? lodColors[clamp(lodLevel, 0, 4)] : hashColor(clusterModel, clusterId);
+        float facing = abs(dot(FaceNormal, normalize(viewPos - WorldPos)));
+        FragColor = vec4(color * (0.4 + 0.6 * facing), 1.0);
+    }
+)";
@@ -0,0 +1,204 @@
+#include "DebugViews.h"
+#include "DebugViewShader.h"
+#include "VertexFormat.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+namespace {
+    // Cada capa suma este color: el rojo satura a las 4 capas, el verde a las 8 y el azul a las 16
+    const glm::vec3 OVERDRAW_STEP(0.25f, 0.125f, 0.0625f);
+
+    const glm::vec3 DENSITY_COLORS[DebugViews::DENSITY_STOPS] = {
+        glm::vec3(1.0f, 0.1f, 0.1f),   // 1 px: un triángulo o más por píxel
+        glm::vec3(1.0f, 0.55f, 0.1f),
+        glm::vec3(1.0f, 0.95f, 0.2f),
+        glm::vec3(0.3f, 0.85f, 0.3f),
+        glm::vec3(0.2f, 0.45f, 1.0f),  // 256 px o más
+    };
+
+    const glm::vec3 LOD_COLORS[DebugViews::LOD_LEVELS] = {
+        glm::vec3(0.3f, 0.85f, 0.3f),
+        glm::vec3(0.95f, 0.9f, 0.25f),
+        glm::vec3(1.0f, 0.55f, 0.15f),
+        glm::vec3(0.95f, 0.25f, 0.25f),
+        glm::vec3(0.75f, 0.3f, 0.9f),
+    };
+    static_assert(DebugViews::LOD_LEVELS == 5, "lodColors del shader tiene 5 entradas");
+}
+
+glm::vec3 DebugViews::OverdrawColor(float layers) {
+    return glm::min(OVERDRAW_STEP * layers, glm::vec3(1.0f));
+}
+
+glm::vec3 DebugViews::DensityColor(int stop) {
+    return DENSITY_COLORS[std::clamp(stop, 0, DENSITY_STOPS - 1)];
+}
+
+glm::vec3 DebugViews::LodColor(int level) {
+    return LOD_COLORS[std::clamp(level, 0, LOD_LEVELS - 1)];
+}
+
+DebugViews::DebugViews()
+    : shader(debugViewVertexShaderSource, debugViewGeometryShaderSource, debugViewFragmentShaderSource) {
+}
+
+void DebugViews::Release() {
+    for (FrameQueries& frame : frames) {
+        if (!frame.shaded.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.shaded.size()), frame.shaded.data());
+            glDeleteQueries(static_cast<GLsizei>(frame.visible.size()), frame.visible.data());
+        }
+        frame = FrameQueries();
+    }
+    glDeleteProgram(shader.ID);
+}
+
+bool DebugViews::CollectResults(FrameQueries& frame) {
+    // Las consultas terminan en orden: si la última está lista, todas lo están
+    GLuint available = 0;
+    glGetQueryObjectuiv(frame.visible[frame.models.size() - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    stats.models.clear();
+    double totalShaded = 0.0;
+    double totalVisible = 0.0;
+    for (size_t k = 0; k < frame.models.size(); ++k) {
+        GLuint64 shaded = 0, visible = 0;
+        glGetQueryObjectui64v(frame.shaded[k], GL_QUERY_RESULT, &shaded);
+        glGetQueryObjectui64v(frame.visible[k], GL_QUERY_RESULT, &visible);
+        totalShaded += static_cast<double>(shaded);
+        totalVisible += static_cast<double>(visible);
+        if (visible == 0) continue;
+
+        ModelOverdraw entry;
+        entry.model = frame.models[k];
+        entry.overdraw = static_cast<float>(static_cast<double>(shaded) / visible);
+        entry.visibleSamples = static_cast<double>(visible);
+        stats.models.push_back(entry);
+    }
+    std::sort(stats.models.begin(), stats.models.end(), [](const ModelOverdraw& a, const ModelOverdraw& b) {
+        return a.overdraw > b.overdraw;
+    });
+    stats.overdraw = totalVisible > 0.0 ? static_cast<float>(totalShaded / totalVisible) : 0.0f;
+    frame.pending = false;
+    return true;
+}
+
+void DebugViews::Draw(DebugView view, const Scene& scene, const std::vector<int>& visibleModels,
+                      const std::vector<char>& drawAsImpostor, const glm::mat4& viewMatrix,
+                      const glm::mat4& projection, const glm::vec2& viewportSize) {
+    GLint previousProgram;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+    shader.use();
+    shader.setMat4("view", viewMatrix);
+    shader.setMat4("projection", projection);
+    shader.setVec3("viewPos", glm::vec3(glm::inverse(viewMatrix)[3]));
+    glUniform2fv(glGetUniformLocation(shader.ID, "viewportSize"), 1, glm::value_ptr(viewportSize));
+    shader.setInt("debugView", static_cast<int>(view));
+    shader.setVec3("overdrawStep", OVERDRAW_STEP);
+    glUniform3fv(glGetUniformLocation(shader.ID, "densityColors"), DENSITY_STOPS, glm::value_ptr(DENSITY_COLORS[0]));
+    glUniform3fv(glGetUniformLocation(shader.ID, "lodColors"), LOD_LEVELS, glm::value_ptr(LOD_COLORS[0]));
+
+    drawn.clear();
+    for (int i : visibleModels) {
+        if (!drawAsImpostor[i]) drawn.push_back(i);
+    }
+
+    // Solo el mapa de sobredibujado mide; si el hueco sigue en vuelo este frame no se mide
+    FrameQueries* frame = nullptr;
+    if (view == DebugView::Overdraw) {
+        frame = &frames[currentFrame];
+        currentFrame = (currentFrame + 1) % QUERY_FRAMES;
+        if (frame->pending && !CollectResults(*frame)) frame = nullptr;
+    }
+    if (frame && drawn.empty()) stats = DebugViewStats();
+    if (frame) {
+        frame->models.clear();
+        while (frame->shaded.size() < drawn.size()) {
+            GLuint queries[2];
+            glGenQueries(2, queries);
+            frame->shaded.push_back(queries[0]);
+            frame->visible.push_back(queries[1]);
+        }
+    }
+
+    if (view == DebugView::Overdraw) glBlendFunc(GL_ONE, GL_ONE);
+    for (size_t k = 0; k < drawn.size(); ++k) {
+        int i = drawn[k];
+        if (frame) glBeginQuery(GL_SAMPLES_PASSED, frame->shaded[k]);
+        DrawModel(view, scene.meshes[i], i, scene.transforms[i].worldMatrix);
+        if (frame) {
+            glEndQuery(GL_SAMPLES_PASSED);
+            frame->models.push_back(scene.HandleOf(i));
+        }
+    }
+    if (view == DebugView::Overdraw) glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Con la profundidad final, las muestras que cada modelo deja visibles
+    if (frame && !drawn.empty()) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_EQUAL);
+        for (size_t k = 0; k < drawn.size(); ++k) {
+            int i = drawn[k];
+            glBeginQuery(GL_SAMPLES_PASSED, frame->visible[k]);
+            DrawModel(view, scene.meshes[i], i, scene.transforms[i].worldMatrix);
+            glEndQuery(GL_SAMPLES_PASSED);
+        }
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        frame->pending = true;
+    }
+
+    glUseProgram(previousProgram);
+}
+
+void DebugViews::DrawModel(DebugView view, const Model& mesh, int index, const glm::mat4& worldMatrix) {
+    shader.setInt("lodLevel", mesh.activeLod);
+    shader.setInt("clusterModel", index);
+    if (view == DebugView::Meshlets && mesh.activeLod == 0 && !mesh.meshlets.empty() && !mesh.materialRanges.empty()) {
+        DrawMeshlets(mesh, worldMatrix);
+        return;
+    }
+    shader.setInt("clusterId", -1);
+    mesh.draw(shader.ID, worldMatrix);
+}
+
+void DebugViews::DrawMeshlets(const Model& mesh, const glm::mat4& worldMatrix) {
+    shader.setMat4("model", worldMatrix);
+    Utils::applyVertexDecode(shader.ID, mesh.vertexDecode);
+    GLint clusterLoc = glGetUniformLocation(shader.ID, "clusterId");
+    const std::vector<Meshlet>& meshlets = mesh.meshlets;
+    int meshletCount = static_cast<int>(meshlets.size());
+
+    glBindVertexArray(mesh.VAO);
+    for (const MaterialBatch& batch : mesh.batches) {
+        for (size_t r = 0; r < batch.counts.size(); ++r) {
+            size_t first = reinterpret_cast<size_t>(batch.offsets[r]) / mesh.indexSize();
+            size_t end = first + batch.counts[r];
+
+            // Los meshlets están ordenados por firstIndex: buscar el que contiene 'first'
+            auto next = std::upper_bound(meshlets.begin(), meshlets.end(), first, [](size_t index, const Meshlet& meshlet) {
+                return index < meshlet.firstIndex;
+            });
+            int m = static_cast<int>(next - meshlets.begin()) - 1;
+            while (first < end) {
+                size_t segmentEnd = end;
+                int id = -1;
+                if (m >= 0 && first < meshlets[m].firstIndex + meshlets[m].indexCount) {
+                    segmentEnd = std::min<size_t>(end, meshlets[m].firstIndex + meshlets[m].indexCount);
+                    id = m;
+                } else if (m + 1 < meshletCount) {
+                    segmentEnd = std::min<size_t>(end, meshlets[m + 1].firstIndex);
+                }
+                glUniform1i(clusterLoc, id);
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(segmentEnd - first), mesh.indexType, mesh.indexOffset(first));
+                first = segmentEnd;
+                ++m;
+            }
+        }
+    }
+    glBindVertexArray(0);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Shader.h"
+#include "../Scene/Scene.h"
+#include "../Scene/MeshSimplifier.h"
+
+// Vistas de depuración; van en el combo de modos de render a partir de FIRST_RENDER_MODE
+enum class DebugView {
+    Overdraw = 0,        // Mapa de calor aditivo: cada fragmento sombreado suma
+    TriangleDensity = 1, // Píxeles por triángulo
+    LodLevel = 2,        // Nivel de detalle elegido
+    Meshlets = 3,        // Un color por meshlet
+};
+
+struct ModelOverdraw {
+    ModelHandle model;
+    float overdraw = 0.0f; // Fragmentos sombreados por muestra visible
+    double visibleSamples = 0.0;
+};
+
+struct DebugViewStats {
+    float overdraw = 0.0f;             // Media de la escena
+    std::vector<ModelOverdraw> models; // De mayor a menor sobredibujado
+};
+
+// Dibuja la capa base con un programa propio (solo posición, más un geometry shader que da a
+// cada triángulo su área en pantalla) para ver dónde se va el tiempo de GPU. En el mapa de
+// sobredibujado además se mide cada modelo: una consulta GL_SAMPLES_PASSED cuenta sus
+// fragmentos sombreados y, con la profundidad ya completa, una segunda pasada con GL_EQUAL y
+// sin color cuenta los que quedan visibles. Los resultados se leen unos frames después.
+class DebugViews {
+public:
+    static constexpr int FIRST_RENDER_MODE = 7;
+    static constexpr int VIEW_COUNT = 4;
+    static constexpr int QUERY_FRAMES = 3;
+    static constexpr int DENSITY_STOPS = 5;   // 1, 4, 16, 64 y 256 píxeles por triángulo
+    static constexpr int OVERDRAW_STOPS = 5;  // 1, 2, 4, 8 y 16 capas
+    static constexpr int LOD_LEVELS = MeshSimplifier::MAX_LODS;
+
+    static bool IsDebugMode(int renderMode) {
+        return renderMode >= FIRST_RENDER_MODE && renderMode < FIRST_RENDER_MODE + VIEW_COUNT;
+    }
+    static DebugView FromRenderMode(int renderMode) { return static_cast<DebugView>(renderMode - FIRST_RENDER_MODE); }
+
+    // Colores que usa el shader, para la leyenda
+    static glm::vec3 OverdrawColor(float layers);
+    static float OverdrawStopLayers(int stop) { return static_cast<float>(1 << stop); }
+    static glm::vec3 DensityColor(int stop);
+    static float DensityStopPixels(int stop) { return static_cast<float>(1 << (2 * stop)); }
+    static glm::vec3 LodColor(int level);
+
+    DebugViews();
+    // Libera los recursos de GPU; debe llamarse antes de destruir el contexto
+    void Release();
+
+    // Dibuja los modelos visibles que no van como impostor. Usa el estado de profundidad y
+    // culling vigente y restaura el programa activo y el blending.
+    void Draw(DebugView view, const Scene& scene, const std::vector<int>& visibleModels,
+              const std::vector<char>& drawAsImpostor, const glm::mat4& viewMatrix,
+              const glm::mat4& projection, const glm::vec2& viewportSize);
+
+    // Solo se actualiza en el mapa de sobredibujado
+    const DebugViewStats& GetStats() const { return stats; }
+
+private:
+    struct FrameQueries {
+        std::vector<GLuint> shaded;  // Por modelo, en el orden de dibujo
+        std::vector<GLuint> visible;
+        std::vector<ModelHandle> models;
+        bool pending = false;
+    };
+
+    void DrawModel(DebugView view, const Model& mesh, int index, const glm::mat4& worldMatrix);
+    // Dibuja los lotes del frame tramo a tramo, con el índice del meshlet de cada tramo
+    void DrawMeshlets(const Model& mesh, const glm::mat4& worldMatrix);
+    // Lee las consultas del hueco que se va a reutilizar; false si la GPU aún no ha terminado
+    bool CollectResults(FrameQueries& frame);
+
+    Shader shader;
+    FrameQueries frames[QUERY_FRAMES];
+    int currentFrame = 0;
+    std::vector<int> drawn; // Modelos dibujados este frame, para repetir el orden
+    DebugViewStats stats;
+};
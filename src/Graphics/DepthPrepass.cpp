@@ -0,0 +1,89 @@
+#include "DepthPrepass.h"
+#include "DepthPrepassShader.h"
+#include <algorithm>
+
+DepthPrepass::DepthPrepass()
+    : shader(depthPrepassVertexShaderSource, depthPrepassFragmentShaderSource) {
+    for (FrameQueries& frame : frames) {
+        glGenQueries(1, &frame.depth);
+        glGenQueries(1, &frame.shading);
+    }
+    // Con MSAA la consulta cuenta muestras; sin MSAA activo cada fragmento cubre todas
+    glGetIntegerv(GL_SAMPLES, &samplesPerPixel);
+    samplesPerPixel = std::max(samplesPerPixel, 1);
+}
+
+void DepthPrepass::Release() {
+    for (FrameQueries& frame : frames) {
+        glDeleteQueries(1, &frame.depth);
+        glDeleteQueries(1, &frame.shading);
+        frame = FrameQueries();
+    }
+    glDeleteProgram(shader.ID);
+}
+
+bool DepthPrepass::CollectResults(FrameQueries& frame) {
+    // La consulta de la pasada base es la última del frame: si está lista, la otra también
+    GLuint available = 0;
+    glGetQueryObjectuiv(frame.shading, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    GLuint64 shaded = 0;
+    glGetQueryObjectui64v(frame.shading, GL_QUERY_RESULT, &shaded);
+    GLuint64 drawn = shaded;
+    if (frame.withPrepass) glGetQueryObjectui64v(frame.depth, GL_QUERY_RESULT, &drawn);
+    stats.overdraw = static_cast<float>(drawn / frame.samples);
+    stats.shaded = static_cast<float>(shaded / frame.samples);
+    frame.pending = false;
+    return true;
+}
+
+bool DepthPrepass::Begin(DepthPrepassMode mode, float threshold, bool allowed, const Scene& scene,
+                         const std::vector<int>& visibleModels, const std::vector<char>& drawAsImpostor,
+                         const glm::mat4& view, const glm::mat4& projection, int pixelCount) {
+    FrameQueries& frame = frames[currentFrame];
+    currentFrame = (currentFrame + 1) % QUERY_FRAMES;
+    measuring = !frame.pending || CollectResults(frame);
+
+    // Histéresis para no alternar cada frame cerca del umbral
+    bool worthIt = stats.overdraw > (stats.active ? threshold * DISABLE_RATIO : threshold);
+    stats.active = allowed && (mode == DepthPrepassMode::Always || (mode == DepthPrepassMode::Auto && worthIt));
+    if (measuring) {
+        frame.pending = true;
+        frame.withPrepass = stats.active;
+        frame.samples = static_cast<double>(std::max(pixelCount, 1)) * samplesPerPixel;
+    }
+
+    if (stats.active) {
+        GLint previousProgram;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+        shader.use();
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        if (measuring) glBeginQuery(GL_SAMPLES_PASSED, frame.depth);
+        for (int i : visibleModels) {
+            if (drawAsImpostor[i]) continue;
+            scene.meshes[i].draw(shader.ID, scene.transforms[i].worldMatrix);
+        }
+        if (measuring) glEndQuery(GL_SAMPLES_PASSED);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+        glUseProgram(previousProgram);
+    }
+
+    if (measuring) glBeginQuery(GL_SAMPLES_PASSED, frame.shading);
+    return stats.active;
+}
+
+void DepthPrepass::End() {
+    if (measuring) glEndQuery(GL_SAMPLES_PASSED);
+    measuring = false;
+    if (stats.active) {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Shader.h"
+#include "../Scene/Scene.h"
+
+enum class DepthPrepassMode {
+    Off = 0,
+    Auto = 1,   // Según la sobrecarga medida
+    Always = 2,
+};
+
+struct DepthPrepassStats {
+    bool active = false;
+    float overdraw = 0.0f; // Fragmentos que sombrearía la pasada base por muestra de pantalla
+    float shaded = 0.0f;   // Los que sombreó de verdad; con la pre-pasada, solo los visibles
+};
+
+// Pre-pasada de profundidad: antes de la pasada base se dibujan los modelos visibles solo con
+// su posición y sin color, y la pasada base compara con GL_EQUAL sin escribir profundidad, así
+// que cada muestra se sombrea una vez. Compensa cuando los modelos se tapan mucho entre sí y el
+// modo de render es caro. Cada frame una consulta GL_SAMPLES_PASSED cuenta los fragmentos de la
+// pasada con GL_LESS (la pre-pasada o, sin ella, la base); el resultado se lee unos frames
+// después para no esperar a la GPU y en modo automático decide si usarla.
+class DepthPrepass {
+public:
+    static constexpr int QUERY_FRAMES = 3;     // Consultas en vuelo
+    static constexpr float DISABLE_RATIO = 0.8f; // Se apaga por debajo de umbral * DISABLE_RATIO
+
+    DepthPrepass();
+    // Libera los recursos de GPU; debe llamarse antes de destruir el contexto
+    void Release();
+
+    // Abre la pasada base. Si toca pre-pasada dibuja la profundidad de los modelos visibles
+    // que no van como impostor y deja GL_EQUAL sin escritura de profundidad. 'allowed' es
+    // false si la pasada base no es opaca. Restaura el programa activo.
+    bool Begin(DepthPrepassMode mode, float threshold, bool allowed, const Scene& scene,
+               const std::vector<int>& visibleModels, const std::vector<char>& drawAsImpostor,
+               const glm::mat4& view, const glm::mat4& projection, int pixelCount);
+    // Cierra la pasada base y restaura GL_LESS
+    void End();
+
+    const DepthPrepassStats& GetStats() const { return stats; }
+
+private:
+    struct FrameQueries {
+        GLuint depth = 0;   // Pre-pasada
+        GLuint shading = 0; // Pasada base
+        bool pending = false;
+        bool withPrepass = false;
+        double samples = 0.0; // Muestras de pantalla del frame
+    };
+
+    // Lee las consultas del hueco que se va a reutilizar; false si la GPU aún no ha terminado
+    bool CollectResults(FrameQueries& frame);
+
+    Shader shader;
+    FrameQueries frames[QUERY_FRAMES];
+    int currentFrame = 0;
+    bool measuring = false; // Hay una consulta abierta sobre la pasada base
+    GLint samplesPerPixel = 1;
+    DepthPrepassStats stats;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+// Solo posición. La transformación repite paso a paso la de vertexShaderSource y ambas declaran
+// gl_Position invariante: la pasada de sombreado compara con GL_EQUAL y necesita la misma
+// profundidad al bit.
+const char* depthPrepassVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+
+    uniform mat4 model;
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
+
+    invariant gl_Position;
+
+    void main() {
+        vec3 position = packedVertices ? positionOffset + aPos * positionScale : aPos;
+        vec3 worldPos = vec3(model * vec4(position, 1.0));
+        gl_Position = projection * view * vec4(worldPos, 1.0);
+    }
+)";
+
+// Sin salidas: con la máscara de color cerrada solo se escribe la profundidad
+const char* depthPrepassFragmentShaderSource = R"(
+    #version 330 core
+
+    void main() {
+    }
+)";
@@ -1,70 +1,37 @@
 #include "Grid.h"
+#include "GridShader.h"
 
-Grid::Grid(float size, int divisions, int subDivisions) {
-    std::vector<float> vertices;
-    float halfSize = size / 2.0f;
-    float step = size / divisions;
-    float subStep = step / subDivisions;
-
-    // Divisiones principales
-    for (int i = 0; i <= divisions; ++i) {
-        float coord = -halfSize + i * step;
-        vertices.push_back(coord); vertices.push_back(-0.5f); vertices.push_back(-halfSize);
-        vertices.push_back(coord); vertices.push_back(-0.5f); vertices.push_back(halfSize);
-        vertices.push_back(-halfSize); vertices.push_back(-0.5f); vertices.push_back(coord);
-        vertices.push_back(halfSize); vertices.push_back(-0.5f); vertices.push_back(coord);
-    }
-
-    // Subdivisiones
-    for (int i = 0; i < divisions; ++i) {
-        for (int j = 1; j < subDivisions; ++j) {
-            float coord = -halfSize + i * step + j * subStep;
-            vertices.push_back(coord); vertices.push_back(-0.5f); vertices.push_back(-halfSize);
-            vertices.push_back(coord); vertices.push_back(-0.5f); vertices.push_back(halfSize);
-            vertices.push_back(-halfSize); vertices.push_back(-0.5f); vertices.push_back(coord);
-            vertices.push_back(halfSize); vertices.push_back(-0.5f); vertices.push_back(coord);
-        }
-    }
-
+Grid::Grid(float height, float minorStep, int subDivisions, float fadeDistance)
+    : shader(gridVertexShaderSource, gridFragmentShaderSource),
+      height(height), minorStep(minorStep), subDivisions(subDivisions), fadeDistance(fadeDistance) {
     glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
 }
 
-void Grid::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& color) {
-    glUseProgram(shaderProgram);
-
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-    GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint colorLoc = glGetUniformLocation(shaderProgram, "gridColor");
-    GLuint isGridLoc = glGetUniformLocation(shaderProgram, "isGrid");
-
-    if (viewLoc != -1) glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    if (projLoc != -1) glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    if (modelLoc != -1) glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
-    if (colorLoc != -1) glUniform3fv(colorLoc, 1, glm::value_ptr(color));
-    
-    // Activar modo Grid en el shader
-    if (isGridLoc != -1) glUniform1i(isGridLoc, 1);
+void Grid::release() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteProgram(shader.ID);
+    VAO = 0;
+}
 
+void Grid::draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& color) {
+    GLint previousProgram;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+    glm::mat4 viewProj = projection * view;
+    shader.use();
+    shader.setMat4("viewProj", viewProj);
+    shader.setMat4("inverseViewProj", glm::inverse(viewProj));
+    shader.setVec3("viewPos", glm::vec3(glm::inverse(view)[3]));
+    shader.setVec3("gridColor", color);
+    shader.setFloat("gridHeight", height);
+    shader.setFloat("minorStep", minorStep);
+    shader.setFloat("subDivisions", static_cast<float>(subDivisions));
+    shader.setFloat("fadeDistance", fadeDistance);
+
+    // Un único triángulo, sea cual sea la extensión visible
     glBindVertexArray(VAO);
-    
-    // Dibujar principales (gruesas)
-    glLineWidth(2.5f); 
-    glDrawArrays(GL_LINES, 0, 84); 
-    
-    // Dibujar secundarias (finas)
-    glLineWidth(0.5f); 
-    glDrawArrays(GL_LINES, 84, 320); 
-    
+    glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
-    
-    // Desactivar modo Grid
-    if (isGridLoc != -1) glUniform1i(isGridLoc, 0);
-}
\ No newline at end of file
+
+    glUseProgram(previousProgram);
+}
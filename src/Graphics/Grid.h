@@ -3,12 +3,26 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <vector>
+#include "Shader.h"
 
+// Rejilla infinita del suelo. No tiene geometría: un triángulo que cubre la pantalla corta el
+// rayo de cada píxel con el plano y las líneas se calculan en el fragment shader, con
+// antialiasing, desvanecimiento con la distancia y subdivisiones que se adaptan al zoom.
 class Grid {
 public:
-    GLuint VAO, VBO;
-    
-    Grid(float size, int divisions, int subDivisions);
-    void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& color);
-};
\ No newline at end of file
+    // Líneas menores cada 'minorStep' y una mayor cada 'subDivisions' menores, en el plano
+    // y = 'height'; se desvanece hasta desaparecer a 'fadeDistance' de la cámara
+    Grid(float height, float minorStep, int subDivisions, float fadeDistance);
+    // Libera los recursos de GPU; debe llamarse antes de destruir el contexto
+    void release();
+
+    void draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& color);
+
+private:
+    Shader shader;
+    GLuint VAO = 0; // Vacío: el core profile exige uno enlazado para dibujar
+    float height;
+    float minorStep;
+    int subDivisions;
+    float fadeDistance;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Triángulo que cubre la pantalla; cada píxel recibe los puntos del rayo de cámara en los
+// planos cercano y lejano, que varían linealmente en pantalla
+const char* gridVertexShaderSource = R"(
+    #version 330 core
+    out vec3 NearPoint;
+    out vec3 FarPoint;
+
+    uniform mat4 inverseViewProj;
+
+    vec3 unproject(vec2 ndc, float depth) {
+        vec4 world = inverseViewProj * vec4(ndc, depth, 1.0);
+        return world.xyz / world.w;
+    }
+
+    void main() {
+        vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+        NearPoint = unproject(ndc, -1.0);
+        FarPoint = unproject(ndc, 1.0);
+        gl_Position = vec4(ndc, 0.0, 1.0);
+    }
+)";
+
+// Corta el rayo con el plano y = gridHeight y dibuja las líneas con antialiasing analítico.
+// Tres niveles de celda (minorStep * subDivisions^k) según los píxeles que ocupa la celda
+// menor: la más fina se desvanece al alejarse y la siguiente pasa de línea mayor a menor,
+// así que al cambiar de nivel nada salta.
+const char* gridFragmentShaderSource = R"(
+    #version 330 core
+    in vec3 NearPoint;
+    in vec3 FarPoint;
+    out vec4 FragColor;
+
+    uniform mat4 viewProj;
+    uniform vec3 viewPos;
+    uniform vec3 gridColor;
+    uniform float gridHeight;
+    uniform float minorStep;
+    uniform float subDivisions;
+    uniform float fadeDistance;
+
+    const float MIN_CELL_PIXELS = 8.0; // Por debajo la celda menor pasa al nivel siguiente
+    const float MINOR_ALPHA = 0.5;
+
+    // Cobertura de las líneas de lado 'cellSize' y 'width' píxeles de grosor
+    float gridLines(vec2 coord, float cellSize, float width) {
+        vec2 cell = coord / cellSize;
+        vec2 lineDistance = abs(fract(cell - 0.5) - 0.5) / (fwidth(cell) * width);
+        return 1.0 - min(min(lineDistance.x, lineDistance.y), 1.0);
+    }
+
+    void main() {
+        vec3 ray = FarPoint - NearPoint;
+        float t = abs(ray.y) > 1e-6 ? (gridHeight - NearPoint.y) / ray.y : -1.0;
+        vec3 hit = NearPoint + ray * t;
+        vec2 coord = hit.xz;
+
+        // Derivadas antes de cualquier discard
+        float pixelSize = max(length(fwidth(coord)), 1e-6);
+        float level = max(0.0, log(pixelSize * MIN_CELL_PIXELS / minorStep) / log(subDivisions));
+        float blend = fract(level);
+        float step0 = minorStep * pow(subDivisions, floor(level));
+        float step1 = step0 * subDivisions;
+        float step2 = step1 * subDivisions;
+
+        float coverage = gridLines(coord, step0, 1.0) * MINOR_ALPHA * (1.0 - blend);
+        coverage = max(coverage, gridLines(coord, step1, mix(2.0, 1.0, blend)) * mix(1.0, MINOR_ALPHA, blend));
+        coverage = max(coverage, gridLines(coord, step2, 2.0));
+
+        float distanceToCamera = length(hit - viewPos);
+        coverage *= 1.0 - smoothstep(fadeDistance * 0.25, fadeDistance, distanceToCamera);
+        if (t <= 0.0 || t >= 1.0 || coverage < 0.01) discard;
+
+        vec4 clip = viewProj * vec4(hit, 1.0);
+        gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+        FragColor = vec4(gridColor, coverage);
+    }
+)";
@@ -0,0 +1,211 @@
+#include "Impostor.h"
+#include "ImpostorShader.h"
+#include "VertexLayout.h"
+#include "../Scene/MaterialLibrary.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <cmath>
+
+static const float PI = 3.14159265358979f;
+static const float ELEVATION_STEP = PI * 0.25f;
+
+static GLuint CreateAtlasTexture() {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ImpostorRenderer::ATLAS_SIZE, ImpostorRenderer::ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+ImpostorRenderer::ImpostorRenderer()
+    : bakeShader(impostorBakeVertexShaderSource, impostorBakeFragmentShaderSource),
+      drawShader(impostorVertexShaderSource, impostorFragmentShaderSource) {
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, ATLAS_SIZE, ATLAS_SIZE);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    std::vector<QuadVertex> corners = { { glm::vec2(-1.0f, -1.0f) }, { glm::vec2(1.0f, -1.0f) },
+                                        { glm::vec2(-1.0f, 1.0f) },  { glm::vec2(1.0f, 1.0f) } };
+    Utils::uploadVertices(corners, quadVAO, quadVBO);
+}
+
+void ImpostorRenderer::Release() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteProgram(bakeShader.ID);
+    glDeleteProgram(drawShader.ID);
+    fbo = depthBuffer = quadVAO = quadVBO = 0;
+}
+
+glm::vec3 ImpostorRenderer::CellDirection(int cell) {
+    float azimuth = (cell % AZIMUTHS) * (2.0f * PI / AZIMUTHS);
+    float elevation = (cell / AZIMUTHS) * ELEVATION_STEP;
+    return glm::vec3(std::sin(azimuth) * std::cos(elevation), std::sin(elevation), std::cos(azimuth) * std::cos(elevation));
+}
+
+int ImpostorRenderer::SelectCell(const glm::vec3& localViewDir) {
+    float azimuth = std::atan2(localViewDir.x, localViewDir.z);
+    int azimuthIndex = static_cast<int>(std::lround(azimuth / (2.0f * PI / AZIMUTHS)));
+    azimuthIndex = (azimuthIndex % AZIMUTHS + AZIMUTHS) % AZIMUTHS;
+
+    float elevation = std::asin(glm::clamp(localViewDir.y, -1.0f, 1.0f));
+    int elevationIndex = glm::clamp(static_cast<int>(std::lround(elevation / ELEVATION_STEP)), 0, ELEVATIONS - 1);
+    return elevationIndex * AZIMUTHS + azimuthIndex;
+}
+
+bool ImpostorRenderer::Capture(Model& mesh) {
+    if (mesh.indices.empty()) return false;
+
+    GLint previousFbo, viewport[4], program;
+    GLfloat clearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    GLboolean cull = glIsEnabled(GL_CULL_FACE);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+
+    mesh.releaseImpostor();
+    mesh.impostorAlbedo = CreateAtlasTexture();
+    mesh.impostorNormals = CreateAtlasTexture();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mesh.impostorAlbedo, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mesh.impostorNormals, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (complete) {
+        glDisable(GL_BLEND);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glViewport(0, 0, ATLAS_SIZE, ATLAS_SIZE);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        bakeShader.use();
+        bakeShader.setInt("textureArray", 0);
+        glActiveTexture(GL_TEXTURE0);
+
+        // Cámara ortográfica que encierra la esfera envolvente local desde cada dirección
+        glm::vec3 center = (mesh.localMinBounds + mesh.localMaxBounds) * 0.5f;
+        float radius = glm::max(glm::length(mesh.localMaxBounds - mesh.localMinBounds) * 0.5f, 1e-4f);
+        glm::mat4 projection = glm::ortho(-radius, radius, -radius, radius, radius * 0.5f, radius * 3.5f);
+
+        // Malla completa, sin LOD ni culling: se recorren directamente los rangos de material
+        // del nivel 0 y cada uno escribe su textura o su color difuso en el atlas de albedo
+        int cellSize = ATLAS_SIZE / GRID;
+        for (int cell = 0; cell < AZIMUTHS * ELEVATIONS; ++cell) {
+            glm::vec3 eye = center + CellDirection(cell) * radius * 2.0f;
+            glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+            bakeShader.setMat4("viewProj", projection * view);
+            glViewport((cell % GRID) * cellSize, (cell / GRID) * cellSize, cellSize, cellSize);
+
+            glBindVertexArray(mesh.VAO);
+            Utils::applyVertexDecode(bakeShader.ID, mesh.vertexDecode);
+            if (mesh.materialRanges.empty()) {
+                bakeShader.setInt("hasTexture", 0);
+                bakeShader.setVec3("objectColor", mesh.color);
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices.size()), mesh.indexType, 0);
+            }
+            for (const MaterialRange& range : mesh.materialRanges) {
+                const Material& material = MaterialLibrary::Get(mesh.materialIds[range.slot]);
+                bakeShader.setInt("hasTexture", material.texture.IsValid() ? 1 : 0);
+                bakeShader.setVec3("objectColor", material.diffuse);
+                if (material.texture.IsValid()) {
+                    glBindTexture(GL_TEXTURE_2D_ARRAY, TextureArrays::GetTexture(material.texture.page));
+                    bakeShader.setFloat("textureLayer", static_cast<float>(material.texture.layer));
+                    glUniform4fv(glGetUniformLocation(bakeShader.ID, "textureRect"), 1, glm::value_ptr(material.texture.rect));
+                }
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), mesh.indexType, mesh.indexOffset(range.firstIndex));
+            }
+            glBindVertexArray(0);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, mesh.impostorAlbedo);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, mesh.impostorNormals);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFbo);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    if (blend) glEnable(GL_BLEND);
+    if (cull) glEnable(GL_CULL_FACE);
+    if (!depthTest) glDisable(GL_DEPTH_TEST);
+    glUseProgram(program);
+
+    if (!complete) mesh.releaseImpostor();
+    return complete;
+}
+
+void ImpostorRenderer::Begin(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& lightPos,
+                             const glm::vec3& lightColor, int mode) {
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    renderMode = mode;
+
+    drawShader.use();
+    drawShader.setMat4("view", view);
+    drawShader.setMat4("projection", projection);
+    drawShader.setVec3("lightPos", lightPos);
+    drawShader.setVec3("lightColor", lightColor);
+    drawShader.setInt("albedoAtlas", 0);
+    drawShader.setInt("normalAtlas", 1);
+    drawShader.setFloat("cellScale", 1.0f / GRID);
+    drawShader.setInt("unlit", renderMode == 2 ? 1 : 0);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glBindVertexArray(quadVAO);
+}
+
+void ImpostorRenderer::Draw(const Model& mesh, const glm::mat4& worldMatrix, const glm::vec3& cameraPos) {
+    if (mesh.impostorAlbedo == 0) return;
+
+    glm::mat3 linear(worldMatrix);
+    glm::vec3 localCenter = (mesh.localMinBounds + mesh.localMaxBounds) * 0.5f;
+    float localRadius = glm::length(mesh.localMaxBounds - mesh.localMinBounds) * 0.5f;
+    float maxScale = glm::max(glm::length(linear[0]), glm::max(glm::length(linear[1]), glm::length(linear[2])));
+    glm::vec3 center = glm::vec3(worldMatrix * glm::vec4(localCenter, 1.0f));
+
+    // La vista se elige en espacio local para que el atlas gire con el modelo
+    glm::vec3 localViewDir = glm::inverse(linear) * (cameraPos - center);
+    float length = glm::length(localViewDir);
+    int cell = length > 0.0f ? SelectCell(localViewDir / length) : 0;
+
+    drawShader.setVec3("center", center);
+    drawShader.setFloat("radius", localRadius * maxScale);
+    glUniform2f(glGetUniformLocation(drawShader.ID, "cellOffset"),
+                static_cast<float>(cell % GRID) / GRID, static_cast<float>(cell / GRID) / GRID);
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+    glUniformMatrix3fv(glGetUniformLocation(drawShader.ID, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+    // El atlas ya lleva el color de cada material; solo se ignora si se ha cambiado el color del
+    // modelo o si el modo sólido debe ocultar las texturas
+    bool overridden = mesh.color != mesh.originalColor;
+    drawShader.setVec3("objectColor", mesh.color);
+    drawShader.setInt("useAlbedo", (!overridden && (renderMode != 0 || !mesh.hasTexture)) ? 1 : 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mesh.impostorAlbedo);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mesh.impostorNormals);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void ImpostorRenderer::End() {
+    glBindVertexArray(0);
+    glUseProgram(previousProgram);
+}
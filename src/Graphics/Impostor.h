@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "../Scene/Model.h"
+
+// Impostores de varios ángulos: cada modelo se renderiza una vez fuera de pantalla desde 16 vistas
+// (8 acimuts x 2 elevaciones) a un atlas de albedo + normales, y a partir de cierta distancia se
+// dibuja como un único quad orientado a la cámara con la vista más parecida. Guardar normales en
+// vez del color final permite seguir iluminándolo con la luz actual de la escena.
+class ImpostorRenderer {
+public:
+    static constexpr int ATLAS_SIZE = 1024;
+    static constexpr int GRID = 4;        // Celdas por lado del atlas
+    static constexpr int AZIMUTHS = 8;
+    static constexpr int ELEVATIONS = 2;  // 0º y 45º
+
+    ImpostorRenderer();
+    // Libera los recursos de GPU; debe llamarse antes de destruir el contexto
+    void Release();
+
+    // Captura el atlas del modelo (mesh.impostorAlbedo / impostorNormals). Restaura el framebuffer,
+    // el viewport y el estado que toca. Devuelve false si el framebuffer no es válido.
+    bool Capture(Model& mesh);
+
+    // Begin/End agrupan los impostores del frame para activar el programa y el quad una sola vez
+    void Begin(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& lightPos,
+               const glm::vec3& lightColor, int renderMode);
+    void Draw(const Model& mesh, const glm::mat4& worldMatrix, const glm::vec3& cameraPos);
+    void End();
+
+private:
+    // Celda del atlas que corresponde a una dirección de vista en espacio local
+    static int SelectCell(const glm::vec3& localViewDir);
+    static glm::vec3 CellDirection(int cell);
+
+    Shader bakeShader;
+    Shader drawShader;
+    GLuint fbo = 0, depthBuffer = 0;
+    GLuint quadVAO = 0, quadVBO = 0;
+    GLint previousProgram = 0;
+    int renderMode = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+// Captura: dibuja el modelo en espacio local y escribe el albedo y la normal en dos texturas
+const char* impostorBakeVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 1) in vec3 aNormal;
+    layout (location = 2) in vec2 aTexCoords;
+
+    out vec3 Normal;
+    out vec2 TexCoords;
+
+    uniform mat4 viewProj;
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
+
+    vec3 octDecode(vec2 e) {
+        vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        float t = max(-n.z, 0.0);
+        n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+        return normalize(n);
+    }
+
+    void main() {
+        Normal = packedVertices ? octDecode(aNormal.xy) : aNormal;
+        TexCoords = aTexCoords;
+        gl_Position = viewProj * vec4(packedVertices ? positionOffset + aPos * positionScale : aPos, 1.0);
+    }
+)";
+
+const char* impostorBakeFragmentShaderSource = R"(
+    #version 330 core
+    layout (location = 0) out vec4 Albedo;
+    layout (location = 1) out vec4 NormalOut;
+
+    in vec3 Normal;
+    in vec2 TexCoords;
+
+    uniform sampler2DArray textureArray;
+    uniform float textureLayer;
+    uniform vec4 textureRect;
+    uniform int hasTexture;
+    uniform vec3 objectColor; // Difuso del material que se está capturando
+
+    void main() {
+        vec2 uv = textureRect.xy + fract(TexCoords) * textureRect.zw;
+        vec4 texel = textureGrad(textureArray, vec3(uv, textureLayer), dFdx(TexCoords) * textureRect.zw, dFdy(TexCoords) * textureRect.zw);
+        Albedo = hasTexture == 1 ? vec4(texel.rgb, 1.0) : vec4(objectColor, 1.0);
+        NormalOut = vec4(normalize(Normal) * 0.5 + 0.5, 1.0);
+    }
+)";
+
+// Billboard: quad orientado a la cámara que muestrea la celda del atlas más cercana a la vista
+const char* impostorVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec2 aCorner;
+
+    out vec2 CellUV;
+    out vec3 FragPos;
+
+    uniform mat4 view;
+    uniform mat4 projection;
+    uniform vec3 center;
+    uniform float radius;
+
+    void main() {
+        vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+        vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+        FragPos = center + (right * aCorner.x + up * aCorner.y) * radius;
+        CellUV = aCorner * 0.5 + 0.5;
+        gl_Position = projection * view * vec4(FragPos, 1.0);
+    }
+)";
+
+const char* impostorFragmentShaderSource = R"(
+    #version 330 core
+    out vec4 FragColor;
+
+    in vec2 CellUV;
+    in vec3 FragPos;
+
+    uniform sampler2D albedoAtlas;
+    uniform sampler2D normalAtlas;
+    uniform vec2 cellOffset;
+    uniform float cellScale;
+    uniform mat3 normalMatrix;
+
+    uniform vec3 objectColor;
+    uniform vec3 lightColor;
+    uniform vec3 lightPos;
+    uniform int useAlbedo; // 0: color del modelo en lugar del albedo capturado
+    uniform int unlit;
+
+    void main() {
+        vec2 uv = cellOffset + CellUV * cellScale;
+        vec4 albedo = texture(albedoAtlas, uv);
+        if (albedo.a < 0.5) discard;
+
+        vec3 baseColor = useAlbedo == 1 ? albedo.rgb : objectColor;
+        if (unlit == 1) { FragColor = vec4(baseColor, 1.0); return; }
+
+        vec3 norm = normalize(normalMatrix * (texture(normalAtlas, uv).xyz * 2.0 - 1.0));
+        vec3 lightDir = normalize(lightPos - FragPos);
+        float diff = max(dot(norm, lightDir), 0.0);
+        FragColor = vec4((0.4 + diff) * lightColor * baseColor, 1.0);
+    }
+)";
@@ -0,0 +1,228 @@
+#include "LightClusters.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    const size_t LIGHT_GRAIN = 256;
+    const int TILES_PER_SLICE = LightClusters::TILES_X * LightClusters::TILES_Y;
+
+    int TileOf(float ndc, int tiles) {
+        return std::clamp(static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles)), 0, tiles - 1);
+    }
+
+    // Tiles que cubre un trozo de esfera de radio 'radius' alrededor de 'center' (espacio de
+    // vista) entre las profundidades 'minDepth' y 'maxDepth'. x / profundidad es monótona en la
+    // profundidad, así que los extremos de la proyección están en los planos del trozo.
+    bool TileRect(const glm::vec3& center, float radius, float minDepth, float maxDepth,
+                  const glm::vec2& projectionScale, glm::ivec4& rect) {
+        glm::vec2 low(center.x - radius, center.y - radius);
+        glm::vec2 high(center.x + radius, center.y + radius);
+        glm::vec2 ndcMin = glm::min(low / minDepth, low / maxDepth) * projectionScale;
+        glm::vec2 ndcMax = glm::max(high / minDepth, high / maxDepth) * projectionScale;
+        if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f) return false;
+
+        rect = glm::ivec4(TileOf(ndcMin.x, LightClusters::TILES_X), TileOf(ndcMin.y, LightClusters::TILES_Y),
+                          TileOf(ndcMax.x, LightClusters::TILES_X), TileOf(ndcMax.y, LightClusters::TILES_Y));
+        return true;
+    }
+}
+
+LightClusters::LightClusters() {
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+    clusters.assign(CLUSTER_COUNT, Cluster());
+    Upload();
+
+    const GLenum formats[3] = { GL_RG32UI, GL_R32UI, GL_RGBA32F };
+    for (int i = 0; i < 3; ++i) {
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::Release() {
+    glDeleteTextures(3, textures);
+    glDeleteBuffers(3, buffers);
+    std::fill(std::begin(textures), std::end(textures), 0u);
+    std::fill(std::begin(buffers), std::end(buffers), 0u);
+}
+
+int LightClusters::SliceOf(float depth) const {
+    return std::clamp(static_cast<int>(std::floor(std::log(depth) * sliceScale + sliceBias)), 0, SLICES - 1);
+}
+
+void LightClusters::Assign(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    stats = LightClusterStats();
+    stats.lights = static_cast<int>(lights.size());
+
+    // En glm::perspective: [2][2] = -(f + n) / (f - n) y [3][2] = -2fn / (f - n)
+    nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    sliceScale = SLICES / std::log(farPlane / nearPlane);
+    sliceBias = -std::log(nearPlane) * sliceScale;
+    glm::vec2 projectionScale(projection[0][0], projection[1][1]);
+
+    // Luces a espacio de vista. Las que quedan fuera del frustum no entran en ninguna rebanada
+    viewLights.resize(lights.size());
+    lightData.resize(lights.size() * 2);
+    ThreadPool::Get().ParallelFor(lights.size(), LIGHT_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const PointLight& light = lights[i];
+            ViewLight& viewLight = viewLights[i];
+            viewLight.center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            viewLight.radius = light.radius;
+            viewLight.firstSlice = 0;
+            viewLight.lastSlice = -1;
+            lightData[i * 2] = glm::vec4(light.position, light.radius);
+            lightData[i * 2 + 1] = glm::vec4(light.color, 0.0f);
+
+            float depth = -viewLight.center.z;
+            float minDepth = std::max(depth - light.radius, nearPlane);
+            float maxDepth = std::min(depth + light.radius, farPlane);
+            glm::ivec4 rect;
+            if (light.radius <= 0.0f || minDepth > maxDepth) continue;
+            if (!TileRect(viewLight.center, light.radius, minDepth, maxDepth, projectionScale, rect)) continue;
+            viewLight.firstSlice = SliceOf(minDepth);
+            viewLight.lastSlice = SliceOf(maxDepth);
+        }
+    });
+    for (const ViewLight& viewLight : viewLights) {
+        if (viewLight.lastSlice >= viewLight.firstSlice) stats.visibleLights++;
+    }
+
+    // Cada rebanada se llena por separado: sus celdas son solo suyas
+    slices.resize(SLICES);
+    clusters.resize(CLUSTER_COUNT);
+    ThreadPool::Get().ParallelFor(SLICES, 1, [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; ++slice) AssignSlice(static_cast<int>(slice), projectionScale);
+    });
+
+    // Juntar las listas de las rebanadas en una sola
+    size_t sliceBase[SLICES];
+    size_t total = 0;
+    for (int slice = 0; slice < SLICES; ++slice) {
+        sliceBase[slice] = total;
+        total += slices[slice].indices.size();
+        stats.litClusters += slices[slice].litClusters;
+        stats.maxPerCluster = std::max(stats.maxPerCluster, slices[slice].maxPerCluster);
+    }
+    lightIndices.resize(total);
+    ThreadPool::Get().ParallelFor(SLICES, 1, [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; ++slice) {
+            const std::vector<uint32_t>& indices = slices[slice].indices;
+            std::copy(indices.begin(), indices.end(), lightIndices.begin() + sliceBase[slice]);
+            Cluster* cells = &clusters[slice * TILES_PER_SLICE];
+            for (int c = 0; c < TILES_PER_SLICE; ++c) cells[c].offset += static_cast<uint32_t>(sliceBase[slice]);
+        }
+    });
+    stats.indices = static_cast<int>(total);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.assignMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+void LightClusters::AssignSlice(int slice, const glm::vec2& projectionScale) {
+    SliceResult& result = slices[slice];
+    result.lights.clear();
+    result.rects.clear();
+    result.litClusters = 0;
+    result.maxPerCluster = 0;
+
+    float sliceNear = std::exp((slice - sliceBias) / sliceScale);
+    float sliceFar = std::exp((slice + 1 - sliceBias) / sliceScale);
+
+    // Con cada luz se recorta su esfera a la rebanada: el corte más ancho está en la
+    // profundidad del centro, o en el plano de la rebanada más cercano a él
+    for (size_t i = 0; i < viewLights.size(); ++i) {
+        const ViewLight& light = viewLights[i];
+        if (slice < light.firstSlice || slice > light.lastSlice) continue;
+        float depth = -light.center.z;
+        float gap = std::max(0.0f, std::max(sliceNear - depth, depth - sliceFar));
+        if (gap >= light.radius) continue;
+        float sectionRadius = std::sqrt(light.radius * light.radius - gap * gap);
+        float minDepth = std::max(sliceNear, depth - light.radius);
+        float maxDepth = std::min(sliceFar, depth + light.radius);
+
+        glm::ivec4 rect;
+        if (!TileRect(light.center, sectionRadius, minDepth, maxDepth, projectionScale, rect)) continue;
+        result.lights.push_back(static_cast<uint32_t>(i));
+        result.rects.push_back(rect);
+    }
+
+    // Contar, reservar con un prefijo y rellenar. Los offsets son locales a la rebanada
+    Cluster* cells = &clusters[slice * TILES_PER_SLICE];
+    std::fill(cells, cells + TILES_PER_SLICE, Cluster());
+    for (const glm::ivec4& rect : result.rects) {
+        for (int y = rect.y; y <= rect.w; ++y) {
+            for (int x = rect.x; x <= rect.z; ++x) cells[y * TILES_X + x].count++;
+        }
+    }
+    uint32_t total = 0;
+    for (int c = 0; c < TILES_PER_SLICE; ++c) {
+        cells[c].offset = total;
+        total += cells[c].count;
+        if (cells[c].count > 0) result.litClusters++;
+        result.maxPerCluster = std::max(result.maxPerCluster, static_cast<int>(cells[c].count));
+        cells[c].count = 0;
+    }
+    result.indices.resize(total);
+    for (size_t l = 0; l < result.lights.size(); ++l) {
+        const glm::ivec4& rect = result.rects[l];
+        for (int y = rect.y; y <= rect.w; ++y) {
+            for (int x = rect.x; x <= rect.z; ++x) {
+                Cluster& cell = cells[y * TILES_X + x];
+                result.indices[cell.offset + cell.count++] = result.lights[l];
+            }
+        }
+    }
+}
+
+std::vector<PointLight> LightClusters::MakeTestGrid(int count, float radius) {
+    std::vector<PointLight> lights;
+    if (count <= 0) return lights;
+    lights.reserve(count);
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    float start = -0.5f * (side - 1) * radius;
+    for (int i = 0; i < count; ++i) {
+        PointLight light;
+        light.position = glm::vec3(start + (i % side) * radius, 0.0f, start + (i / side) * radius);
+        light.radius = radius;
+        // Tonos repartidos con la razón áurea para que las vecinas no se parezcan
+        float hue = std::fmod(i * 0.618034f, 1.0f) * 6.0f;
+        glm::vec3 rgb = glm::clamp(glm::vec3(std::abs(hue - 3.0f) - 1.0f, 2.0f - std::abs(hue - 2.0f), 2.0f - std::abs(hue - 4.0f)), 0.0f, 1.0f);
+        light.color = rgb;
+        lights.push_back(light);
+    }
+    return lights;
+}
+
+void LightClusters::Upload() {
+    // Nunca vacíos: un texture buffer sin memoria no es completo
+    auto upload = [](GLuint buffer, const void* data, size_t count, size_t elementSize) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, std::max<size_t>(count, 1) * elementSize, count > 0 ? data : nullptr, GL_STREAM_DRAW);
+    };
+    upload(buffers[0], clusters.data(), clusters.size(), sizeof(Cluster));
+    upload(buffers[1], lightIndices.data(), lightIndices.size(), sizeof(uint32_t));
+    upload(buffers[2], lightData.data(), lightData.size(), sizeof(glm::vec4));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::Bind(GLuint shaderProgram, const glm::vec2& viewportSize) const {
+    const char* samplers[3] = { "clusterCells", "clusterIndices", "clusterLights" };
+    for (int i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + FIRST_TEXTURE_UNIT + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glUniform1i(glGetUniformLocation(shaderProgram, samplers[i]), FIRST_TEXTURE_UNIT + i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform3i(glGetUniformLocation(shaderProgram, "clusterGrid"), TILES_X, TILES_Y, SLICES);
+    glUniform2f(glGetUniformLocation(shaderProgram, "clusterTileSize"), viewportSize.x / TILES_X, viewportSize.y / TILES_Y);
+    glUniform1f(glGetUniformLocation(shaderProgram, "clusterSliceScale"), sliceScale);
+    glUniform1f(glGetUniformLocation(shaderProgram, "clusterSliceBias"), sliceBias);
+}
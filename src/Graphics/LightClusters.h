@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Luz puntual con alcance: su aporte cae suavemente a cero en 'radius'
+struct PointLight {
+    glm::vec3 position = glm::vec3(0.0f);
+    float radius = 5.0f;
+    glm::vec3 color = glm::vec3(1.0f);
+};
+
+struct LightClusterStats {
+    int lights = 0;        // Luces recibidas
+    int visibleLights = 0; // Las que tocan alguna celda
+    int litClusters = 0;   // Celdas con al menos una luz
+    int maxPerCluster = 0;
+    int indices = 0;       // Entradas de la lista de luces por celda
+    double assignMs = 0.0; // Asignación en CPU
+};
+
+// Iluminación forward clustered: el frustum se divide en TILES_X x TILES_Y celdas de pantalla
+// y SLICES rebanadas de profundidad exponenciales (froxels). Cada frame la CPU asigna cada luz
+// a las celdas que toca su esfera, en paralelo por rebanada, y sube a texture buffers las
+// celdas (primer índice y número de luces), la lista de índices y los datos de las luces. El
+// fragment shader busca la celda de su píxel y solo recorre esas luces.
+class LightClusters {
+public:
+    static constexpr int TILES_X = 16;
+    static constexpr int TILES_Y = 9;
+    static constexpr int SLICES = 24;
+    static constexpr int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+    static constexpr int FIRST_TEXTURE_UNIT = 4; // Usa esta unidad y las dos siguientes
+
+    LightClusters();
+    // Libera los recursos de GPU; debe llamarse antes de destruir el contexto
+    void Release();
+
+    // Reparte las luces (en espacio mundo) en las celdas del frustum. Solo CPU; 'projection'
+    // debe ser una perspectiva simétrica, de la que se sacan los planos cercano y lejano.
+    void Assign(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection);
+    // Sube a la GPU el resultado del último Assign
+    void Upload();
+    // Enlaza los buffers y fija los uniforms de 'shaderProgram' (que debe estar activo)
+    void Bind(GLuint shaderProgram, const glm::vec2& viewportSize) const;
+
+    const LightClusterStats& GetStats() const { return stats; }
+
+    // Rejilla cuadrada de 'count' luces de colores sobre el suelo, separadas por 'radius'
+    // (cada punto queda dentro del alcance de unas tres), para pruebas de rendimiento
+    static std::vector<PointLight> MakeTestGrid(int count, float radius);
+
+private:
+    struct Cluster {
+        uint32_t offset = 0; // Primera entrada en 'lightIndices'
+        uint32_t count = 0;
+    };
+
+    // Luz en espacio de vista y rango de rebanadas que cubre su esfera
+    struct ViewLight {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+        int firstSlice = 0;
+        int lastSlice = -1;
+    };
+
+    // Lo que calcula cada rebanada por separado antes de juntarse en los arrays finales
+    struct SliceResult {
+        std::vector<uint32_t> lights;     // Luces que tocan la rebanada
+        std::vector<glm::ivec4> rects;    // Tiles que cubre cada una (x0, y0, x1, y1)
+        std::vector<uint32_t> indices;    // Lista de la rebanada, con offsets locales
+        int litClusters = 0;
+        int maxPerCluster = 0;
+    };
+
+    int SliceOf(float depth) const;
+    void AssignSlice(int slice, const glm::vec2& projectionScale);
+
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+    float sliceScale = 0.0f; // slice = log(depth) * sliceScale + sliceBias
+    float sliceBias = 0.0f;
+
+    std::vector<ViewLight> viewLights;
+    std::vector<SliceResult> slices;
+    std::vector<Cluster> clusters;
+    std::vector<uint32_t> lightIndices;
+    std::vector<glm::vec4> lightData; // Dos texels por luz: (posición, radio) y (color, 0)
+
+    GLuint buffers[3] = { 0, 0, 0 };  // Celdas, índices y luces
+    GLuint textures[3] = { 0, 0, 0 };
+    LightClusterStats stats;
+};
@@ -7,9 +7,13 @@ const char* pickingVertexShaderSource = R"(
     uniform mat4 model;
     uniform mat4 view;
     uniform mat4 projection;
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
 
     void main() {
-        gl_Position = projection * view * model * vec4(aPos, 1.0);
+        vec3 position = packedVertices ? positionOffset + aPos * positionScale : aPos;
+        gl_Position = projection * view * model * vec4(position, 1.0);
     }
 )";
 
@@ -0,0 +1,84 @@
+#include "RenderQueue.h"
+#include "../Scene/MaterialLibrary.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+void RenderQueue::Build(const Scene& scene, const std::vector<int>& visibleModels, const std::vector<char>& skip) {
+    items.clear();
+    for (int i : visibleModels) {
+        if (skip[i] || scene.IsLight(i)) continue;
+        const Model& mesh = scene.meshes[i];
+        if (mesh.materialRanges.empty()) continue;
+
+        for (size_t slot = 0; slot < mesh.batches.size(); ++slot) {
+            if (mesh.batches[slot].counts.empty()) continue;
+            DrawItem item;
+            item.material = mesh.materialIds[slot];
+            item.page = MaterialLibrary::Get(item.material).texture.page;
+            item.model = i;
+            item.slot = static_cast<int>(slot);
+            items.push_back(item);
+        }
+    }
+
+    // Por array de texturas, luego por material y dentro de él por modelo para no repetir la matriz
+    std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.page != b.page) return a.page < b.page;
+        if (a.material != b.material) return a.material < b.material;
+        if (a.model != b.model) return a.model < b.model;
+        return a.slot < b.slot;
+    });
+}
+
+void RenderQueue::Draw(GLuint shaderProgram, const Scene& scene) {
+    stats = RenderQueueStats();
+    stats.items = static_cast<int>(items.size());
+    if (items.empty()) return;
+
+    glUseProgram(shaderProgram);
+    GLint colorLoc = glGetUniformLocation(shaderProgram, "objectColor");
+    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
+    GLint hasTextureLoc = glGetUniformLocation(shaderProgram, "hasTexture");
+    GLint layerLoc = glGetUniformLocation(shaderProgram, "textureLayer");
+    GLint rectLoc = glGetUniformLocation(shaderProgram, "textureRect");
+    glUniform1i(glGetUniformLocation(shaderProgram, "textureArray"), 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    int boundPage = -2;
+    int boundMaterial = -1;
+    int boundModel = -1;
+    for (const DrawItem& item : items) {
+        const Material& material = MaterialLibrary::Get(item.material);
+        const Model& mesh = scene.meshes[item.model];
+
+        if (item.page != boundPage) {
+            if (item.page != -1) {
+                glBindTexture(GL_TEXTURE_2D_ARRAY, TextureArrays::GetTexture(item.page));
+                stats.textureBinds++;
+            }
+            glUniform1i(hasTextureLoc, item.page != -1 ? 1 : 0);
+            boundPage = item.page;
+        }
+        if (item.material != boundMaterial) {
+            if (material.texture.IsValid()) {
+                glUniform1f(layerLoc, static_cast<float>(material.texture.layer));
+                glUniform4fv(rectLoc, 1, glm::value_ptr(material.texture.rect));
+            }
+            boundMaterial = item.material;
+            boundModel = -1;
+            stats.materialBinds++;
+        }
+        if (item.model != boundModel) {
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(scene.transforms[item.model].worldMatrix));
+            Utils::applyVertexDecode(shaderProgram, mesh.vertexDecode);
+            boundModel = item.model;
+        }
+
+        // El color se fija por elemento porque un modelo puede sobrescribir el de sus materiales
+        glm::vec3 color = mesh.slotColor(material.diffuse);
+        glUniform3fv(colorLoc, 1, glm::value_ptr(color));
+        mesh.drawBatch(item.slot);
+        stats.drawCalls++;
+    }
+    glBindVertexArray(0);
+}
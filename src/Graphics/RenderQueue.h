@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include "../Scene/Scene.h"
+
+struct RenderQueueStats {
+    int items = 0;          // Pares (modelo, material) con algo que dibujar
+    int textureBinds = 0;   // Cambios de GL_TEXTURE_2D_ARRAY en la pasada base
+    int materialBinds = 0;  // Cambios de material (solo uniforms: color, capa y rectángulo)
+    int drawCalls = 0;      // glMultiDrawElements emitidos
+};
+
+// Cola de la pasada base ordenada por página de TextureArrays y después por material: cada
+// array de texturas se enlaza una sola vez por frame, cambiar de material dentro de él es
+// cambiar la capa y el rectángulo, y luego se dibujan los lotes de todos los modelos que lo usan.
+// Los lotes de cada modelo deben estar ya rellenos (cullClusters o collectBatches).
+class RenderQueue {
+public:
+    // 'skip[i]' != 0 excluye el modelo (impostores). Las luces y los modelos sin materiales
+    // quedan fuera y se dibujan aparte.
+    void Build(const Scene& scene, const std::vector<int>& visibleModels, const std::vector<char>& skip);
+    void Draw(GLuint shaderProgram, const Scene& scene);
+
+    const RenderQueueStats& GetStats() const { return stats; }
+
+private:
+    struct DrawItem {
+        int page = -1;    // Página de TextureArrays (-1 sin textura), primera clave de ordenación
+        int material = 0; // Id en MaterialLibrary
+        int model = 0;    // Índice denso en la escena
+        int slot = 0;     // Slot del material dentro del modelo
+    };
+
+    std::vector<DrawItem> items;
+    RenderQueueStats stats;
+};
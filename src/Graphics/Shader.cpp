@@ -1,14 +1,26 @@
 #include "Shader.h"
 
-Shader::Shader(const char* vertexSource, const char* fragmentSource) {
+Shader::Shader(const char* vertexSource, const char* fragmentSource)
+    : Shader(vertexSource, nullptr, fragmentSource) {
+}
+
+Shader::Shader(const char* vertexSource, const char* geometrySource, const char* fragmentSource) {
     // 1. Compilar Vertex Shader
-    unsigned int vertex, fragment;
+    unsigned int vertex, fragment, geometry = 0;
     
     vertex = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertex, 1, &vertexSource, NULL);
     glCompileShader(vertex);
     checkCompileErrors(vertex, "VERTEX");
 
+    // Geometry Shader (opcional)
+    if (geometrySource) {
+        geometry = glCreateShader(GL_GEOMETRY_SHADER);
+        glShaderSource(geometry, 1, &geometrySource, NULL);
+        glCompileShader(geometry);
+        checkCompileErrors(geometry, "GEOMETRY");
+    }
+
     // 2. Compilar Fragment Shader
     fragment = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragment, 1, &fragmentSource, NULL);
@@ -18,6 +30,7 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource) {
     // 3. Programa de Shaders
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
+    if (geometry) glAttachShader(ID, geometry);
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
@@ -25,6 +38,7 @@ Shader::Shader(const char* vertexSource, const char* fragmentSource) {
     // 4. Eliminar los shaders ya que están enlazados
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+    if (geometry) glDeleteShader(geometry);
 }
 
 void Shader::use() {
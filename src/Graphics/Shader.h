@@ -14,6 +14,8 @@ public:
 
     // Constructor que lee y construye el shader
     Shader(const char* vertexSource, const char* fragmentSource);
+    // Igual, con una etapa de geometría entre ambos (nullptr para omitirla)
+    Shader(const char* vertexSource, const char* geometrySource, const char* fragmentSource);
 
     // Activar el shader
     void use();
@@ -16,9 +16,26 @@ R"(
     uniform mat4 projection;
     uniform float pointSize;
 
+    // Vértices compactos (VertexFormat): posición normalizada en la AABB y normal octaédrica
+    uniform bool packedVertices;
+    uniform vec3 positionOffset;
+    uniform vec3 positionScale;
+
+    // La pre-pasada de profundidad (DepthPrepassShader.h) debe obtener la misma profundidad
+    invariant gl_Position;
+
+    vec3 octDecode(vec2 e) {
+        vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        float t = max(-n.z, 0.0);
+        n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+        return normalize(n);
+    }
+
     void main() {
-        FragPos = vec3(model * vec4(aPos, 1.0));
-        Normal = mat3(transpose(inverse(model))) * aNormal;
+        vec3 position = packedVertices ? positionOffset + aPos * positionScale : aPos;
+        vec3 normal = packedVertices ? octDecode(aNormal.xy) : aNormal;
+        FragPos = vec3(model * vec4(position, 1.0));
+        Normal = mat3(transpose(inverse(model))) * normal;
         TexCoords = aTexCoords;
         gl_Position = projection * view * vec4(FragPos, 1.0);    
         gl_PointSize = pointSize;
@@ -37,8 +54,6 @@ R"(
     uniform vec3 objectColor;
     uniform vec3 vertexColor;
     uniform vec3 wireframeColor;
-    uniform vec3 normalsColor;
-    uniform vec3 boundingBoxColor;
 
     uniform vec3 lightColor;
     uniform vec3 lightPos;
@@ -48,23 +63,56 @@ R"(
 
     uniform bool useVertexColor;
     uniform bool useWireframeColor; 
-    uniform bool useNormalsColor;
-    uniform bool useBoundingBoxColor;
-
-    uniform bool isGrid;
-    uniform vec3 gridColor;
 
-    uniform sampler2D texture1;
+    // Textura difusa: capa de un GL_TEXTURE_2D_ARRAY y rectángulo que ocupa en ella (atlas)
+    uniform sampler2DArray textureArray;
+    uniform float textureLayer;
+    uniform vec4 textureRect;
     uniform int hasTexture;
     
     uniform int renderMode;
     uniform float globalAlpha;
 
+    // Luces puntuales agrupadas por celdas del frustum (LightClusters)
+    uniform bool useClusteredLights;
+    uniform usamplerBuffer clusterCells;   // (primer índice, número de luces) por celda
+    uniform usamplerBuffer clusterIndices;
+    uniform samplerBuffer clusterLights;   // Dos texels por luz: (posición, radio) y (color, 0)
+    uniform ivec3 clusterGrid;
+    uniform vec2 clusterTileSize;          // Píxeles por celda
+    uniform float clusterSliceScale;       // Rebanada = log(profundidad) * escala + sesgo
+    uniform float clusterSliceBias;
+    uniform mat4 view;
+
+    // Difusa (y especular si specularStrength > 0) de las luces de la celda del fragmento
+    vec3 clusteredLighting(vec3 norm, vec3 viewDir, float specularStrength) {
+        if (!useClusteredLights) return vec3(0.0);
+        float depth = -(view * vec4(FragPos, 1.0)).z;
+        ivec3 cell = ivec3(ivec2(gl_FragCoord.xy / clusterTileSize), int(floor(log(max(depth, 1e-4)) * clusterSliceScale + clusterSliceBias)));
+        cell = clamp(cell, ivec3(0), clusterGrid - 1);
+        uvec2 range = texelFetch(clusterCells, (cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x).rg;
+
+        vec3 result = vec3(0.0);
+        for (uint i = 0u; i < range.y; ++i) {
+            int light = int(texelFetch(clusterIndices, int(range.x + i)).r);
+            vec4 positionRadius = texelFetch(clusterLights, light * 2);
+            vec3 toLight = positionRadius.xyz - FragPos;
+            float dist = length(toLight);
+            if (dist >= positionRadius.w) continue;
+
+            // Cuadrado inverso con una ventana que lo lleva a cero en el radio
+            float window = 1.0 - pow(dist / positionRadius.w, 4.0);
+            float attenuation = window * window / (1.0 + dist * dist);
+            vec3 lightDir = toLight / max(dist, 1e-4);
+            float diff = max(dot(norm, lightDir), 0.0);
+            float spec = specularStrength > 0.0 ? specularStrength * pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), 32.0) : 0.0;
+            result += (diff + spec) * attenuation * texelFetch(clusterLights, light * 2 + 1).rgb;
+        }
+        return result;
+    }
+
     void main() {
         if (isLightSource == 1) { FragColor = vec4(objectColor, 1.0); return; }
-        if (isGrid) { FragColor = vec4(gridColor, 1.0); return; }
-        if (useBoundingBoxColor) { FragColor = vec4(boundingBoxColor, 1.0); return; }
-        if (useNormalsColor) { FragColor = vec4(normalsColor, 1.0); return; }
       
         vec4 baseColor;
         
@@ -76,7 +124,10 @@ R"(
         }
 
         if (useTex) {
-            baseColor = texture(texture1, TexCoords);
+            // fract repite la textura dentro de su rectángulo; las derivadas se toman de las UV
+            // originales para que el salto de fract no dispare el nivel de mipmap en los bordes
+            vec2 uv = textureRect.xy + fract(TexCoords) * textureRect.zw;
+            baseColor = textureGrad(textureArray, vec3(uv, textureLayer), dFdx(TexCoords) * textureRect.zw, dFdy(TexCoords) * textureRect.zw);
         } else {
             vec3 currentColor = objectColor;
             if (useVertexColor) currentColor = vertexColor;
@@ -94,7 +145,7 @@ R"(
             float diff = max(dot(norm, lightDir), 0.0);
             vec3 diffuse = diff * lightColor;
 
-            vec3 lighting = (ambient + diffuse);
+            vec3 lighting = (ambient + diffuse + clusteredLighting(norm, vec3(0.0), 0.0));
             FragColor = vec4(lighting * baseColor.rgb, baseColor.a);
         }
         else if (renderMode == 2) {
@@ -115,7 +166,7 @@ R"(
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
             vec3 specular = specularStrength * spec * lightColor;
 
-            vec3 lighting = (ambient + diffuse + specular);
+            vec3 lighting = (ambient + diffuse + specular + clusteredLighting(norm, viewDir, specularStrength));
             FragColor = vec4(lighting * baseColor.rgb, baseColor.a);
         } else if (renderMode == 4) {
             float ambientStrength = 0.3; 
@@ -0,0 +1,431 @@
+#include "TextureArrays.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iostream>
+
+std::vector<TextureArrays::Page> TextureArrays::pages;
+std::vector<TextureArrays::Entry> TextureArrays::entries;
+std::vector<std::future<TextureArrays::LevelLoad>> TextureArrays::loads;
+uint64_t TextureArrays::frame = 1;
+int TextureArrays::streamedLevels = 0;
+int TextureArrays::evictedLevels = 0;
+
+int TextureArrays::CreatePage(const TextureImage& image, int width, int height, int capacity) {
+    int index = -1;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (pages[i].texture == 0) { index = static_cast<int>(i); break; }
+    }
+    if (index == -1) {
+        pages.push_back(Page());
+        index = static_cast<int>(pages.size()) - 1;
+    }
+
+    Page& page = pages[index];
+    unsigned int generation = page.generation + 1;
+    page = Page();
+    page.generation = generation;
+    page.format = image.format;
+    page.width = width;
+    page.height = height;
+    page.capacity = capacity;
+    page.levels = image.levelCount;
+    page.atlas = image.atlas;
+    page.layerUsers.assign(capacity, 0);
+    if (page.atlas) page.skylines.assign(capacity, std::vector<SkylineNode>(1, SkylineNode{ 0, 0, width }));
+    page.streamed = image.IsStreamed();
+    page.tailLevel = image.firstLevel;
+    page.residentLevel = image.firstLevel;
+    page.wantedLevel = image.firstLevel;
+
+    // Se reservan los niveles de la cola; los mipmaps vienen hechos y no hay glGenerateMipmap
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page.texture);
+    for (int level = page.residentLevel; level < page.levels; ++level) AllocateLevel(page, level);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, page.atlas ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, page.atlas ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, page.residentLevel);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, page.levels - 1);
+    if (page.format == GL_COMPRESSED_RG_RGTC2) {
+        // BC5 guarda gris en rojo y alfa en verde
+        GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+        glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+    return index;
+}
+
+size_t TextureArrays::LevelBytes(const Page& page, int level) {
+    return TextureCodec::LevelSize(page.format, std::max(1, page.width >> level), std::max(1, page.height >> level)) * page.capacity;
+}
+
+// Reserva un nivel para todas las capas; la textura debe estar enlazada
+void TextureArrays::AllocateLevel(Page& page, int level) {
+    int w = std::max(1, page.width >> level);
+    int h = std::max(1, page.height >> level);
+    size_t levelBytes = LevelBytes(page, level);
+    if (page.format != GL_RGBA8) {
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, page.format, w, h, page.capacity, 0, static_cast<GLsizei>(levelBytes), nullptr);
+    } else {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, w, h, page.capacity, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    page.bytes += levelBytes;
+}
+
+// Los huecos del atlas están alineados a ATLAS_ALIGN, así que cada nivel cae en bloques enteros
+void TextureArrays::UploadLevel(const Page& page, const Entry& entry, int level, const std::vector<unsigned char>& data) {
+    int w = std::max(1, entry.width >> level);
+    int h = std::max(1, entry.height >> level);
+    if (page.format != GL_RGBA8) {
+        glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, entry.pos.x >> level, entry.pos.y >> level, entry.ref.layer,
+                                  w, h, 1, page.format, static_cast<GLsizei>(data.size()), data.data());
+    } else {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, entry.pos.x >> level, entry.pos.y >> level, entry.ref.layer,
+                        w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+    }
+}
+
+bool TextureArrays::PlaceInAtlas(Page& page, int layer, int width, int height, glm::ivec2& outPos) {
+    std::vector<SkylineNode>& nodes = page.skylines[layer];
+
+    // Bottom-left: el hueco más bajo donde cabe y, a igualdad, el segmento más estrecho
+    size_t bestIndex = nodes.size();
+    int bestY = INT_MAX, bestWidth = INT_MAX;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        int x = nodes[i].x;
+        if (x + width > page.width) break;
+
+        int y = 0;
+        int remaining = width;
+        for (size_t j = i; remaining > 0; ++j) {
+            y = std::max(y, nodes[j].y);
+            remaining -= nodes[j].width;
+        }
+        if (y + height > page.height) continue;
+        if (y < bestY || (y == bestY && nodes[i].width < bestWidth)) {
+            bestIndex = i;
+            bestY = y;
+            bestWidth = nodes[i].width;
+        }
+    }
+    if (bestIndex == nodes.size()) return false;
+
+    int x = nodes[bestIndex].x;
+    nodes.insert(nodes.begin() + bestIndex, SkylineNode{ x, bestY + height, width });
+
+    // Recortar los segmentos que quedan debajo del nuevo
+    int end = x + width;
+    for (size_t i = bestIndex + 1; i < nodes.size();) {
+        if (nodes[i].x >= end) break;
+        int overlap = end - nodes[i].x;
+        if (nodes[i].width <= overlap) {
+            nodes.erase(nodes.begin() + i);
+        } else {
+            nodes[i].x += overlap;
+            nodes[i].width -= overlap;
+            break;
+        }
+    }
+    for (size_t i = 0; i + 1 < nodes.size();) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].width += nodes[i + 1].width;
+            nodes.erase(nodes.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    outPos = glm::ivec2(x, bestY);
+    return true;
+}
+
+TextureRef TextureArrays::Acquire(const std::string& path, std::shared_ptr<const TextureImage> image) {
+    for (Entry& entry : entries) {
+        if (entry.path == path) {
+            entry.users++;
+            return entry.ref;
+        }
+    }
+
+    if (!image) image = TextureCodec::Prepare(path);
+    if (!image) return TextureRef();
+
+    TextureRef ref;
+    glm::ivec2 pos(0);
+    if (image->atlas) {
+        for (size_t p = 0; p < pages.size() && !ref.IsValid(); ++p) {
+            const Page& page = pages[p];
+            if (!page.atlas || page.texture == 0 || page.format != image->format || page.streamed != image->IsStreamed()) continue;
+            for (int layer = 0; layer < pages[p].capacity; ++layer) {
+                if (PlaceInAtlas(pages[p], layer, image->width, image->height, pos)) {
+                    ref.page = static_cast<int>(p);
+                    ref.layer = layer;
+                    break;
+                }
+            }
+        }
+        if (!ref.IsValid()) {
+            ref.page = CreatePage(*image, ATLAS_SIZE, ATLAS_SIZE, ATLAS_LAYERS);
+            ref.layer = 0;
+            PlaceInAtlas(pages[ref.page], 0, image->width, image->height, pos);
+        }
+
+        float size = static_cast<float>(ATLAS_SIZE);
+        ref.rect = glm::vec4((pos.x + ATLAS_PADDING) / size, (pos.y + ATLAS_PADDING) / size,
+                             image->contentWidth / size, image->contentHeight / size);
+    } else {
+        for (size_t p = 0; p < pages.size() && !ref.IsValid(); ++p) {
+            const Page& page = pages[p];
+            if (page.atlas || page.texture == 0 || page.format != image->format || page.streamed != image->IsStreamed()) continue;
+            if (page.width != image->width || page.height != image->height) continue;
+            for (int layer = 0; layer < page.capacity; ++layer) {
+                if (page.layerUsers[layer] == 0) {
+                    ref.page = static_cast<int>(p);
+                    ref.layer = layer;
+                    break;
+                }
+            }
+        }
+        if (!ref.IsValid()) {
+            // La capacidad se calcula con la cadena completa, la que ocuparía sin streaming
+            size_t layerBytes = 0;
+            for (int level = 0; level < image->levelCount; ++level) {
+                layerBytes += TextureCodec::LevelSize(image->format, std::max(1, image->width >> level), std::max(1, image->height >> level));
+            }
+            int capacity = static_cast<int>(std::min<size_t>(MAX_LAYERS, std::max<size_t>(1, PAGE_BYTES / layerBytes)));
+            ref.page = CreatePage(*image, image->width, image->height, capacity);
+            ref.layer = 0;
+        }
+    }
+
+    Entry entry;
+    entry.path = path;
+    entry.ref = ref;
+    entry.users = 1;
+    entry.pos = pos;
+    entry.width = image->width;
+    entry.height = image->height;
+    entry.cachePath = image->cachePath;
+    entry.cacheKey = image->cacheKey;
+
+    // Si la página ya tiene niveles más finos que la cola, se leen ahora de la caché
+    Page& page = pages[ref.page];
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page.texture);
+    std::vector<unsigned char> streamed;
+    for (int level = page.residentLevel; level < page.levels; ++level) {
+        if (level >= image->firstLevel) {
+            UploadLevel(page, entry, level, image->levels[level - image->firstLevel]);
+        } else if (TextureCodec::ReadLevel(entry.cachePath, entry.cacheKey, level, streamed)) {
+            UploadLevel(page, entry, level, streamed);
+        } else {
+            std::cout << "No se pudo leer el nivel " << level << " de " << path << " desde la caché" << std::endl;
+        }
+    }
+
+    page.layerUsers[ref.layer]++;
+    entries.push_back(entry);
+
+    std::cout << "Textura cargada correctamente: " << path << " (página " << ref.page << ", capa " << ref.layer << ")" << std::endl;
+    return ref;
+}
+
+void TextureArrays::Release(const TextureRef& ref) {
+    if (!ref.IsValid()) return;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Entry& entry = entries[i];
+        if (entry.ref.page != ref.page || entry.ref.layer != ref.layer || entry.ref.rect != ref.rect) continue;
+        if (--entry.users > 0) return;
+
+        Page& page = pages[ref.page];
+        entries[i] = entries.back();
+        entries.pop_back();
+
+        // Un hueco del atlas no se reaprovecha hasta que toda su capa queda libre
+        if (--page.layerUsers[ref.layer] == 0 && page.atlas) {
+            page.skylines[ref.layer].assign(1, SkylineNode{ 0, 0, page.width });
+        }
+
+        bool empty = std::all_of(page.layerUsers.begin(), page.layerUsers.end(), [](int users) { return users == 0; });
+        if (empty) {
+            // La generación se conserva: las cargas en vuelo de esta página no deben
+            // confundirse con las de la que reutilice el hueco
+            glDeleteTextures(1, &page.texture);
+            unsigned int generation = page.generation;
+            page = Page();
+            page.generation = generation;
+        }
+        return;
+    }
+}
+
+void TextureArrays::Touch(const TextureRef& ref, float uvPerPixel) {
+    if (!ref.IsValid()) return;
+    Page& page = pages[ref.page];
+    if (!page.streamed) return;
+
+    // Texels de nivel 0 que caen en un píxel: cada potencia de dos por encima de 1 es un nivel
+    float texelsPerPixel = uvPerPixel * ref.rect.z * page.width;
+    int level = texelsPerPixel > 1.0f ? static_cast<int>(std::floor(std::log2(texelsPerPixel))) : 0;
+    level = std::min(level, page.tailLevel);
+    if (page.lastWanted != frame) {
+        page.lastWanted = frame;
+        page.wantedLevel = level;
+    } else {
+        page.wantedLevel = std::min(page.wantedLevel, level);
+    }
+}
+
+// Libera el nivel más fino de la página; devuelve los bytes liberados
+size_t TextureArrays::EvictLevel(Page& page) {
+    int level = page.residentLevel;
+    size_t levelBytes = LevelBytes(page, level);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page.texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, level + 1);
+    // Redefinir el nivel con tamaño cero es la forma de soltar su memoria en una textura mutable
+    if (page.format != GL_RGBA8) {
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, page.format, 0, 0, 0, 0, 0, nullptr);
+    } else {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, 0, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    page.residentLevel++;
+    page.bytes -= levelBytes;
+    evictedLevels++;
+    return levelBytes;
+}
+
+// Expulsa niveles, del menos usado recientemente al más, hasta que 'residentBytes' quepa en el
+// presupuesto. Nunca toca 'keepPage', las páginas leyéndose ni los niveles pedidos este frame.
+bool TextureArrays::EvictForBudget(size_t& residentBytes, size_t budgetBytes, int keepPage) {
+    while (residentBytes > budgetBytes) {
+        int victim = -1;
+        for (size_t p = 0; p < pages.size(); ++p) {
+            const Page& page = pages[p];
+            if (static_cast<int>(p) == keepPage || page.texture == 0 || !page.streamed || page.loading) continue;
+            if (page.residentLevel >= page.tailLevel) continue;
+            if (page.lastWanted == frame && page.wantedLevel <= page.residentLevel) continue;
+            if (victim == -1 || page.lastWanted < pages[victim].lastWanted) victim = static_cast<int>(p);
+        }
+        if (victim == -1) return false;
+        residentBytes -= EvictLevel(pages[victim]);
+    }
+    return true;
+}
+
+void TextureArrays::FinishLoad(LevelLoad& load) {
+    Page& page = pages[load.page];
+    if (page.texture == 0 || page.generation != load.generation) return;
+    page.loading = false;
+    if (load.level != page.residentLevel - 1) return;
+
+    // Las texturas que entraron en la página durante la lectura se leen ahora
+    std::vector<const std::vector<unsigned char>*> levelData;
+    std::vector<std::vector<unsigned char>> lateData;
+    std::vector<const Entry*> pageEntries;
+    for (const Entry& entry : entries) {
+        if (entry.ref.page == load.page) pageEntries.push_back(&entry);
+    }
+    lateData.reserve(pageEntries.size());
+    for (const Entry* entry : pageEntries) {
+        const std::vector<unsigned char>* data = nullptr;
+        for (size_t i = 0; i < load.paths.size(); ++i) {
+            if (load.paths[i] == entry->path && load.ok[i]) data = &load.data[i];
+        }
+        if (!data) {
+            lateData.emplace_back();
+            if (!TextureCodec::ReadLevel(entry->cachePath, entry->cacheKey, load.level, lateData.back())) {
+                std::cout << "No se pudo leer el nivel " << load.level << " de " << entry->path << " desde la caché" << std::endl;
+                page.failed = true;
+                return;
+            }
+            data = &lateData.back();
+        }
+        levelData.push_back(data);
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page.texture);
+    AllocateLevel(page, load.level);
+    for (size_t i = 0; i < pageEntries.size(); ++i) UploadLevel(page, *pageEntries[i], load.level, *levelData[i]);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, load.level);
+    page.residentLevel = load.level;
+    streamedLevels++;
+}
+
+void TextureArrays::UpdateStreaming(size_t budgetBytes) {
+    for (size_t i = 0; i < loads.size();) {
+        if (loads[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) { ++i; continue; }
+        LevelLoad load = loads[i].get();
+        loads.erase(loads.begin() + i);
+        FinishLoad(load);
+    }
+
+    size_t residentBytes = 0;
+    for (const Page& page : pages) residentBytes += page.bytes;
+    if (budgetBytes > 0) EvictForBudget(residentBytes, budgetBytes, -1);
+
+    // Se refina primero la página a la que más niveles le faltan respecto a lo pedido
+    while (loads.size() < static_cast<size_t>(MAX_LOADS)) {
+        int best = -1;
+        for (size_t p = 0; p < pages.size(); ++p) {
+            const Page& page = pages[p];
+            if (page.texture == 0 || !page.streamed || page.loading || page.failed || page.lastWanted != frame) continue;
+            if (page.wantedLevel >= page.residentLevel) continue;
+            if (best == -1 || page.residentLevel - page.wantedLevel > pages[best].residentLevel - pages[best].wantedLevel) best = static_cast<int>(p);
+        }
+        if (best == -1) break;
+
+        Page& page = pages[best];
+        int level = page.residentLevel - 1;
+        size_t levelBytes = LevelBytes(page, level);
+        if (budgetBytes > 0) {
+            size_t needed = residentBytes + levelBytes;
+            bool fits = EvictForBudget(needed, budgetBytes, best);
+            residentBytes = needed - levelBytes;
+            if (!fits) {
+                // No cabe: se queda como está hasta que algo deje de usarse
+                page.wantedLevel = page.residentLevel;
+                continue;
+            }
+        }
+        residentBytes += levelBytes;
+
+        LevelLoad load;
+        load.page = best;
+        load.generation = page.generation;
+        load.level = level;
+        std::vector<std::pair<std::string, std::string>> sources;
+        for (const Entry& entry : entries) {
+            if (entry.ref.page != best) continue;
+            load.paths.push_back(entry.path);
+            sources.emplace_back(entry.cachePath, entry.cacheKey);
+        }
+        page.loading = true;
+        loads.push_back(std::async(std::launch::async, [load, sources]() mutable {
+            load.data.resize(sources.size());
+            load.ok.resize(sources.size());
+            for (size_t i = 0; i < sources.size(); ++i) {
+                load.ok[i] = TextureCodec::ReadLevel(sources[i].first, sources[i].second, load.level, load.data[i]);
+            }
+            return load;
+        }));
+    }
+    frame++;
+}
+
+TextureArrayStats TextureArrays::GetStats() {
+    TextureArrayStats stats;
+    stats.textures = static_cast<int>(entries.size());
+    for (const Page& page : pages) {
+        if (page.texture == 0) continue;
+        stats.pages++;
+        if (page.atlas) stats.atlasPages++;
+        stats.bytes += page.bytes;
+        for (int level = 0; level < page.levels; ++level) stats.fullBytes += LevelBytes(page, level);
+    }
+    stats.pendingLoads = static_cast<int>(loads.size());
+    stats.streamedLevels = streamedLevels;
+    stats.evictedLevels = evictedLevels;
+    return stats;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TextureCodec.h"
+
+// Posición de una textura dentro de los arrays: página (un GL_TEXTURE_2D_ARRAY), capa y
+// rectángulo que ocupa en esa capa (desplazamiento en xy, escala en zw)
+struct TextureRef {
+    int page = -1; // -1 si no hay textura
+    int layer = 0;
+    glm::vec4 rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    bool IsValid() const { return page != -1; }
+};
+
+struct TextureArrayStats {
+    int textures = 0;     // Texturas cargadas (cada ruta cuenta una vez)
+    int pages = 0;        // GL_TEXTURE_2D_ARRAY creados
+    int atlasPages = 0;   // De ellos, los que empaquetan texturas de tamaño irregular
+    size_t bytes = 0;     // Memoria reservada en GPU, incluidos mipmaps y capas libres
+    size_t fullBytes = 0; // La que ocuparían las mismas páginas con todos sus niveles
+    int pendingLoads = 0; // Niveles leyéndose de la caché
+    int streamedLevels = 0; // Niveles subidos por el streaming (acumulado)
+    int evictedLevels = 0;  // Niveles expulsados por el presupuesto (acumulado)
+};
+
+// Agrupa las texturas difusas en GL_TEXTURE_2D_ARRAY para que cambiar de material sea cambiar
+// un índice de capa y no de textura. Las de lado potencia de dos comparten página con las de su
+// mismo tamaño y formato (una capa cada una); las demás se empaquetan con un skyline en capas de
+// atlas de ATLAS_SIZE, con un margen que repite la textura para que el filtrado y el mosaico (el
+// shader aplica fract a las UV) no sangren entre vecinas. Las imágenes llegan ya comprimidas y con
+// sus mipmaps desde TextureCodec; aquí solo se reserva sitio y se suben.
+// Al importar solo se sube la cola de mipmaps. Cada frame los modelos visibles piden (Touch) el
+// nivel que necesita su densidad de texels en pantalla, y UpdateStreaming lee de la caché el
+// siguiente nivel más fino de la página que más lo necesita. Como todas las capas de un array
+// comparten niveles, la residencia es por página (GL_TEXTURE_BASE_LEVEL) y, si se pasa del
+// presupuesto, se expulsa el nivel más fino de la página usada hace más tiempo.
+// Solo se usa desde el hilo principal.
+class TextureArrays {
+public:
+    static constexpr int ATLAS_SIZE = 2048;
+    static constexpr int ATLAS_LAYERS = 4;
+    static constexpr int ATLAS_PADDING = 4;                    // Píxeles de margen a cada lado
+    static constexpr int ATLAS_MAX_LEVEL = 2;                  // log2(ATLAS_PADDING): mips sin sangrado
+    static constexpr int ATLAS_ALIGN = 4 << ATLAS_MAX_LEVEL;   // Huecos alineados a bloques 4x4 en todos los mips
+    static constexpr int ATLAS_MAX_ITEM = 1024;                // Lado máximo para ir al atlas
+    static constexpr int MAX_LAYERS = 16;                      // Capas por página de tamaño fijo
+    static constexpr size_t PAGE_BYTES = 64u * 1024u * 1024u;  // Límite de memoria de una página
+    static constexpr int MAX_LOADS = 2;                        // Lecturas de niveles en vuelo
+
+    // Sube la textura (o reutiliza la ya cargada con la misma ruta) y suma un usuario. 'image' es
+    // la imagen preparada en el hilo de carga; si es nula se prepara aquí. Devuelve una
+    // referencia inválida si no se puede leer el archivo.
+    static TextureRef Acquire(const std::string& path, std::shared_ptr<const TextureImage> image = nullptr);
+    // Resta un usuario; al llegar a cero se libera su capa o su hueco en el atlas
+    static void Release(const TextureRef& ref);
+
+    // Pide para este frame el nivel que necesita la textura: 'uvPerPixel' son las unidades de
+    // UV que cubre un píxel de pantalla
+    static void Touch(const TextureRef& ref, float uvPerPixel);
+    // Una vez por frame: sube los niveles ya leídos, expulsa por LRU lo que no quepa en
+    // 'budgetBytes' (0 = sin límite) y lanza la lectura de los siguientes
+    static void UpdateStreaming(size_t budgetBytes);
+
+    static GLuint GetTexture(int page) { return pages[page].texture; }
+    static TextureArrayStats GetStats();
+
+private:
+    // Segmento horizontal del contorno superior de lo ya empaquetado en una capa de atlas
+    struct SkylineNode {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+    };
+
+    struct Page {
+        GLuint texture = 0;
+        GLenum format = GL_RGBA8;
+        int width = 0;
+        int height = 0;
+        int capacity = 0;
+        int levels = 1;
+        bool atlas = false;
+        size_t bytes = 0;                              // Solo los niveles residentes
+        std::vector<int> layerUsers;                   // Texturas vivas en cada capa
+        std::vector<std::vector<SkylineNode>> skylines; // Solo en las páginas de atlas
+
+        // Streaming (solo si sus texturas tienen copia en caché)
+        bool streamed = false;
+        int tailLevel = 0;       // Nivel que nunca se expulsa
+        int residentLevel = 0;   // Nivel más fino con memoria reservada (GL_TEXTURE_BASE_LEVEL)
+        int wantedLevel = 0;     // Nivel más fino pedido en 'lastWanted'
+        uint64_t lastWanted = 0; // Último frame en el que algún modelo la pidió (LRU)
+        bool loading = false;
+        bool failed = false;     // No se pudo leer un nivel: deja de refinarse
+        unsigned int generation = 0; // Cambia al reutilizar el hueco, para descartar lecturas viejas
+    };
+
+    struct Entry {
+        std::string path;
+        TextureRef ref;
+        int users = 0;
+        glm::ivec2 pos = glm::ivec2(0); // Esquina en la capa (nivel 0)
+        int width = 0;
+        int height = 0;
+        std::string cachePath;
+        std::string cacheKey;
+    };
+
+    // Un nivel de todas las texturas de una página, leído fuera del hilo principal
+    struct LevelLoad {
+        int page = -1;
+        unsigned int generation = 0;
+        int level = 0;
+        std::vector<std::string> paths;
+        std::vector<std::vector<unsigned char>> data;
+        std::vector<char> ok;
+    };
+
+    static bool PlaceInAtlas(Page& page, int layer, int width, int height, glm::ivec2& outPos);
+    static int CreatePage(const TextureImage& image, int width, int height, int capacity);
+    static size_t LevelBytes(const Page& page, int level);
+    static void AllocateLevel(Page& page, int level);
+    static void UploadLevel(const Page& page, const Entry& entry, int level, const std::vector<unsigned char>& data);
+    static size_t EvictLevel(Page& page);
+    static bool EvictForBudget(size_t& residentBytes, size_t budgetBytes, int keepPage);
+    static void FinishLoad(LevelLoad& load);
+
+    static std::vector<Page> pages;
+    static std::vector<Entry> entries;
+    static std::vector<std::future<LevelLoad>> loads;
+    static uint64_t frame;
+    static int streamedLevels;
+    static int evictedLevels;
+};
@@ -0,0 +1,799 @@
+#include "TextureCodec.h"
+#include "TextureArrays.h"
+#include "../Core/ThreadPool.h"
+#include "../include/stb_image.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTURE_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+std::atomic<bool> TextureCodec::compressionEnabled(false);
+std::atomic<int> TextureCodec::maxTextureSize(4096);
+std::atomic<size_t> TextureCodec::budgetBytes(0);
+std::atomic<int> TextureCodec::encodedCount(0);
+std::atomic<int> TextureCodec::resizedCount(0);
+std::atomic<int> TextureCodec::cacheHitCount(0);
+std::atomic<long long> TextureCodec::encodeMicroseconds(0);
+
+namespace {
+    const size_t BLOCK_ROWS_PER_TASK = 8;
+    const size_t FILTER_ROWS_PER_TASK = 8;
+    const int LINEAR_STEPS = 65535;
+    const double KAISER_RADIUS = 3.0; // Lóbulos del sinc a cada lado
+    const double KAISER_BETA = 4.0;
+
+    unsigned short To565(const int rgb[3]) {
+        return static_cast<unsigned short>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+    }
+
+    void From565(unsigned short color, int rgb[3]) {
+        int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    // Mínimo y máximo por canal de los 16 píxeles
+    void ColorBounds(const unsigned char* rgba, unsigned char minColor[4], unsigned char maxColor[4]) {
+#ifdef TEXTURE_CODEC_SSE2
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 16));
+        __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 32));
+        __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 48));
+        __m128i mn = _mm_min_epu8(_mm_min_epu8(p0, p1), _mm_min_epu8(p2, p3));
+        __m128i mx = _mm_max_epu8(_mm_max_epu8(p0, p1), _mm_max_epu8(p2, p3));
+        mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+        mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+        mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+        mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+        int packedMin = _mm_cvtsi128_si32(mn);
+        int packedMax = _mm_cvtsi128_si32(mx);
+        std::memcpy(minColor, &packedMin, 4);
+        std::memcpy(maxColor, &packedMax, 4);
+#else
+        for (int c = 0; c < 4; ++c) {
+            minColor[c] = 255;
+            maxColor[c] = 0;
+        }
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                minColor[c] = std::min(minColor[c], rgba[i * 4 + c]);
+                maxColor[c] = std::max(maxColor[c], rgba[i * 4 + c]);
+            }
+        }
+#endif
+    }
+
+    // Proyecta cada píxel sobre el eje base -> base + axis y lo cuantiza a 0..3 (round(3t))
+    void ProjectColors(const unsigned char* rgba, const int base[3], const int axis[3], int steps[16]) {
+        int denom = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+#ifdef TEXTURE_CODEC_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i baseVec = _mm_set_epi16(0, static_cast<short>(base[2]), static_cast<short>(base[1]), static_cast<short>(base[0]),
+                                              0, static_cast<short>(base[2]), static_cast<short>(base[1]), static_cast<short>(base[0]));
+        const __m128i axisVec = _mm_set_epi16(0, static_cast<short>(axis[2]), static_cast<short>(axis[1]), static_cast<short>(axis[0]),
+                                              0, static_cast<short>(axis[2]), static_cast<short>(axis[1]), static_cast<short>(axis[0]));
+        const __m128i t1 = _mm_set1_epi32(denom), t3 = _mm_set1_epi32(denom * 3), t5 = _mm_set1_epi32(denom * 5);
+        for (int i = 0; i < 4; ++i) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 16));
+            // madd deja por píxel (r*ar + g*ag, b*ab): se suman las dos mitades de cada lane de 64 bits
+            __m128i lo = _mm_madd_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(pixels, zero), baseVec), axisVec);
+            __m128i hi = _mm_madd_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(pixels, zero), baseVec), axisVec);
+            lo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+            hi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+            __m128i dots = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)),
+                                              _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+            __m128i dots6 = _mm_add_epi32(dots, dots);
+            dots6 = _mm_add_epi32(dots6, _mm_add_epi32(dots6, dots6));
+            __m128i count = _mm_add_epi32(_mm_add_epi32(_mm_cmpgt_epi32(dots6, t1), _mm_cmpgt_epi32(dots6, t3)),
+                                          _mm_cmpgt_epi32(dots6, t5));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(steps + i * 4), _mm_sub_epi32(zero, count));
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            int dot = 0;
+            for (int c = 0; c < 3; ++c) dot += (rgba[i * 4 + c] - base[c]) * axis[c];
+            int dots6 = dot * 6;
+            steps[i] = (dots6 > denom) + (dots6 > denom * 3) + (dots6 > denom * 5);
+        }
+#endif
+    }
+
+    // Bloque de color BC1 en modo de 4 colores (c0 > c1); la caja envolvente se encoge 1/16
+    // por cada lado para que los extremos no los decidan píxeles aislados
+    void EncodeColorBlock(const unsigned char* rgba, unsigned char* out) {
+        unsigned char minColor[4], maxColor[4];
+        ColorBounds(rgba, minColor, maxColor);
+
+        int low[3], high[3];
+        for (int c = 0; c < 3; ++c) {
+            int inset = (maxColor[c] - minColor[c]) >> 4;
+            low[c] = minColor[c] + inset;
+            high[c] = maxColor[c] - inset;
+        }
+        unsigned short c0 = To565(high), c1 = To565(low);
+
+        unsigned int indices = 0;
+        if (c0 != c1) {
+            // Cada canal de 'high' es >= que el de 'low', así que c0 > c1 sin necesidad de intercambiar
+            int e0[3], e1[3], axis[3];
+            From565(c0, e0);
+            From565(c1, e1);
+            for (int c = 0; c < 3; ++c) axis[c] = e0[c] - e1[c];
+
+            int steps[16];
+            ProjectColors(rgba, e1, axis, steps);
+            static const unsigned int STEP_TO_INDEX[4] = { 1, 3, 2, 0 }; // c1, 2/3 c1 + 1/3 c0, 1/3 c1 + 2/3 c0, c0
+            for (int i = 0; i < 16; ++i) indices |= STEP_TO_INDEX[steps[i]] << (i * 2);
+        }
+
+        out[0] = static_cast<unsigned char>(c0 & 0xFF);
+        out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1 & 0xFF);
+        out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int b = 0; b < 4; ++b) out[4 + b] = static_cast<unsigned char>(indices >> (b * 8));
+    }
+
+    // Bloque de un canal (BC4, alfa de BC3) en modo de 8 valores: a0 = máximo, a1 = mínimo
+    void EncodeChannelBlock(const unsigned char* rgba, int channel, unsigned char* out) {
+        unsigned char low, high;
+        short steps[16];
+#ifdef TEXTURE_CODEC_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        __m128i values[4];
+        for (int i = 0; i < 4; ++i) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 16));
+            values[i] = _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(channel * 8)), byteMask);
+        }
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]), _mm_packs_epi32(values[2], values[3]));
+
+        __m128i mn = _mm_min_epu8(bytes, _mm_srli_si128(bytes, 8));
+        mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 4));
+        mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 2));
+        mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 1));
+        __m128i mx = _mm_max_epu8(bytes, _mm_srli_si128(bytes, 8));
+        mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 4));
+        mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 2));
+        mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 1));
+        low = static_cast<unsigned char>(_mm_cvtsi128_si32(mn) & 0xFF);
+        high = static_cast<unsigned char>(_mm_cvtsi128_si32(mx) & 0xFF);
+
+        if (low != high) {
+            // round(7t) contando cuántos umbrales (2k+1)/14 supera cada valor
+            int range = high - low;
+            __m128i base = _mm_set1_epi16(low);
+            __m128i fourteen = _mm_set1_epi16(14);
+            __m128i scaledLo = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(bytes, zero), base), fourteen);
+            __m128i scaledHi = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(bytes, zero), base), fourteen);
+            __m128i countLo = zero, countHi = zero;
+            for (int k = 0; k < 7; ++k) {
+                __m128i threshold = _mm_set1_epi16(static_cast<short>((2 * k + 1) * range));
+                countLo = _mm_sub_epi16(countLo, _mm_cmpgt_epi16(scaledLo, threshold));
+                countHi = _mm_sub_epi16(countHi, _mm_cmpgt_epi16(scaledHi, threshold));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(steps), countLo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(steps + 8), countHi);
+        }
+#else
+        low = 255;
+        high = 0;
+        for (int i = 0; i < 16; ++i) {
+            low = std::min(low, rgba[i * 4 + channel]);
+            high = std::max(high, rgba[i * 4 + channel]);
+        }
+        if (low != high) {
+            int range = high - low;
+            for (int i = 0; i < 16; ++i) {
+                int scaled = (rgba[i * 4 + channel] - low) * 14;
+                short count = 0;
+                for (int k = 0; k < 7; ++k) count += scaled > (2 * k + 1) * range;
+                steps[i] = count;
+            }
+        }
+#endif
+
+        uint64_t indices = 0;
+        if (low != high) {
+            for (int i = 0; i < 16; ++i) {
+                // 7 -> a0, 0 -> a1, el resto son las interpolaciones 2..7 en orden inverso
+                uint64_t index = steps[i] == 7 ? 0 : (steps[i] == 0 ? 1 : 8 - steps[i]);
+                indices |= index << (i * 3);
+            }
+        }
+        out[0] = high;
+        out[1] = low;
+        for (int b = 0; b < 6; ++b) out[2 + b] = static_cast<unsigned char>(indices >> (b * 8));
+    }
+
+    uint64_t HashString(const std::string& text) {
+        uint64_t hash = 14695981039346656037ull; // FNV-1a
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Conversión sRGB <-> lineal por tablas: 256 entradas de ida y 64K de vuelta para no perder
+    // precisión en los tonos oscuros
+    const float* SrgbToLinearTable() {
+        static const std::vector<float> table = [] {
+            std::vector<float> values(256);
+            for (int i = 0; i < 256; ++i) {
+                float c = i / 255.0f;
+                values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return values;
+        }();
+        return table.data();
+    }
+
+    const unsigned char* LinearToSrgbTable() {
+        static const std::vector<unsigned char> table = [] {
+            std::vector<unsigned char> values(LINEAR_STEPS + 1);
+            for (int i = 0; i <= LINEAR_STEPS; ++i) {
+                float c = static_cast<float>(i) / LINEAR_STEPS;
+                float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                values[i] = static_cast<unsigned char>(std::min(255.0f, s * 255.0f + 0.5f));
+            }
+            return values;
+        }();
+        return table.data();
+    }
+
+    // Color en lineal (alfa tal cual, ya es lineal) de un píxel RGBA8
+    void LoadLinear(const unsigned char* px, const float* toLinear, float* out) {
+        out[0] = toLinear[px[0]];
+        out[1] = toLinear[px[1]];
+        out[2] = toLinear[px[2]];
+        out[3] = px[3] * (1.0f / 255.0f);
+    }
+
+    void StoreSrgb(const float* linear, const unsigned char* toSrgb, unsigned char* px) {
+        for (int c = 0; c < 3; ++c) {
+            float v = std::min(1.0f, std::max(0.0f, linear[c]));
+            px[c] = toSrgb[static_cast<int>(v * LINEAR_STEPS + 0.5f)];
+        }
+        px[3] = static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, linear[3])) * 255.0f + 0.5f);
+    }
+
+    // Reducción 2x2 (los bordes impares repiten la última fila o columna): media de los cuatro
+    // píxeles en espacio lineal, por filas en paralelo
+    std::vector<unsigned char> Downsample(const std::vector<unsigned char>& src, int width, int height, int& outWidth, int& outHeight) {
+        outWidth = std::max(1, width / 2);
+        outHeight = std::max(1, height / 2);
+        std::vector<unsigned char> dst(static_cast<size_t>(outWidth) * outHeight * 4);
+        const float* toLinear = SrgbToLinearTable();
+        const unsigned char* toSrgb = LinearToSrgbTable();
+        int dstWidth = outWidth;
+
+        ThreadPool::Get().ParallelFor(outHeight, FILTER_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; ++y) {
+                int y0 = std::min(static_cast<int>(y) * 2, height - 1), y1 = std::min(static_cast<int>(y) * 2 + 1, height - 1);
+                for (int x = 0; x < dstWidth; ++x) {
+                    int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                    const unsigned char* quad[4] = {
+                        src.data() + (static_cast<size_t>(y0) * width + x0) * 4, src.data() + (static_cast<size_t>(y0) * width + x1) * 4,
+                        src.data() + (static_cast<size_t>(y1) * width + x0) * 4, src.data() + (static_cast<size_t>(y1) * width + x1) * 4 };
+                    float average[4];
+#ifdef TEXTURE_CODEC_SSE2
+                    __m128 sum = _mm_setzero_ps();
+                    for (const unsigned char* px : quad) {
+                        sum = _mm_add_ps(sum, _mm_set_ps(px[3] * (1.0f / 255.0f), toLinear[px[2]], toLinear[px[1]], toLinear[px[0]]));
+                    }
+                    _mm_storeu_ps(average, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+                    float texel[4];
+                    std::fill(average, average + 4, 0.0f);
+                    for (const unsigned char* px : quad) {
+                        LoadLinear(px, toLinear, texel);
+                        for (int c = 0; c < 4; ++c) average[c] += texel[c] * 0.25f;
+                    }
+#endif
+                    StoreSrgb(average, toSrgb, dst.data() + (y * dstWidth + x) * 4);
+                }
+            }
+        });
+        return dst;
+    }
+
+    double BesselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Pesos de un filtro sinc con ventana de Kaiser para pasar de srcSize a dstSize muestras.
+    // Los índices ya vienen repetidos en el borde (las texturas se usan en mosaico) y todas las
+    // muestras de salida tienen 'stride' pesos, rellenando con ceros.
+    struct FilterTaps {
+        int stride = 0;
+        std::vector<int> index;
+        std::vector<float> weight;
+    };
+
+    FilterTaps BuildKaiserTaps(int srcSize, int dstSize) {
+        double scale = static_cast<double>(srcSize) / dstSize;
+        double support = KAISER_RADIUS * scale;
+        const double pi = 3.14159265358979323846;
+
+        FilterTaps taps;
+        taps.stride = static_cast<int>(std::ceil(support)) * 2 + 1;
+        taps.index.assign(static_cast<size_t>(dstSize) * taps.stride, 0);
+        taps.weight.assign(static_cast<size_t>(dstSize) * taps.stride, 0.0f);
+        double normalization = BesselI0(KAISER_BETA);
+
+        std::vector<double> weights(taps.stride);
+        for (int i = 0; i < dstSize; ++i) {
+            double center = (i + 0.5) * scale - 0.5;
+            int first = static_cast<int>(std::ceil(center - support));
+            double total = 0.0;
+            for (int t = 0; t < taps.stride; ++t) {
+                double distance = (first + t - center) / scale;
+                double windowed = 0.0;
+                if (std::abs(distance) < KAISER_RADIUS) {
+                    double sinc = distance == 0.0 ? 1.0 : std::sin(pi * distance) / (pi * distance);
+                    double ratio = distance / KAISER_RADIUS;
+                    windowed = sinc * BesselI0(KAISER_BETA * std::sqrt(1.0 - ratio * ratio)) / normalization;
+                }
+                weights[t] = windowed;
+                total += windowed;
+            }
+            for (int t = 0; t < taps.stride; ++t) {
+                size_t slot = static_cast<size_t>(i) * taps.stride + t;
+                taps.index[slot] = ((first + t) % srcSize + srcSize) % srcSize;
+                taps.weight[slot] = static_cast<float>(weights[t] / total);
+            }
+        }
+        return taps;
+    }
+
+    // Suma ponderada de 'taps.stride' píxeles RGBA en float
+    void ApplyTaps(const FilterTaps& taps, int sample, const float* pixels, size_t pixelStride, float* out) {
+        const int* index = taps.index.data() + static_cast<size_t>(sample) * taps.stride;
+        const float* weight = taps.weight.data() + static_cast<size_t>(sample) * taps.stride;
+#ifdef TEXTURE_CODEC_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (int t = 0; t < taps.stride; ++t) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(pixels + index[t] * pixelStride)));
+        }
+        _mm_storeu_ps(out, sum);
+#else
+        std::fill(out, out + 4, 0.0f);
+        for (int t = 0; t < taps.stride; ++t) {
+            for (int c = 0; c < 4; ++c) out[c] += weight[t] * pixels[index[t] * pixelStride + c];
+        }
+#endif
+    }
+
+    // Reduce la imagen a dstWidth x dstHeight en espacio lineal con un filtro separable. Cada
+    // tarea filtra en horizontal solo las filas de origen que necesitan sus filas de salida, así
+    // que nunca hay una copia en float de la imagen completa.
+    std::vector<unsigned char> Resize(const std::vector<unsigned char>& src, int width, int height, int dstWidth, int dstHeight) {
+        FilterTaps horizontal = BuildKaiserTaps(width, dstWidth);
+        FilterTaps vertical = BuildKaiserTaps(height, dstHeight);
+        std::vector<unsigned char> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+        const float* toLinear = SrgbToLinearTable();
+        const unsigned char* toSrgb = LinearToSrgbTable();
+
+        ThreadPool::Get().ParallelFor(dstHeight, FILTER_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            std::vector<int> rowSlot(height, -1);
+            std::vector<int> sourceRows;
+            for (size_t y = begin; y < end; ++y) {
+                for (int t = 0; t < vertical.stride; ++t) {
+                    int row = vertical.index[y * vertical.stride + t];
+                    if (rowSlot[row] == -1) {
+                        rowSlot[row] = static_cast<int>(sourceRows.size());
+                        sourceRows.push_back(row);
+                    }
+                }
+            }
+
+            std::vector<float> line(static_cast<size_t>(width) * 4);
+            std::vector<float> filtered(sourceRows.size() * dstWidth * 4);
+            for (size_t r = 0; r < sourceRows.size(); ++r) {
+                const unsigned char* srcRow = src.data() + static_cast<size_t>(sourceRows[r]) * width * 4;
+                for (int x = 0; x < width; ++x) LoadLinear(srcRow + x * 4, toLinear, line.data() + x * 4);
+                for (int x = 0; x < dstWidth; ++x) ApplyTaps(horizontal, x, line.data(), 4, filtered.data() + (r * dstWidth + x) * 4);
+            }
+
+            // Las filas de origen se indexan por su hueco en 'filtered'
+            FilterTaps rows;
+            rows.stride = vertical.stride;
+            rows.index.resize(rows.stride);
+            rows.weight.resize(rows.stride);
+            float pixel[4];
+            for (size_t y = begin; y < end; ++y) {
+                for (int t = 0; t < rows.stride; ++t) {
+                    rows.index[t] = rowSlot[vertical.index[y * vertical.stride + t]];
+                    rows.weight[t] = vertical.weight[y * vertical.stride + t];
+                }
+                for (int x = 0; x < dstWidth; ++x) {
+                    ApplyTaps(rows, 0, filtered.data() + x * 4, static_cast<size_t>(dstWidth) * 4, pixel);
+                    StoreSrgb(pixel, toSrgb, dst.data() + (y * dstWidth + x) * 4);
+                }
+            }
+        });
+        return dst;
+    }
+
+    // Tamaño tras aplicar el tope al lado mayor, conservando la proporción
+    void CappedSize(int width, int height, int maxSize, int& outWidth, int& outHeight) {
+        outWidth = width;
+        outHeight = height;
+        int longest = std::max(width, height);
+        if (maxSize <= 0 || longest <= maxSize) return;
+        double factor = static_cast<double>(maxSize) / longest;
+        outWidth = std::max(1, static_cast<int>(width * factor + 0.5));
+        outHeight = std::max(1, static_cast<int>(height * factor + 0.5));
+    }
+
+    // Comprime un nivel repartiendo las filas de bloques entre los hilos del pool
+    std::vector<unsigned char> EncodeLevel(const std::vector<unsigned char>& pixels, int width, int height, GLenum format) {
+        int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        size_t blockBytes = format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+        std::vector<unsigned char> encoded(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+        ThreadPool::Get().ParallelFor(blocksY, BLOCK_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            unsigned char block[64];
+            for (size_t by = begin; by < end; ++by) {
+                for (int bx = 0; bx < blocksX; ++bx) {
+                    // Los bloques que se salen de la imagen repiten el último píxel
+                    for (int py = 0; py < 4; ++py) {
+                        int y = std::min(static_cast<int>(by) * 4 + py, height - 1);
+                        for (int px = 0; px < 4; ++px) {
+                            int x = std::min(bx * 4 + px, width - 1);
+                            std::memcpy(block + (py * 4 + px) * 4, pixels.data() + (static_cast<size_t>(y) * width + x) * 4, 4);
+                        }
+                    }
+                    unsigned char* out = encoded.data() + (by * blocksX + bx) * blockBytes;
+                    if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) TextureCodec::EncodeBC1(block, out);
+                    else if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) TextureCodec::EncodeBC3(block, out);
+                    else TextureCodec::EncodeBC5(block, out);
+                }
+            }
+        });
+        return encoded;
+    }
+}
+
+void TextureCodec::EncodeBC1(const unsigned char* rgba, unsigned char* out) {
+    EncodeColorBlock(rgba, out);
+}
+
+void TextureCodec::EncodeBC3(const unsigned char* rgba, unsigned char* out) {
+    EncodeChannelBlock(rgba, 3, out);
+    EncodeColorBlock(rgba, out + 8);
+}
+
+void TextureCodec::EncodeBC5(const unsigned char* rgba, unsigned char* out) {
+    EncodeChannelBlock(rgba, 0, out);
+    EncodeChannelBlock(rgba, 3, out + 8);
+}
+
+size_t TextureCodec::LevelSize(GLenum format, int width, int height) {
+    if (format == GL_RGBA8) return static_cast<size_t>(width) * height * 4;
+    size_t blockBytes = format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+}
+
+void TextureCodec::Init() {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    bool s3tc = false;
+    for (GLint i = 0; i < count && !s3tc; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) s3tc = true;
+    }
+    compressionEnabled = s3tc;
+    if (!s3tc) std::cout << "S3TC no disponible: las texturas se suben sin comprimir" << std::endl;
+}
+
+void TextureCodec::SetLimits(int maxSize, size_t budget) {
+    maxTextureSize = maxSize;
+    budgetBytes = budget;
+}
+
+int TextureCodec::FitToBudget(const std::vector<std::string>& paths) {
+    int maxSize = maxTextureSize.load();
+    size_t budget = budgetBytes.load();
+    if (budget == 0 || paths.empty()) return maxSize;
+
+    struct Header { int width, height, components; };
+    std::vector<Header> headers;
+    for (const std::string& path : paths) {
+        Header header;
+        if (stbi_info(path.c_str(), &header.width, &header.height, &header.components)) headers.push_back(header);
+    }
+
+    // Se estima con el formato que tendrá cada una (sin decodificar no se sabe si el alfa es
+    // opaco, así que las de 4 canales cuentan como BC3) y un tercio más por los mipmaps
+    bool compress = compressionEnabled.load();
+    int cap = maxSize;
+    for (; cap > MIN_SIZE; cap /= 2) {
+        size_t total = 0;
+        for (const Header& header : headers) {
+            GLenum format = GL_RGBA8;
+            if (compress) format = header.components == 2 || header.components == 4 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            int width, height;
+            CappedSize(header.width, header.height, cap, width, height);
+            total += LevelSize(format, width, height) * 4 / 3;
+        }
+        if (total <= budget) break;
+    }
+    if (cap < maxSize) {
+        std::cout << "Presupuesto de VRAM: texturas limitadas a " << cap << " px" << std::endl;
+    }
+    return cap;
+}
+
+std::shared_ptr<TextureImage> TextureCodec::Prepare(const std::string& path, int maxSize) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    uintmax_t fileSize = fs::file_size(absolute, ec);
+    if (ec) {
+        std::cout << "No se pudo cargar la textura (¿Esta en la misma carpeta?): " << path << std::endl;
+        return nullptr;
+    }
+    auto modified = fs::last_write_time(absolute, ec).time_since_epoch().count();
+
+    int sourceWidth, sourceHeight, sourceComponents, targetWidth, targetHeight;
+    if (!stbi_info(path.c_str(), &sourceWidth, &sourceHeight, &sourceComponents)) {
+        std::cout << "No se pudo cargar la textura (¿Esta en la misma carpeta?): " << path << std::endl;
+        return nullptr;
+    }
+    CappedSize(sourceWidth, sourceHeight, maxSize > 0 ? maxSize : maxTextureSize.load(), targetWidth, targetHeight);
+
+    // La clave cambia si cambia el archivo, el tamaño final, el formato de salida o la forma de
+    // empaquetar el atlas
+    bool compress = compressionEnabled.load();
+    std::string key = absolute.string() + "|" + std::to_string(fileSize) + "|" + std::to_string(static_cast<long long>(modified))
+                    + "|" + std::to_string(targetWidth) + "x" + std::to_string(targetHeight)
+                    + "|" + std::to_string(CACHE_VERSION) + "|" + (compress ? "bc" : "rgba")
+                    + "|" + std::to_string(TextureArrays::ATLAS_MAX_ITEM) + "|" + std::to_string(TextureArrays::ATLAS_PADDING)
+                    + "|" + std::to_string(TextureArrays::ATLAS_ALIGN);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.btex", static_cast<unsigned long long>(HashString(key)));
+    std::string cachePath = (fs::path(CACHE_DIR) / name).string();
+
+    std::shared_ptr<TextureImage> cached = ReadCache(cachePath, key);
+    if (cached) {
+        cacheHitCount++;
+        return cached;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    stbi_set_flip_vertically_on_load_thread(1);
+    int width, height, nrComponents;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 4);
+    if (!data) {
+        std::cout << "No se pudo cargar la textura (¿Esta en la misma carpeta?): " << path << std::endl;
+        return nullptr;
+    }
+    std::vector<unsigned char> pixels(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+
+    // Las texturas enormes (escaneos de 16K) se reducen antes de nada: ni se comprime ni se
+    // sube una resolución que el visor no va a mostrar
+    if (width != targetWidth || height != targetHeight) {
+        pixels = Resize(pixels, width, height, targetWidth, targetHeight);
+        width = targetWidth;
+        height = targetHeight;
+        resizedCount++;
+    }
+
+    auto image = std::make_shared<TextureImage>();
+    image->contentWidth = width;
+    image->contentHeight = height;
+
+    bool hasAlpha = false;
+    if (nrComponents == 4) {
+        for (size_t i = 3; i < pixels.size(); i += 4) {
+            if (pixels[i] != 255) { hasAlpha = true; break; }
+        }
+    }
+    if (!compress) image->format = GL_RGBA8;
+    else if (nrComponents == 2) image->format = GL_COMPRESSED_RG_RGTC2;
+    else if (hasAlpha) image->format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else image->format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    // Las texturas de lado irregular van al atlas con un margen que repite la imagen, redondeado
+    // a ATLAS_ALIGN para que cada mip del hueco siga alineado a bloques de 4x4
+    bool powerOfTwo = (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+    int levelCount;
+    if (!powerOfTwo && std::max(width, height) <= TextureArrays::ATLAS_MAX_ITEM) {
+        const int align = TextureArrays::ATLAS_ALIGN;
+        int paddedWidth = (width + TextureArrays::ATLAS_PADDING * 2 + align - 1) / align * align;
+        int paddedHeight = (height + TextureArrays::ATLAS_PADDING * 2 + align - 1) / align * align;
+        std::vector<unsigned char> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+        for (int y = 0; y < paddedHeight; ++y) {
+            int srcY = ((y - TextureArrays::ATLAS_PADDING) % height + height) % height;
+            for (int x = 0; x < paddedWidth; ++x) {
+                int srcX = ((x - TextureArrays::ATLAS_PADDING) % width + width) % width;
+                std::memcpy(padded.data() + (static_cast<size_t>(y) * paddedWidth + x) * 4,
+                            pixels.data() + (static_cast<size_t>(srcY) * width + srcX) * 4, 4);
+            }
+        }
+        pixels.swap(padded);
+        width = paddedWidth;
+        height = paddedHeight;
+        image->atlas = true;
+        levelCount = TextureArrays::ATLAS_MAX_LEVEL + 1;
+    } else {
+        levelCount = 1;
+        for (int w = width, h = height; w > 1 || h > 1; w = std::max(1, w / 2), h = std::max(1, h / 2)) levelCount++;
+    }
+    image->width = width;
+    image->height = height;
+    image->levelCount = levelCount;
+
+    for (int level = 0; level < levelCount; ++level) {
+        if (level > 0) pixels = Downsample(pixels, width, height, width, height);
+        image->levels.push_back(image->IsCompressed() ? EncodeLevel(pixels, width, height, image->format) : pixels);
+    }
+
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    encodeMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    encodedCount++;
+
+    // Con la cadena completa en disco basta con quedarse la cola; sin caché se sube todo
+    if (WriteCache(cachePath, key, *image)) {
+        image->cachePath = cachePath;
+        image->cacheKey = key;
+        image->firstLevel = TailLevel(image->width, image->height, levelCount, image->atlas);
+        image->levels.erase(image->levels.begin(), image->levels.begin() + image->firstLevel);
+    }
+    return image;
+}
+
+int TextureCodec::TailLevel(int width, int height, int levelCount, bool atlas) {
+    if (atlas) return levelCount - 1;
+    int level = 0;
+    while (level < levelCount - 1 && std::max(width >> level, height >> level) > TAIL_SIZE) level++;
+    return level;
+}
+
+namespace {
+    uint32_t ReadU32(std::ifstream& file) {
+        uint32_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    // Cabecera de un .btex; deja el archivo al principio del primer nivel
+    bool ReadCacheHeader(std::ifstream& file, const std::string& key, TextureImage& image) {
+        char magic[4];
+        file.read(magic, 4);
+        if (!file || std::memcmp(magic, "BTEX", 4) != 0 || ReadU32(file) != TextureCodec::CACHE_VERSION) return false;
+
+        // La clave completa va dentro del archivo por si dos rutas comparten hash. La longitud
+        // se comprueba antes de reservar: un archivo corrupto podría pedir hasta 4 GB
+        uint32_t keyLength = ReadU32(file);
+        if (!file || keyLength != key.size()) return false;
+        std::string storedKey(keyLength, '\0');
+        file.read(&storedKey[0], storedKey.size());
+        if (!file || storedKey != key) return false;
+
+        image.format = ReadU32(file);
+        image.width = static_cast<int>(ReadU32(file));
+        image.height = static_cast<int>(ReadU32(file));
+        image.contentWidth = static_cast<int>(ReadU32(file));
+        image.contentHeight = static_cast<int>(ReadU32(file));
+        image.atlas = ReadU32(file) != 0;
+        image.levelCount = static_cast<int>(ReadU32(file));
+        return file && image.levelCount > 0 && image.levelCount <= 32;
+    }
+
+    // Lee (o salta, si 'out' es nulo) el siguiente nivel comprobando su tamaño
+    bool ReadCacheLevel(std::ifstream& file, const TextureImage& image, int level, std::vector<unsigned char>* out) {
+        size_t size = TextureCodec::LevelSize(image.format, std::max(1, image.width >> level), std::max(1, image.height >> level));
+        if (ReadU32(file) != size) return false;
+        if (!out) {
+            file.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+            return static_cast<bool>(file);
+        }
+        out->resize(size);
+        file.read(reinterpret_cast<char*>(out->data()), size);
+        return static_cast<bool>(file);
+    }
+}
+
+std::shared_ptr<TextureImage> TextureCodec::ReadCache(const std::string& cachePath, const std::string& key) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) return nullptr;
+
+    auto image = std::make_shared<TextureImage>();
+    if (!ReadCacheHeader(file, key, *image)) return nullptr;
+
+    // Solo se lee la cola de mipmaps; el resto lo pide TextureArrays cuando hace falta
+    image->firstLevel = TailLevel(image->width, image->height, image->levelCount, image->atlas);
+    for (int level = 0; level < image->levelCount; ++level) {
+        if (level < image->firstLevel) {
+            if (!ReadCacheLevel(file, *image, level, nullptr)) return nullptr;
+            continue;
+        }
+        image->levels.emplace_back();
+        if (!ReadCacheLevel(file, *image, level, &image->levels.back())) return nullptr;
+    }
+    image->cachePath = cachePath;
+    image->cacheKey = key;
+    return image;
+}
+
+bool TextureCodec::ReadLevel(const std::string& cachePath, const std::string& key, int level, std::vector<unsigned char>& out) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) return false;
+
+    TextureImage header;
+    if (!ReadCacheHeader(file, key, header) || level >= header.levelCount) return false;
+    for (int skipped = 0; skipped < level; ++skipped) {
+        if (!ReadCacheLevel(file, header, skipped, nullptr)) return false;
+    }
+    return ReadCacheLevel(file, header, level, &out);
+}
+
+bool TextureCodec::WriteCache(const std::string& cachePath, const std::string& key, const TextureImage& image) {
+    std::error_code ec;
+    std::filesystem::create_directories(CACHE_DIR, ec);
+
+    // Se escribe a un temporal y se renombra para que otro hilo de carga nunca lea un archivo a medias
+    std::string tempPath = cachePath + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary);
+        if (!file) return false;
+        auto writeU32 = [&file](uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+        file.write("BTEX", 4);
+        writeU32(CACHE_VERSION);
+        writeU32(static_cast<uint32_t>(key.size()));
+        file.write(key.data(), key.size());
+        writeU32(image.format);
+        writeU32(static_cast<uint32_t>(image.width));
+        writeU32(static_cast<uint32_t>(image.height));
+        writeU32(static_cast<uint32_t>(image.contentWidth));
+        writeU32(static_cast<uint32_t>(image.contentHeight));
+        writeU32(image.atlas ? 1 : 0);
+        writeU32(static_cast<uint32_t>(image.levels.size()));
+        for (const std::vector<unsigned char>& level : image.levels) {
+            writeU32(static_cast<uint32_t>(level.size()));
+            file.write(reinterpret_cast<const char*>(level.data()), level.size());
+        }
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+TextureCodecStats TextureCodec::GetStats() {
+    TextureCodecStats stats;
+    stats.encoded = encodedCount.load();
+    stats.resized = resizedCount.load();
+    stats.cacheHits = cacheHitCount.load();
+    stats.encodeMs = encodeMicroseconds.load() / 1000.0;
+    return stats;
+}
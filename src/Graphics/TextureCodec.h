@@ -0,0 +1,100 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// GLAD se generó sin extensiones: los formatos S3TC (GL_EXT_texture_compression_s3tc) se
+// declaran a mano. RGTC (BC4/BC5) es núcleo desde OpenGL 3.0.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Textura lista para subir: cadena de mipmaps ya comprimida en bloques (o RGBA8 si el driver no
+// admite S3TC). Si va al atlas, la imagen incluye el margen repetido alrededor del contenido.
+// Cuando hay copia en caché solo se guarda la cola de mipmaps (desde 'firstLevel'); los niveles
+// finos se leen del .btex cuando TextureArrays los pide.
+struct TextureImage {
+    GLenum format = GL_RGBA8;  // GL_COMPRESSED_RGB_S3TC_DXT1_EXT, _DXT5_EXT, GL_COMPRESSED_RG_RGTC2 o GL_RGBA8
+    int width = 0;             // Tamaño del nivel 0 (con margen)
+    int height = 0;
+    int contentWidth = 0;      // Tamaño original de la textura
+    int contentHeight = 0;
+    bool atlas = false;        // Se empaqueta en una página de atlas en vez de ocupar una capa
+    int levelCount = 0;        // Niveles de la cadena completa
+    int firstLevel = 0;        // Nivel al que corresponde levels[0]
+    std::string cachePath;     // .btex del que leer los niveles que faltan; vacío si no hay caché
+    std::string cacheKey;
+    std::vector<std::vector<unsigned char>> levels;
+
+    bool IsCompressed() const { return format != GL_RGBA8; }
+    bool IsStreamed() const { return !cachePath.empty(); }
+};
+
+struct TextureCodecStats {
+    int encoded = 0;     // Texturas comprimidas desde la imagen original
+    int resized = 0;     // De ellas, las reducidas por el tamaño máximo
+    int cacheHits = 0;   // Texturas leídas ya comprimidas de cache/textures
+    double encodeMs = 0.0;
+};
+
+// Decodifica y comprime texturas en los hilos de carga: BC1 para las opacas, BC3 si tienen
+// transparencia y BC5 (rojo = gris, verde = alfa) para las de dos canales. Las que superan el
+// tamaño máximo se reducen con un filtro Kaiser y los mipmaps se promedian en espacio lineal
+// (las texturas están en sRGB), todo en paralelo y con SSE2. El resultado, con toda la cadena de
+// mipmaps, se guarda en cache/textures para que la siguiente carga solo tenga que leerlo y subirlo.
+class TextureCodec {
+public:
+    static constexpr const char* CACHE_DIR = "cache/textures";
+    static constexpr unsigned int CACHE_VERSION = 2;
+    static constexpr int MIN_SIZE = 256; // El presupuesto de VRAM no baja el tope de aquí
+    static constexpr int TAIL_SIZE = 128; // Lado del nivel más fino que se carga al importar
+
+    // Comprueba si el driver admite S3TC; llamar con el contexto creado y antes de cargar nada
+    static void Init();
+    static bool CompressionEnabled() { return compressionEnabled.load(); }
+
+    // Lado máximo de las texturas (potencia de dos) y presupuesto de VRAM en bytes (0 = sin
+    // límite). Afectan a las texturas que se carguen a partir de ahora.
+    static void SetLimits(int maxSize, size_t budgetBytes);
+    // Tope con el que las texturas de 'paths' caben en el presupuesto; solo lee las cabeceras
+    static int FitToBudget(const std::vector<std::string>& paths);
+
+    // Imagen preparada para 'path' (desde la caché o comprimida ahora), o nullptr si no se
+    // puede leer. 'maxSize' 0 usa el tamaño máximo configurado. Se puede llamar desde cualquier hilo.
+    static std::shared_ptr<TextureImage> Prepare(const std::string& path, int maxSize = 0);
+
+    static TextureCodecStats GetStats();
+
+    // Lee un nivel de la cadena completa de un .btex (desde cualquier hilo)
+    static bool ReadLevel(const std::string& cachePath, const std::string& key, int level, std::vector<unsigned char>& out);
+
+    // Tamaño en bytes de un nivel de width x height en 'format'
+    static size_t LevelSize(GLenum format, int width, int height);
+    // Primer nivel que se carga al importar: las páginas de atlas solo tienen unos pocos niveles
+    // y cargan el último; el resto, el primero que no pasa de TAIL_SIZE
+    static int TailLevel(int width, int height, int levelCount, bool atlas);
+
+    // Comprimen un bloque de 4x4 píxeles RGBA (64 bytes) y escriben 8 o 16 bytes
+    static void EncodeBC1(const unsigned char* rgba, unsigned char* out);
+    static void EncodeBC3(const unsigned char* rgba, unsigned char* out);
+    static void EncodeBC5(const unsigned char* rgba, unsigned char* out);
+
+private:
+    // 'key' identifica archivo, versión y opciones; se guarda entero en la cabecera
+    static std::shared_ptr<TextureImage> ReadCache(const std::string& cachePath, const std::string& key);
+    static bool WriteCache(const std::string& cachePath, const std::string& key, const TextureImage& image);
+
+    static std::atomic<bool> compressionEnabled;
+    static std::atomic<int> maxTextureSize;
+    static std::atomic<size_t> budgetBytes;
+    static std::atomic<int> encodedCount;
+    static std::atomic<int> resizedCount;
+    static std::atomic<int> cacheHitCount;
+    static std::atomic<long long> encodeMicroseconds;
+};
@@ -0,0 +1,84 @@
+#include "VertexFormat.h"
+#include "VertexLayout.h"
+#include "../Core/ThreadPool.h"
+#include "../Scene/PositionStream.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float HALF_MAX = 65504.0f;
+    const size_t PACK_GRAIN = 16384;
+
+    template <typename Vertex> struct VertexTag { using Type = Vertex; };
+
+    // Resuelve el struct de vértice de un formato y llama a 'fn' con su etiqueta
+    template <typename Fn>
+    auto visitVertexFormat(VertexFormat format, Fn&& fn) {
+        switch (format) {
+            case VertexFormat::Compact:        return fn(VertexTag<CompactVertex>());
+            case VertexFormat::CompactFloatUv: return fn(VertexTag<CompactFloatUvVertex>());
+            case VertexFormat::CompactNoUv:    return fn(VertexTag<CompactNoUvVertex>());
+            default:                           return fn(VertexTag<MeshVertex>());
+        }
+    }
+}
+
+namespace Utils {
+    VertexFormat chooseVertexFormat(const std::vector<float>& vertices, int maxTextureSize) {
+        if (maxTextureSize <= 0) return VertexFormat::CompactNoUv;
+
+        float maxUv = 0.0f;
+        for (size_t i = 0; i < vertices.size(); i += 8) {
+            maxUv = std::max(maxUv, std::max(std::abs(vertices[i + 6]), std::abs(vertices[i + 7])));
+        }
+        if (maxUv > HALF_MAX) return VertexFormat::CompactFloatUv;
+
+        // Separación entre halfs consecutivos en el mayor valor: 10 bits de mantisa. Si supera
+        // un texel de la textura más grande, el redondeo se notaría
+        float spacing = maxUv < 6.1e-5f ? std::ldexp(1.0f, -24) : std::ldexp(1.0f, static_cast<int>(std::floor(std::log2(maxUv))) - 10);
+        return spacing * maxTextureSize <= 1.0f ? VertexFormat::Compact : VertexFormat::CompactFloatUv;
+    }
+
+    size_t vertexStride(VertexFormat format) {
+        return visitVertexFormat(format, [](auto tag) { return sizeof(typename decltype(tag)::Type); });
+    }
+
+    VertexDecode computeVertexDecode(const std::vector<float>& vertices, VertexFormat format) {
+        VertexDecode decode;
+        if (format == VertexFormat::Float) return decode;
+
+        // La AABB se mide aquí y no se toma del modelo: incluye cualquier vértice de los LOD
+        glm::vec3 minBounds, maxBounds;
+        Utils::positionBounds(vertices.data(), vertices.size() / 8, minBounds, maxBounds);
+        if (vertices.empty()) minBounds = maxBounds = glm::vec3(0.0f);
+        decode.packed = true;
+        decode.positionOffset = minBounds;
+        decode.positionScale = maxBounds - minBounds;
+        return decode;
+    }
+
+    void packVertexRange(const std::vector<float>& vertices, VertexFormat format, const VertexDecode& decode,
+                         size_t first, size_t count, unsigned char* dst) {
+        const MeshVertex* src = reinterpret_cast<const MeshVertex*>(vertices.data()) + first;
+        visitVertexFormat(format, [&](auto tag) {
+            using Vertex = typename decltype(tag)::Type;
+            Vertex* out = reinterpret_cast<Vertex*>(dst);
+            ThreadPool::Get().ParallelFor(count, PACK_GRAIN, [&](size_t begin, size_t end) {
+                packVertices<Vertex>(src + begin, end - begin, decode, out + begin);
+            });
+        });
+    }
+
+    void setupVertexAttributes(VertexFormat format) {
+        // Un VAO reutilizado podría conservar la UV de un layout anterior
+        glDisableVertexAttribArray(2);
+        visitVertexFormat(format, [](auto tag) { setupVertexAttributes<typename decltype(tag)::Type>(); });
+    }
+
+    void applyVertexDecode(GLuint shaderProgram, const VertexDecode& decode) {
+        glUniform1i(glGetUniformLocation(shaderProgram, "packedVertices"), decode.packed ? 1 : 0);
+        glUniform3fv(glGetUniformLocation(shaderProgram, "positionOffset"), 1, glm::value_ptr(decode.positionOffset));
+        glUniform3fv(glGetUniformLocation(shaderProgram, "positionScale"), 1, glm::value_ptr(decode.positionScale));
+    }
+}
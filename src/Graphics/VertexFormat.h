@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+// Formato del VBO de un modelo. En CPU los vértices siguen siendo 8 floats (posición, normal,
+// UV); al subirlos se compactan: posición normalizada a 16 bits dentro de la AABB del modelo y
+// normal octaédrica en 2x16 bits. La UV va en half si la precisión basta para la textura más
+// grande del modelo, en float si no, y se omite si el modelo no tiene texturas.
+enum class VertexFormat {
+    Float,          // 32 bytes, sin compactar (luces y geometría generada a mano)
+    Compact,        // 16 bytes: posición 4x16 (la cuarta es relleno), normal 2x16, UV 2xhalf
+    CompactFloatUv, // 20 bytes: como Compact con la UV en float
+    CompactNoUv,    // 12 bytes: sin UV
+};
+
+// Lo que el vertex shader necesita para deshacer la compactación
+struct VertexDecode {
+    bool packed = false;                       // Posición cuantizada y normal octaédrica
+    glm::vec3 positionOffset = glm::vec3(0.0f); // Posición = offset + aPos * scale
+    glm::vec3 positionScale = glm::vec3(1.0f);
+};
+
+namespace Utils {
+    // 'maxTextureSize' es el lado de la textura más grande del modelo (0 si no tiene ninguna)
+    VertexFormat chooseVertexFormat(const std::vector<float>& vertices, int maxTextureSize);
+    size_t vertexStride(VertexFormat format);
+
+    // AABB de cuantización de los vértices (stride de 8 floats); por defecto en formato Float
+    VertexDecode computeVertexDecode(const std::vector<float>& vertices, VertexFormat format);
+    // Empaqueta los vértices [first, first + count) en 'dst' (count * vertexStride bytes),
+    // repartidos entre los hilos del pool
+    void packVertexRange(const std::vector<float>& vertices, VertexFormat format, const VertexDecode& decode,
+                         size_t first, size_t count, unsigned char* dst);
+    // Declara los atributos 0 (posición), 1 (normal) y 2 (UV) sobre el VAO y VBO enlazados
+    void setupVertexAttributes(VertexFormat format);
+    // Sube los uniforms de decodificación; los VAO en float pasan un VertexDecode por defecto
+    void applyVertexDecode(GLuint shaderProgram, const VertexDecode& decode);
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "VertexFormat.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Descriptores de layout de vértice. Cada vértice es un struct y su VertexLayout<> declara
+// una tabla constexpr de atributos (qué es, cómo se codifica y dónde está). De esa tabla salen
+// la declaración de atributos del VAO y el empaquetado desde los 8 floats de CPU, así que
+// stride y offsets no se escriben a mano en ningún sitio.
+
+// Qué representa el atributo; fija su location en los shaders
+enum class VertexSemantic {
+    Position = 0,
+    Normal = 1,
+    TexCoord = 2,
+    Color = 3,
+};
+
+// Cómo se guarda en el VBO
+enum class VertexEncoding {
+    Float,         // Floats tal cual
+    Unorm16Bounds, // Posición normalizada a 16 bits dentro de la AABB (VertexDecode)
+    OctSnorm16,    // Normal octaédrica en 2x16 bits con signo
+    Half,          // Half floats
+    Unorm8,        // Bytes normalizados a [0, 1] (colores)
+};
+
+struct VertexAttribute {
+    VertexSemantic semantic;
+    VertexEncoding encoding;
+    GLint components;
+    size_t offset;
+};
+
+// Número de componentes de un miembro, deducido de su tipo
+template <typename T> struct VertexComponents;
+template <> struct VertexComponents<glm::vec2> { static constexpr GLint value = 2; };
+template <> struct VertexComponents<glm::vec3> { static constexpr GLint value = 3; };
+template <typename T, size_t N> struct VertexComponents<T[N]> { static constexpr GLint value = static_cast<GLint>(N); };
+
+#define VERTEX_ATTRIBUTE(Vertex, member, semantic, encoding) \
+    VertexAttribute{ VertexSemantic::semantic, VertexEncoding::encoding, \
+                     VertexComponents<decltype(Vertex::member)>::value, offsetof(Vertex, member) }
+
+// Vértice de CPU y del formato Float: la disposición de Model::vertices
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
+static_assert(sizeof(MeshVertex) == 8 * sizeof(float), "MeshVertex debe coincidir con los 8 floats de Model::vertices");
+
+struct CompactVertex {
+    uint16_t position[3];
+    uint16_t padding; // Alinea la normal a 4 bytes
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+struct CompactFloatUvVertex {
+    uint16_t position[3];
+    uint16_t padding;
+    int16_t normal[2];
+    float uv[2];
+};
+
+struct CompactNoUvVertex {
+    uint16_t position[3];
+    uint16_t padding;
+    int16_t normal[2];
+};
+
+// Líneas de depuración y rejilla
+struct LineVertex {
+    glm::vec3 position;
+};
+
+// Esquina del quad de los impostores en [-1, 1]^2
+struct QuadVertex {
+    glm::vec2 corner;
+};
+
+// Líneas y puntos de DebugDraw, cada uno con su color RGBA8
+struct DebugVertex {
+    glm::vec3 position;
+    uint8_t color[4];
+};
+
+template <typename Vertex> struct VertexLayout;
+
+template <> struct VertexLayout<MeshVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(MeshVertex, position, Position, Float),
+        VERTEX_ATTRIBUTE(MeshVertex, normal, Normal, Float),
+        VERTEX_ATTRIBUTE(MeshVertex, uv, TexCoord, Float),
+    };
+};
+
+template <> struct VertexLayout<CompactVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(CompactVertex, position, Position, Unorm16Bounds),
+        VERTEX_ATTRIBUTE(CompactVertex, normal, Normal, OctSnorm16),
+        VERTEX_ATTRIBUTE(CompactVertex, uv, TexCoord, Half),
+    };
+};
+
+template <> struct VertexLayout<CompactFloatUvVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(CompactFloatUvVertex, position, Position, Unorm16Bounds),
+        VERTEX_ATTRIBUTE(CompactFloatUvVertex, normal, Normal, OctSnorm16),
+        VERTEX_ATTRIBUTE(CompactFloatUvVertex, uv, TexCoord, Float),
+    };
+};
+
+// Sin UV el atributo 2 queda desactivado y toma el valor constante (0, 0)
+template <> struct VertexLayout<CompactNoUvVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(CompactNoUvVertex, position, Position, Unorm16Bounds),
+        VERTEX_ATTRIBUTE(CompactNoUvVertex, normal, Normal, OctSnorm16),
+    };
+};
+
+template <> struct VertexLayout<LineVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(LineVertex, position, Position, Float),
+    };
+};
+
+template <> struct VertexLayout<QuadVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(QuadVertex, corner, Position, Float),
+    };
+};
+
+template <> struct VertexLayout<DebugVertex> {
+    static constexpr VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(DebugVertex, position, Position, Float),
+        VERTEX_ATTRIBUTE(DebugVertex, color, Color, Unorm8),
+    };
+};
+
+#undef VERTEX_ATTRIBUTE
+
+namespace Utils {
+    namespace VertexCodec {
+        constexpr GLenum glType(VertexEncoding encoding) {
+            switch (encoding) {
+                case VertexEncoding::Unorm16Bounds: return GL_UNSIGNED_SHORT;
+                case VertexEncoding::OctSnorm16:    return GL_SHORT;
+                case VertexEncoding::Half:          return GL_HALF_FLOAT;
+                case VertexEncoding::Unorm8:        return GL_UNSIGNED_BYTE;
+                default:                            return GL_FLOAT;
+            }
+        }
+
+        constexpr GLboolean normalized(VertexEncoding encoding) {
+            return encoding == VertexEncoding::Unorm16Bounds || encoding == VertexEncoding::OctSnorm16 ||
+                   encoding == VertexEncoding::Unorm8 ? GL_TRUE : GL_FALSE;
+        }
+
+        // Normal unitaria al octaedro plegado sobre [-1, 1]^2, sin ramas que dependan del signo
+        inline glm::vec2 octEncode(glm::vec3 n) {
+            float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            float inverseSum = sum > 0.0f ? 1.0f / sum : 0.0f;
+            n *= inverseSum;
+            float signX = std::copysign(1.0f, n.x);
+            float signY = std::copysign(1.0f, n.y);
+            glm::vec2 folded((1.0f - std::abs(n.y)) * signX, (1.0f - std::abs(n.x)) * signY);
+            return n.z >= 0.0f ? glm::vec2(n.x, n.y) : folded;
+        }
+
+        // Redondeo al más cercano sin std::lround, que es una llamada por componente
+        inline int16_t toSnorm16(float value) {
+            float scaled = std::min(1.0f, std::max(-1.0f, value)) * 32767.0f;
+            return static_cast<int16_t>(scaled + std::copysign(0.5f, scaled));
+        }
+
+        inline uint16_t toUnorm16(float value) {
+            return static_cast<uint16_t>(std::min(1.0f, std::max(0.0f, value)) * 65535.0f + 0.5f);
+        }
+
+        // Codifica un atributo de 'src' en 'dst' (ya desplazado a su offset). 'inverseExtent'
+        // es 1 / positionScale, precalculado fuera del bucle
+        inline void encode(const VertexAttribute& attribute, const MeshVertex& src, const VertexDecode& decode,
+                           const glm::vec3& inverseExtent, unsigned char* dst) {
+            const float* values = attribute.semantic == VertexSemantic::Position ? &src.position.x
+                                : attribute.semantic == VertexSemantic::Normal ? &src.normal.x : &src.uv.x;
+            switch (attribute.encoding) {
+                case VertexEncoding::Float:
+                    std::memcpy(dst, values, attribute.components * sizeof(float));
+                    break;
+                case VertexEncoding::Unorm16Bounds: {
+                    glm::vec3 normalized = (src.position - decode.positionOffset) * inverseExtent;
+                    uint16_t packed[3] = { toUnorm16(normalized.x), toUnorm16(normalized.y), toUnorm16(normalized.z) };
+                    std::memcpy(dst, packed, sizeof(packed));
+                    break;
+                }
+                case VertexEncoding::OctSnorm16: {
+                    glm::vec2 oct = octEncode(src.normal);
+                    int16_t packed[2] = { toSnorm16(oct.x), toSnorm16(oct.y) };
+                    std::memcpy(dst, packed, sizeof(packed));
+                    break;
+                }
+                case VertexEncoding::Half: {
+                    uint32_t packed = glm::packHalf2x16(glm::vec2(values[0], values[1]));
+                    std::memcpy(dst, &packed, sizeof(packed));
+                    break;
+                }
+                case VertexEncoding::Unorm8:
+                    break; // MeshVertex no lleva color: solo lo usan los layouts que se rellenan a mano
+            }
+        }
+    }
+
+    // Declara los atributos del layout sobre el VAO y VBO enlazados
+    template <typename Vertex>
+    void setupVertexAttributes() {
+        for (const VertexAttribute& attribute : VertexLayout<Vertex>::attributes) {
+            GLuint location = static_cast<GLuint>(attribute.semantic);
+            glVertexAttribPointer(location, attribute.components, VertexCodec::glType(attribute.encoding),
+                                  VertexCodec::normalized(attribute.encoding), sizeof(Vertex), (const void*)attribute.offset);
+            glEnableVertexAttribArray(location);
+        }
+    }
+
+    // Crea VAO y VBO con los vértices dados y declara sus atributos
+    template <typename Vertex>
+    void uploadVertices(const std::vector<Vertex>& vertices, GLuint& vao, GLuint& vbo, GLenum usage = GL_STATIC_DRAW) {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), usage);
+        setupVertexAttributes<Vertex>();
+        glBindVertexArray(0);
+    }
+
+    // Empaqueta 'count' vértices de CPU en el layout. 'decode' trae ya la AABB si el layout
+    // cuantiza posiciones. El bucle interno recorre una tabla constexpr y se resuelve por layout
+    template <typename Vertex>
+    void packVertices(const MeshVertex* src, size_t count, const VertexDecode& decode, Vertex* dst) {
+        glm::vec3 extent = decode.positionScale;
+        glm::vec3 inverseExtent(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                                extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                                extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+        for (size_t v = 0; v < count; ++v) {
+            Vertex packed{};
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(&packed);
+            for (const VertexAttribute& attribute : VertexLayout<Vertex>::attributes) {
+                VertexCodec::encode(attribute, src[v], decode, inverseExtent, bytes + attribute.offset);
+            }
+            dst[v] = packed;
+        }
+    }
+
+    // Añade un vértice a un array plano de floats (Model::vertices)
+    inline void appendVertex(std::vector<float>& vertices, const MeshVertex& vertex) {
+        const float* values = &vertex.position.x;
+        vertices.insert(vertices.end(), values, values + sizeof(MeshVertex) / sizeof(float));
+    }
+}
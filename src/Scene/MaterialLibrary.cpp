@@ -0,0 +1,55 @@
+#include "MaterialLibrary.h"
+#include <cmath>
+
+std::vector<Material> MaterialLibrary::materials;
+
+// Colores que solo difieren por debajo de la precisión de 8 bits se consideran iguales
+static bool SameDiffuse(const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 d = glm::abs(a - b);
+    return d.x < 0.5f / 255.0f && d.y < 0.5f / 255.0f && d.z < 0.5f / 255.0f;
+}
+
+int MaterialLibrary::Acquire(const MaterialDesc& desc) {
+    int id = -1;
+    for (size_t i = 0; i < materials.size(); ++i) {
+        if (materials[i].texturePath == desc.texturePath && SameDiffuse(materials[i].diffuse, desc.diffuse)) {
+            id = static_cast<int>(i);
+            break;
+        }
+    }
+
+    if (id == -1) {
+        Material material;
+        material.name = desc.name;
+        material.diffuse = desc.diffuse;
+        material.texturePath = desc.texturePath;
+        materials.push_back(material);
+        id = static_cast<int>(materials.size()) - 1;
+    }
+
+    Material& material = materials[id];
+    if (material.users == 0 && !material.texturePath.empty()) {
+        material.texture = TextureArrays::Acquire(material.texturePath, desc.image);
+    }
+    material.users++;
+    return id;
+}
+
+void MaterialLibrary::Release(int id) {
+    if (id < 0 || id >= static_cast<int>(materials.size())) return;
+    Material& material = materials[id];
+    if (material.users == 0) return;
+
+    if (--material.users == 0) {
+        TextureArrays::Release(material.texture);
+        material.texture = TextureRef();
+    }
+}
+
+int MaterialLibrary::ActiveCount() {
+    int count = 0;
+    for (const Material& material : materials) {
+        if (material.users > 0) count++;
+    }
+    return count;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "Model.h"
+#include "../Graphics/TextureArrays.h"
+
+struct Material {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(0.7f);
+    std::string texturePath;
+    TextureRef texture;   // Capa en TextureArrays; inválida si no tiene textura o si nadie lo usa
+    int users = 0;        // Modelos que lo referencian
+};
+
+// Tabla global de materiales compartida por todos los modelos. Dos materiales con el mismo
+// color difuso y la misma textura son el mismo aunque vengan de .mtl distintos, así que la cola
+// de render puede agrupar por id de material. Las texturas viven en TextureArrays.
+// Solo se usa desde el hilo principal (sube texturas).
+class MaterialLibrary {
+public:
+    // Id del material equivalente ya registrado o de uno nuevo; suma un usuario
+    static int Acquire(const MaterialDesc& desc);
+    // Resta un usuario; al llegar a cero se libera la textura (el id se puede reutilizar)
+    static void Release(int id);
+
+    static const Material& Get(int id) { return materials[id]; }
+    static int ActiveCount();
+
+private:
+    static std::vector<Material> materials;
+};
@@ -0,0 +1,279 @@
+#include "MeshOptimizer.h"
+#include "Model.h"
+#include "MeshWeld.h"
+#include "../Core/ThreadPool.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+namespace {
+    const size_t MIN_CLUSTER_TRIANGLES = 32;
+
+    glm::vec3 VertexPosition(const Model& model, unsigned int index) {
+        return glm::vec3(model.vertices[index * 8 + 0], model.vertices[index * 8 + 1], model.vertices[index * 8 + 2]);
+    }
+
+    // Ordena los 'indexCount' índices de 'indices' con Tipsify. En 'clusterStarts' deja el
+    // primer triángulo de cada cluster: Tipsify empieza uno nuevo cada vez que se queda sin
+    // vecinos en caché y tiene que saltar a otra zona de la malla.
+    void Tipsify(unsigned int* indices, size_t indexCount, std::vector<size_t>& clusterStarts) {
+        size_t triangleCount = indexCount / 3;
+        clusterStarts.assign(1, 0);
+        if (triangleCount < 2) return;
+
+        // Ids locales para que los arrays sean del tamaño del rango y no del modelo
+        std::vector<unsigned int> unique(indices, indices + indexCount);
+        std::sort(unique.begin(), unique.end());
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        size_t vertexCount = unique.size();
+        std::vector<unsigned int> local(indexCount);
+        for (size_t i = 0; i < indexCount; ++i) {
+            local[i] = static_cast<unsigned int>(std::lower_bound(unique.begin(), unique.end(), indices[i]) - unique.begin());
+        }
+
+        // Triángulos de cada vértice (offsets + lista) y cuántos le quedan por emitir
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for (unsigned int v : local) offsets[v + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+        std::vector<int> live(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) live[v] = static_cast<int>(offsets[v + 1] - offsets[v]);
+        std::vector<unsigned int> adjacency(indexCount);
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) adjacency[fill[local[i]]++] = static_cast<unsigned int>(i / 3);
+
+        const int cacheSize = static_cast<int>(MeshOptimizer::CACHE_SIZE);
+        std::vector<int> cacheTime(vertexCount, 0);
+        std::vector<char> emitted(triangleCount, 0);
+        std::vector<unsigned int> deadEnd, candidates, order;
+        order.reserve(triangleCount);
+        int timestamp = cacheSize + 1;
+        size_t cursor = 0;
+        int fanning = 0;
+
+        while (fanning >= 0) {
+            // Emite todos los triángulos pendientes alrededor del vértice actual
+            candidates.clear();
+            for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+                unsigned int t = adjacency[a];
+                if (emitted[t]) continue;
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int v = local[t * 3 + k];
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    if (timestamp - cacheTime[v] > cacheSize) cacheTime[v] = timestamp++;
+                }
+                emitted[t] = 1;
+                order.push_back(t);
+            }
+
+            // Siguiente vértice: el que sigue en caché y más tiempo lleva en ella, siempre que
+            // sus triángulos pendientes no lo vayan a expulsar antes de terminar
+            int next = -1, bestPriority = -1;
+            for (unsigned int v : candidates) {
+                if (live[v] <= 0) continue;
+                int priority = 0;
+                if (timestamp - cacheTime[v] + 2 * live[v] <= cacheSize) priority = timestamp - cacheTime[v];
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = static_cast<int>(v);
+                }
+            }
+
+            if (next == -1) {
+                // Callejón sin salida: vértice reciente con triángulos pendientes o, si no hay,
+                // el siguiente de la malla en orden
+                while (!deadEnd.empty() && next == -1) {
+                    unsigned int v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (live[v] > 0) next = static_cast<int>(v);
+                }
+                while (next == -1 && cursor < vertexCount) {
+                    if (live[cursor] > 0) next = static_cast<int>(cursor);
+                    cursor++;
+                }
+                // Los clusters muy pequeños se juntan con el siguiente: al reordenarlos por
+                // separado se perdería más caché de la que se gana en overdraw
+                if (next != -1 && order.size() - clusterStarts.back() >= MIN_CLUSTER_TRIANGLES) clusterStarts.push_back(order.size());
+            }
+            fanning = next;
+        }
+
+        std::vector<unsigned int> reordered;
+        reordered.reserve(indexCount);
+        for (unsigned int t : order) {
+            reordered.push_back(indices[t * 3 + 0]);
+            reordered.push_back(indices[t * 3 + 1]);
+            reordered.push_back(indices[t * 3 + 2]);
+        }
+        std::copy(reordered.begin(), reordered.end(), indices);
+    }
+
+    // Centroide y normal (ponderada por área) de los triángulos [first, first + count) de 'indices'
+    void ClusterFacing(const Model& model, const unsigned int* indices, size_t first, size_t count,
+                       glm::vec3& centroid, glm::vec3& normal) {
+        centroid = glm::vec3(0.0f);
+        normal = glm::vec3(0.0f);
+        for (size_t t = first; t < first + count; ++t) {
+            glm::vec3 p0 = VertexPosition(model, indices[t * 3 + 0]);
+            glm::vec3 p1 = VertexPosition(model, indices[t * 3 + 1]);
+            glm::vec3 p2 = VertexPosition(model, indices[t * 3 + 2]);
+            centroid += (p0 + p1 + p2) / 3.0f;
+            normal += glm::cross(p1 - p0, p2 - p0);
+        }
+        if (count > 0) centroid /= static_cast<float>(count);
+        float length = glm::length(normal);
+        if (length > 0.0f) normal /= length;
+    }
+
+    // Reordena los clusters de un rango sin meshlets: primero los que miran hacia fuera desde
+    // el centro del modelo, que tienden a tapar al resto (métrica de Sander et al.)
+    void SortClustersForOverdraw(const Model& model, unsigned int* indices, size_t indexCount,
+                                 const std::vector<size_t>& clusterStarts, const glm::vec3& center) {
+        size_t clusterCount = clusterStarts.size();
+        if (clusterCount < 2) return;
+
+        std::vector<float> facing(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c) {
+            size_t first = clusterStarts[c];
+            size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : indexCount / 3;
+            glm::vec3 centroid, normal;
+            ClusterFacing(model, indices, first, end - first, centroid, normal);
+            facing[c] = glm::dot(centroid - center, normal);
+        }
+        std::vector<size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return facing[a] > facing[b]; });
+
+        std::vector<unsigned int> reordered;
+        reordered.reserve(indexCount);
+        for (size_t c : order) {
+            size_t first = clusterStarts[c] * 3;
+            size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] * 3 : indexCount;
+            reordered.insert(reordered.end(), indices + first, indices + end);
+        }
+        std::copy(reordered.begin(), reordered.end(), indices);
+    }
+
+    // Mismo criterio con los meshlets de cada rango, que ya traen centro y eje del cono. Los
+    // meshlets se mueven sin salir de su rango de material, así que los rangos no cambian.
+    void SortMeshletsForOverdraw(Model& model, const glm::vec3& center) {
+        std::vector<unsigned int> reordered(model.indices.size());
+        std::vector<Meshlet> sorted;
+        std::vector<MaterialRange> ranges = model.materialRanges;
+        if (ranges.empty()) {
+            ranges.emplace_back();
+            ranges.back().meshletCount = static_cast<unsigned int>(model.meshlets.size());
+        }
+        for (const MaterialRange& range : ranges) {
+            auto first = model.meshlets.begin() + range.firstMeshlet;
+            sorted.assign(first, first + range.meshletCount);
+            std::stable_sort(sorted.begin(), sorted.end(), [&](const Meshlet& a, const Meshlet& b) {
+                return glm::dot(a.center - center, a.coneAxis) > glm::dot(b.center - center, b.coneAxis);
+            });
+
+            unsigned int cursor = range.firstIndex;
+            for (Meshlet& meshlet : sorted) {
+                std::copy(model.indices.begin() + meshlet.firstIndex, model.indices.begin() + meshlet.firstIndex + meshlet.indexCount,
+                          reordered.begin() + cursor);
+                meshlet.firstIndex = cursor;
+                cursor += meshlet.indexCount;
+            }
+            std::copy(sorted.begin(), sorted.end(), first);
+        }
+        model.indices.swap(reordered);
+    }
+}
+
+void MeshOptimizer::Optimize(Model& model) {
+    if (model.indices.empty()) return;
+
+    // 1. Soldar: a partir de aquí los vértices compartidos entre caras coplanarias se reutilizan.
+    // No se sueldan vértices de materiales distintos: los LOD toman el material de sus vértices
+    std::vector<int> vertexSlots;
+    if (!model.materialRanges.empty()) {
+        vertexSlots.assign(model.vertices.size() / 8, 0);
+        for (const MaterialRange& range : model.materialRanges) {
+            for (unsigned int i = range.firstIndex; i < range.firstIndex + range.indexCount; ++i) {
+                vertexSlots[model.indices[i]] = range.slot;
+            }
+        }
+    }
+    std::vector<unsigned int> remap;
+    size_t vertexCount = Utils::weldVertices(model.vertices, vertexSlots, remap);
+    std::vector<float> welded(vertexCount * 8);
+    for (size_t v = 0; v < remap.size(); ++v) {
+        std::copy(model.vertices.begin() + v * 8, model.vertices.begin() + v * 8 + 8, welded.begin() + remap[v] * 8);
+    }
+    model.vertices.swap(welded);
+    for (unsigned int& index : model.indices) index = remap[index];
+
+    VertexCacheStats& stats = model.vertexCache;
+    MeasureCache(model.indices, vertexCount, stats.acmrBefore, stats.atvrBefore);
+
+    // 2 y 3. Cada meshlet (o rango) es independiente: se reparten entre los hilos de carga
+    glm::vec3 center = (model.localMinBounds + model.localMaxBounds) * 0.5f;
+    if (!model.meshlets.empty()) {
+        SortMeshletsForOverdraw(model, center);
+        ThreadPool::Get().ParallelFor(model.meshlets.size(), 16, [&](size_t begin, size_t end) {
+            std::vector<size_t> clusterStarts;
+            for (size_t m = begin; m < end; ++m) {
+                const Meshlet& meshlet = model.meshlets[m];
+                Tipsify(model.indices.data() + meshlet.firstIndex, meshlet.indexCount, clusterStarts);
+            }
+        });
+    } else {
+        std::vector<MaterialRange> ranges = model.materialRanges;
+        if (ranges.empty()) {
+            ranges.emplace_back();
+            ranges.back().indexCount = static_cast<unsigned int>(model.indices.size());
+        }
+        ThreadPool::Get().ParallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+            std::vector<size_t> clusterStarts;
+            for (size_t r = begin; r < end; ++r) {
+                unsigned int* indices = model.indices.data() + ranges[r].firstIndex;
+                Tipsify(indices, ranges[r].indexCount, clusterStarts);
+                SortClustersForOverdraw(model, indices, ranges[r].indexCount, clusterStarts, center);
+            }
+        });
+    }
+
+    // 4. Renumerar por orden de primer uso para que la lectura del VBO sea secuencial
+    std::vector<unsigned int> newIndex(vertexCount, UINT_MAX);
+    std::vector<float> fetchOrdered(vertexCount * 8);
+    unsigned int nextVertex = 0;
+    for (unsigned int& index : model.indices) {
+        if (newIndex[index] == UINT_MAX) {
+            std::copy(model.vertices.begin() + index * 8, model.vertices.begin() + index * 8 + 8, fetchOrdered.begin() + nextVertex * 8);
+            newIndex[index] = nextVertex++;
+        }
+        index = newIndex[index];
+    }
+    model.vertices.swap(fetchOrdered);
+
+    MeasureCache(model.indices, vertexCount, stats.acmrAfter, stats.atvrAfter);
+}
+
+void MeshOptimizer::MeasureCache(const std::vector<unsigned int>& indices, size_t vertexCount, float& acmr, float& atvr) {
+    acmr = atvr = 0.0f;
+    if (indices.empty()) return;
+
+    // Un vértice sigue en la caché FIFO si desde que entró ha habido menos de CACHE_SIZE fallos
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    std::vector<char> seen(vertexCount, 0);
+    size_t misses = 0, distinct = 0;
+    for (unsigned int index : indices) {
+        size_t time = misses + CACHE_SIZE + 1;
+        if (time - insertedAt[index] > CACHE_SIZE) {
+            insertedAt[index] = time;
+            misses++;
+        }
+        if (!seen[index]) {
+            seen[index] = 1;
+            distinct++;
+        }
+    }
+    acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    atvr = static_cast<float>(misses) / static_cast<float>(distinct);
+}
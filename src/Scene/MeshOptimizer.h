@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class Model;
+
+// Reordena el nivel 0 al importar para la caché post-transformación de la GPU, el early-Z y la
+// lectura de vértices:
+//  1. Suelda los vértices idénticos, que el OBJ repite en cada cara.
+//  2. Ordena los triángulos de cada meshlet (o de cada rango de material en mallas sin
+//     meshlets) con Tipsify (Sander, Nehab y Barczak 2007).
+//  3. Contra el overdraw, ordena los meshlets de cada rango (o los clusters que deja Tipsify)
+//     de más a menos orientados hacia fuera del modelo, que son los que más tapan.
+//  4. Renumera los vértices en el orden en que los usa el EBO.
+class MeshOptimizer {
+public:
+    static constexpr size_t CACHE_SIZE = 16; // Caché FIFO que se supone en la GPU
+
+    // Tras MeshletBuilder::Build (respeta rangos de material y meshlets) y antes de los LOD
+    static void Optimize(Model& model);
+
+    // ACMR (vértices transformados por triángulo) y ATVR (por vértice distinto) de 'indices'
+    // simulando una caché FIFO de CACHE_SIZE entradas
+    static void MeasureCache(const std::vector<unsigned int>& indices, size_t vertexCount, float& acmr, float& atvr);
+};
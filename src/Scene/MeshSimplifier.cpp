@@ -0,0 +1,361 @@
+#include "MeshSimplifier.h"
+#include "Model.h"
+#include "MeshWeld.h"
+#include "../Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+    const double BOUNDARY_WEIGHT = 10.0;   // Penaliza mover los bordes abiertos de la malla
+    const double MIN_FLIP_COSINE = 0.0;    // Un triángulo que gira más de 90 grados se considera volteado
+
+    // Matriz simétrica 4x4 guardada como sus 10 coeficientes únicos
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+
+        void AddPlane(const glm::dvec3& n, double d, double weight) {
+            a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+            b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+            c2 += weight * n.z * n.z; cd += weight * n.z * d;
+            d2 += weight * d * d;
+        }
+
+        Quadric& operator+=(const Quadric& q) {
+            a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+            b2 += q.b2; bc += q.bc; bd += q.bd;
+            c2 += q.c2; cd += q.cd;
+            d2 += q.d2;
+            return *this;
+        }
+
+        double Evaluate(const glm::dvec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                         + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                         + c2 * z * z + 2 * cd * z
+                         + d2;
+            return std::max(error, 0.0);
+        }
+    };
+
+    // Topología soldada y cuádricas iniciales, compartidas por todos los niveles
+    struct BaseMesh {
+        std::vector<glm::dvec3> positions;
+        std::vector<unsigned int> representative; // Vértice original que se usa al emitir índices
+        std::vector<unsigned int> triangles;      // 3 índices soldados por triángulo
+        std::vector<Quadric> quadrics;
+        std::vector<double> areas;                // Área acumulada, para convertir coste en distancia
+        std::vector<uint64_t> edges;              // Aristas únicas (a << 32 | b, con a < b)
+    };
+
+    uint64_t EdgeKey(unsigned int a, unsigned int b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    BaseMesh BuildBase(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+        BaseMesh base;
+
+        // 1. Soldar por posición exacta: los vértices duplicados del OBJ comparten coordenadas
+        std::vector<unsigned int> weldedIndex;
+        Utils::weldPositions(vertices, weldedIndex, base.representative);
+        base.positions.reserve(base.representative.size());
+        for (unsigned int v : base.representative) {
+            base.positions.emplace_back(vertices[v * 8 + 0], vertices[v * 8 + 1], vertices[v * 8 + 2]);
+        }
+
+        base.triangles.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            unsigned int a = weldedIndex[indices[i]], b = weldedIndex[indices[i + 1]], c = weldedIndex[indices[i + 2]];
+            if (a == b || b == c || a == c) continue;
+            base.triangles.push_back(a);
+            base.triangles.push_back(b);
+            base.triangles.push_back(c);
+        }
+        size_t triangleCount = base.triangles.size() / 3;
+
+        // 2. Cuádrica de cada cara (ponderada por área), calculada en paralelo
+        std::vector<Quadric> faceQuadrics(triangleCount);
+        std::vector<double> faceAreas(triangleCount);
+        ThreadPool::Get().ParallelFor(triangleCount, 4096, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                const glm::dvec3& p0 = base.positions[base.triangles[t * 3 + 0]];
+                const glm::dvec3& p1 = base.positions[base.triangles[t * 3 + 1]];
+                const glm::dvec3& p2 = base.positions[base.triangles[t * 3 + 2]];
+                glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+                double length = glm::length(n);
+                faceAreas[t] = length * 0.5;
+                if (length > 0.0) {
+                    n /= length;
+                    faceQuadrics[t].AddPlane(n, -glm::dot(n, p0), faceAreas[t]);
+                }
+            }
+        });
+
+        // 3. Aristas únicas y de borde (las que usa un solo triángulo)
+        std::unordered_map<uint64_t, int> edgeUse;
+        edgeUse.reserve(triangleCount * 2);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                edgeUse[EdgeKey(base.triangles[t * 3 + k], base.triangles[t * 3 + (k + 1) % 3])]++;
+            }
+        }
+
+        base.quadrics.assign(base.positions.size(), Quadric());
+        base.areas.assign(base.positions.size(), 0.0);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = base.triangles[t * 3 + k];
+                base.quadrics[v] += faceQuadrics[t];
+                base.areas[v] += faceAreas[t];
+            }
+        }
+
+        // Plano perpendicular a la cara que contiene cada arista de borde
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const glm::dvec3& p0 = base.positions[base.triangles[t * 3 + 0]];
+            const glm::dvec3& p1 = base.positions[base.triangles[t * 3 + 1]];
+            const glm::dvec3& p2 = base.positions[base.triangles[t * 3 + 2]];
+            glm::dvec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+            if (glm::length(faceNormal) <= 0.0) continue;
+            faceNormal = glm::normalize(faceNormal);
+
+            for (int k = 0; k < 3; ++k) {
+                unsigned int a = base.triangles[t * 3 + k];
+                unsigned int b = base.triangles[t * 3 + (k + 1) % 3];
+                if (edgeUse[EdgeKey(a, b)] != 1) continue;
+
+                glm::dvec3 edge = base.positions[b] - base.positions[a];
+                double edgeLength = glm::length(edge);
+                if (edgeLength <= 0.0) continue;
+                glm::dvec3 n = glm::normalize(glm::cross(edge, faceNormal));
+                Quadric constraint;
+                constraint.AddPlane(n, -glm::dot(n, base.positions[a]), BOUNDARY_WEIGHT * edgeLength * edgeLength);
+                base.quadrics[a] += constraint;
+                base.quadrics[b] += constraint;
+            }
+        }
+
+        base.edges.reserve(edgeUse.size());
+        for (const auto& entry : edgeUse) base.edges.push_back(entry.first);
+        return base;
+    }
+
+    struct Collapse {
+        double cost;
+        unsigned int from, to;
+        unsigned int fromVersion, toVersion;
+        bool operator>(const Collapse& o) const { return cost > o.cost; }
+    };
+
+    // Colapsa aristas de menor coste hasta quedarse con 'targetTriangles' y emite los índices
+    // originales. Trabaja sobre copias para que varios niveles puedan correr a la vez.
+    float SimplifyBase(const BaseMesh& base, size_t targetTriangles, std::vector<unsigned int>& outIndices) {
+        size_t vertexCount = base.positions.size();
+        size_t triangleCount = base.triangles.size() / 3;
+
+        std::vector<unsigned int> triangles = base.triangles;
+        std::vector<char> triangleAlive(triangleCount, 1);
+        std::vector<Quadric> quadrics = base.quadrics;
+        std::vector<double> areas = base.areas;
+        std::vector<unsigned int> versions(vertexCount, 0);
+        std::vector<char> removed(vertexCount, 0);
+
+        std::vector<std::vector<unsigned int>> vertexTriangles(vertexCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) vertexTriangles[triangles[t * 3 + k]].push_back(static_cast<unsigned int>(t));
+        }
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+        auto pushEdge = [&](unsigned int a, unsigned int b) {
+            Quadric q = quadrics[a];
+            q += quadrics[b];
+            double costAB = q.Evaluate(base.positions[b]);
+            double costBA = q.Evaluate(base.positions[a]);
+            Collapse c;
+            if (costAB <= costBA) { c.cost = costAB; c.from = a; c.to = b; }
+            else                  { c.cost = costBA; c.from = b; c.to = a; }
+            c.fromVersion = versions[c.from];
+            c.toVersion = versions[c.to];
+            heap.push(c);
+        };
+        for (uint64_t edge : base.edges) {
+            pushEdge(static_cast<unsigned int>(edge >> 32), static_cast<unsigned int>(edge & 0xFFFFFFFFu));
+        }
+
+        auto faceNormal = [&](unsigned int a, unsigned int b, unsigned int c) {
+            return glm::cross(base.positions[b] - base.positions[a], base.positions[c] - base.positions[a]);
+        };
+
+        size_t aliveTriangles = triangleCount;
+        double maxError = 0.0;
+        std::vector<unsigned int> neighborStamp(vertexCount, 0);
+        unsigned int stamp = 0;
+
+        while (aliveTriangles > targetTriangles && !heap.empty()) {
+            Collapse c = heap.top();
+            heap.pop();
+            if (removed[c.from] || removed[c.to]) continue;
+            if (versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion) continue;
+
+            // Rechazar el colapso si algún triángulo que sobrevive se voltea
+            bool flips = false;
+            for (unsigned int t : vertexTriangles[c.from]) {
+                if (!triangleAlive[t]) continue;
+                unsigned int* tri = &triangles[t * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) continue;
+
+                glm::dvec3 before = faceNormal(tri[0], tri[1], tri[2]);
+                unsigned int moved[3] = { tri[0], tri[1], tri[2] };
+                for (int k = 0; k < 3; ++k) if (moved[k] == c.from) moved[k] = c.to;
+                glm::dvec3 after = faceNormal(moved[0], moved[1], moved[2]);
+                if (glm::dot(before, after) <= MIN_FLIP_COSINE * glm::length(before) * glm::length(after)) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips) continue;
+
+            for (unsigned int t : vertexTriangles[c.from]) {
+                if (!triangleAlive[t]) continue;
+                unsigned int* tri = &triangles[t * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+                    triangleAlive[t] = 0; // La arista colapsada lo degenera
+                    aliveTriangles--;
+                } else {
+                    for (int k = 0; k < 3; ++k) if (tri[k] == c.from) tri[k] = c.to;
+                    vertexTriangles[c.to].push_back(t);
+                }
+            }
+            vertexTriangles[c.from].clear();
+            removed[c.from] = 1;
+            quadrics[c.to] += quadrics[c.from];
+            areas[c.to] += areas[c.from];
+            versions[c.to]++;
+            maxError = std::max(maxError, std::sqrt(c.cost / std::max(areas[c.to], 1e-12)));
+
+            // Compactar la lista del vértice superviviente y recalcular sus aristas
+            std::vector<unsigned int>& list = vertexTriangles[c.to];
+            list.erase(std::remove_if(list.begin(), list.end(), [&](unsigned int t) { return !triangleAlive[t]; }), list.end());
+            stamp++;
+            neighborStamp[c.to] = stamp;
+            for (unsigned int t : list) {
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int w = triangles[t * 3 + k];
+                    if (neighborStamp[w] == stamp) continue;
+                    neighborStamp[w] = stamp;
+                    pushEdge(c.to, w);
+                }
+            }
+        }
+
+        outIndices.clear();
+        outIndices.reserve(aliveTriangles * 3);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (!triangleAlive[t]) continue;
+            for (int k = 0; k < 3; ++k) outIndices.push_back(base.representative[triangles[t * 3 + k]]);
+        }
+        return static_cast<float>(maxError);
+    }
+}
+
+float MeshSimplifier::Simplify(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                               size_t targetTriangles, std::vector<unsigned int>& outIndices) {
+    BaseMesh base = BuildBase(vertices, indices);
+    return SimplifyBase(base, targetTriangles, outIndices);
+}
+
+// Los colapsos mantienen los índices originales, así que cada triángulo simplificado toma el
+// material de su primer vértice y cada nivel se reordena para que sus materiales sean contiguos
+static void SortLodsByMaterial(Model& model) {
+    if (model.lods.size() < 2 || model.materialRanges.empty()) return;
+
+    std::vector<int> vertexSlot(model.vertices.size() / 8, 0);
+    for (const MaterialRange& range : model.materialRanges) {
+        for (unsigned int i = range.firstIndex; i < range.firstIndex + range.indexCount; ++i) {
+            vertexSlot[model.indices[i]] = range.slot;
+        }
+    }
+
+    std::vector<size_t> order;
+    std::vector<unsigned int> sorted;
+    for (size_t level = 1; level < model.lods.size(); ++level) {
+        LodLevel& lod = model.lods[level];
+        size_t localFirst = lod.firstIndex - model.indices.size();
+        const unsigned int* tris = model.lodIndices.data() + localFirst;
+        size_t triangleCount = lod.indexCount / 3;
+
+        order.resize(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) order[t] = t;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return vertexSlot[tris[a * 3]] < vertexSlot[tris[b * 3]];
+        });
+
+        sorted.clear();
+        lod.ranges.clear();
+        for (size_t t : order) {
+            int slot = vertexSlot[tris[t * 3]];
+            if (lod.ranges.empty() || lod.ranges.back().slot != slot) {
+                MaterialRange range;
+                range.firstIndex = static_cast<unsigned int>(lod.firstIndex + sorted.size());
+                range.slot = slot;
+                lod.ranges.push_back(range);
+            }
+            lod.ranges.back().indexCount += 3;
+            sorted.insert(sorted.end(), tris + t * 3, tris + t * 3 + 3);
+        }
+        std::copy(sorted.begin(), sorted.end(), model.lodIndices.begin() + localFirst);
+    }
+}
+
+void MeshSimplifier::BuildLods(Model& model) {
+    model.lodIndices.clear();
+    model.lods.clear();
+
+    LodLevel full;
+    full.indexCount = model.indices.size();
+    model.lods.push_back(full);
+
+    size_t baseTriangles = model.indices.size() / 3;
+    if (baseTriangles < MIN_TRIANGLES) return;
+
+    BaseMesh base = BuildBase(model.vertices, model.indices);
+
+    // Cada nivel parte de la malla base y no del anterior, así se pueden calcular todos a la vez
+    const int extraLevels = MAX_LODS - 1;
+    std::vector<std::vector<unsigned int>> levelIndices(extraLevels);
+    std::vector<float> levelErrors(extraLevels, 0.0f);
+    ThreadPool::Get().ParallelFor(extraLevels, 1, [&](size_t begin, size_t end) {
+        for (size_t level = begin; level < end; ++level) {
+            size_t target = baseTriangles >> (level + 1);
+            levelErrors[level] = SimplifyBase(base, target, levelIndices[level]);
+        }
+    });
+
+    // Conservar solo los niveles que reducen de verdad; el error debe crecer de forma monótona
+    size_t previousTriangles = baseTriangles;
+    float previousError = 0.0f;
+    for (int level = 0; level < extraLevels; ++level) {
+        size_t triangles = levelIndices[level].size() / 3;
+        if (triangles == 0 || triangles > previousTriangles * 8 / 10) break;
+
+        LodLevel lod;
+        lod.firstIndex = model.indices.size() + model.lodIndices.size();
+        lod.indexCount = levelIndices[level].size();
+        lod.error = std::max(levelErrors[level], previousError);
+        model.lods.push_back(lod);
+        model.lodIndices.insert(model.lodIndices.end(), levelIndices[level].begin(), levelIndices[level].end());
+
+        previousTriangles = triangles;
+        previousError = lod.error;
+    }
+
+    SortLodsByMaterial(model);
+}
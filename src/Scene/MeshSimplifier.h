@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class Model;
+
+// Simplificación por métrica de error cuádrico (Garland-Heckbert) para generar la cadena de LOD.
+// Las posiciones se sueldan para recuperar la topología (con normales planas un mismo punto
+// aparece en un vértice por cara) y se colapsan aristas hacia uno de sus extremos, de modo que
+// los índices de cada nivel apuntan a vértices que ya existen en el VBO y no hace falta subir
+// geometría nueva.
+class MeshSimplifier {
+public:
+    static constexpr int MAX_LODS = 5;            // Incluye el nivel 0 (malla completa)
+    static constexpr size_t MIN_TRIANGLES = 256;  // Por debajo no compensa generar niveles
+
+    // Rellena model.lods y model.lodIndices. Cada nivel intenta quedarse con la mitad de
+    // triángulos que el anterior; los niveles se simplifican en paralelo desde la malla base.
+    static void BuildLods(Model& model);
+
+    // Simplifica 'indices' (stride de 8 floats en 'vertices') hasta ~targetTriangles.
+    // Devuelve el error geométrico máximo introducido, en unidades del espacio local.
+    static float Simplify(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                          size_t targetTriangles, std::vector<unsigned int>& outIndices);
+};
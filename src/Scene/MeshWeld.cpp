@@ -0,0 +1,117 @@
+#include "MeshWeld.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    struct PositionKey {
+        uint32_t x, y, z;
+        bool operator==(const PositionKey& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& k) const {
+            size_t h = k.x * 73856093u;
+            h ^= k.y * 19349663u;
+            h ^= k.z * 83492791u;
+            return h;
+        }
+    };
+
+    struct VertexKey {
+        uint32_t x, y, z, u, v;
+        int32_t slot;
+        bool operator==(const VertexKey& o) const {
+            return x == o.x && y == o.y && z == o.z && u == o.u && v == o.v && slot == o.slot;
+        }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& k) const {
+            size_t h = PositionKeyHash()(PositionKey{ k.x, k.y, k.z });
+            h ^= k.u * 2654435761u;
+            h ^= k.v * 40503u;
+            h ^= static_cast<uint32_t>(k.slot) * 2246822519u;
+            return h;
+        }
+    };
+
+    const float NORMAL_COSINE = 0.99999f;
+}
+
+namespace Utils {
+    size_t weldPositions(const std::vector<float>& vertices, std::vector<unsigned int>& remap,
+                         std::vector<unsigned int>& representatives) {
+        size_t vertexCount = vertices.size() / 8;
+        remap.resize(vertexCount);
+        representatives.clear();
+
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> welded;
+        welded.reserve(vertexCount / 2);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            PositionKey key;
+            std::memcpy(&key.x, &vertices[v * 8 + 0], sizeof(float));
+            std::memcpy(&key.y, &vertices[v * 8 + 1], sizeof(float));
+            std::memcpy(&key.z, &vertices[v * 8 + 2], sizeof(float));
+
+            auto it = welded.find(key);
+            if (it == welded.end()) {
+                unsigned int id = static_cast<unsigned int>(representatives.size());
+                welded.emplace(key, id);
+                representatives.push_back(static_cast<unsigned int>(v));
+                remap[v] = id;
+            } else {
+                remap[v] = it->second;
+            }
+        }
+        return representatives.size();
+    }
+
+    size_t weldVertices(const std::vector<float>& vertices, const std::vector<int>& vertexSlots,
+                        std::vector<unsigned int>& remap) {
+        size_t vertexCount = vertices.size() / 8;
+        remap.resize(vertexCount);
+
+        // Por cada posición + UV + material, lista enlazada de vértices distintos que la usan
+        std::unordered_map<VertexKey, unsigned int, VertexKeyHash> heads;
+        heads.reserve(vertexCount / 2);
+        std::vector<unsigned int> representatives, nextSame;
+        for (size_t v = 0; v < vertexCount; ++v) {
+            const float* vertex = &vertices[v * 8];
+            VertexKey key;
+            std::memcpy(&key.x, vertex + 0, sizeof(float));
+            std::memcpy(&key.y, vertex + 1, sizeof(float));
+            std::memcpy(&key.z, vertex + 2, sizeof(float));
+            std::memcpy(&key.u, vertex + 6, sizeof(float));
+            std::memcpy(&key.v, vertex + 7, sizeof(float));
+            key.slot = vertexSlots.empty() ? 0 : vertexSlots[v];
+
+            unsigned int id = static_cast<unsigned int>(representatives.size());
+            auto inserted = heads.emplace(key, id);
+            if (!inserted.second) {
+                unsigned int candidate = inserted.first->second;
+                while (true) {
+                    const float* other = &vertices[representatives[candidate] * 8];
+                    float cosine = vertex[3] * other[3] + vertex[4] * other[4] + vertex[5] * other[5];
+                    if (cosine >= NORMAL_COSINE) break;
+                    if (nextSame[candidate] == UINT_MAX) {
+                        nextSame[candidate] = id;
+                        candidate = id;
+                        break;
+                    }
+                    candidate = nextSame[candidate];
+                }
+                if (candidate != id) {
+                    remap[v] = candidate;
+                    continue;
+                }
+            }
+            representatives.push_back(static_cast<unsigned int>(v));
+            nextSame.push_back(UINT_MAX);
+            remap[v] = id;
+        }
+        return representatives.size();
+    }
+}
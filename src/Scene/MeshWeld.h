@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Utils {
+    // Suelda los vértices (stride de 8 floats) que comparten posición exacta. Las normales son
+    // planas, así que es el único modo de recuperar la conectividad entre caras.
+    // 'remap' traduce cada vértice a su id soldado y 'representatives' guarda, por id, el primer
+    // vértice original con esa posición. Devuelve el número de posiciones únicas.
+    size_t weldPositions(const std::vector<float>& vertices, std::vector<unsigned int>& remap,
+                         std::vector<unsigned int>& representatives);
+
+    // Detecta los vértices repetidos: misma posición y UV exactas, mismo slot de material y
+    // normales que difieren menos de ~0.25º (las de caras coplanarias salen del producto
+    // vectorial con distinto redondeo). 'vertexSlots' da el slot de cada vértice (vacío si no
+    // hay materiales); así un vértice soldado nunca queda entre dos rangos de material.
+    // 'remap' traduce cada vértice al id del primero igual, numerados por orden de aparición.
+    // Devuelve cuántos vértices distintos hay.
+    size_t weldVertices(const std::vector<float>& vertices, const std::vector<int>& vertexSlots,
+                        std::vector<unsigned int>& remap);
+}
@@ -0,0 +1,205 @@
+#include "MeshletBuilder.h"
+#include "Model.h"
+#include "MeshWeld.h"
+#include "../Core/ThreadPool.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+namespace {
+    const float CONE_WEIGHT = 1.0f;      // Penaliza los candidatos cuya normal se aparta del eje del meshlet
+    const float MIN_CONE_COSINE = 0.1f;  // Con normales más abiertas (~84º) el cono no sirve para descartar
+    const size_t BOUNDS_GRAIN = 64;      // Meshlets por tarea al recalcular las esferas y conos
+
+    glm::vec3 VertexPosition(const Model& model, unsigned int index) {
+        return glm::vec3(model.vertices[index * 8 + 0], model.vertices[index * 8 + 1], model.vertices[index * 8 + 2]);
+    }
+
+    // Normal geométrica del triángulo 't' de model.indices (según el orden de los vértices,
+    // igual que el back-face culling); cero si es degenerado
+    glm::vec3 FaceNormal(const Model& model, size_t t) {
+        glm::vec3 p0 = VertexPosition(model, model.indices[t * 3 + 0]);
+        glm::vec3 p1 = VertexPosition(model, model.indices[t * 3 + 1]);
+        glm::vec3 p2 = VertexPosition(model, model.indices[t * 3 + 2]);
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(n);
+        return length > 0.0f ? n / length : glm::vec3(0.0f);
+    }
+
+    // Esfera (centrada en la AABB) y cono de normales de los triángulos del meshlet
+    void ComputeBounds(const Model& model, Meshlet& meshlet) {
+        size_t first = meshlet.firstIndex / 3;
+        size_t count = meshlet.indexCount / 3;
+        meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+
+        glm::vec3 minBounds(FLT_MAX), maxBounds(-FLT_MAX);
+        glm::vec3 normalSum(0.0f);
+        for (size_t t = first; t < first + count; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                glm::vec3 p = VertexPosition(model, model.indices[t * 3 + k]);
+                minBounds = glm::min(minBounds, p);
+                maxBounds = glm::max(maxBounds, p);
+            }
+            normalSum += FaceNormal(model, t);
+        }
+
+        meshlet.center = (minBounds + maxBounds) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (size_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; ++i) {
+            glm::vec3 d = VertexPosition(model, model.indices[i]) - meshlet.center;
+            radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+        }
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        float axisLength = glm::length(normalSum);
+        if (axisLength <= 0.0f) return; // Se queda con coneCutoff = 1 (nunca se descarta por orientación)
+        meshlet.coneAxis = normalSum / axisLength;
+
+        float minCosine = 1.0f;
+        for (size_t t = first; t < first + count; ++t) {
+            glm::vec3 n = FaceNormal(model, t);
+            if (n == glm::vec3(0.0f)) continue; // Triángulo degenerado
+            minCosine = std::min(minCosine, glm::dot(n, meshlet.coneAxis));
+        }
+        // El cluster queda de espaldas si dot(centro - cámara, eje) >= cutoff * |centro - cámara| + radio
+        meshlet.coneCutoff = minCosine <= MIN_CONE_COSINE ? 1.0f : std::sqrt(1.0f - minCosine * minCosine);
+    }
+}
+
+void MeshletBuilder::Build(Model& model) {
+    model.meshlets.clear();
+    size_t triangleCount = model.indices.size() / 3;
+    if (triangleCount < MIN_TRIANGLES) return;
+
+    std::vector<unsigned int> remap, representatives;
+    size_t weldedCount = Utils::weldPositions(model.vertices, remap, representatives);
+
+    // Centroide y normal geométrica (según el orden de los vértices, igual que el back-face culling)
+    std::vector<glm::vec3> centroids(triangleCount), faceNormals(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        glm::vec3 p0 = VertexPosition(model, model.indices[t * 3 + 0]);
+        glm::vec3 p1 = VertexPosition(model, model.indices[t * 3 + 1]);
+        glm::vec3 p2 = VertexPosition(model, model.indices[t * 3 + 2]);
+        centroids[t] = (p0 + p1 + p2) / 3.0f;
+        faceNormals[t] = FaceNormal(model, t);
+    }
+
+    // Triángulos que usa cada vértice soldado, en formato compacto (offsets + lista)
+    std::vector<unsigned int> offsets(weldedCount + 1, 0);
+    for (unsigned int index : model.indices) offsets[remap[index] + 1]++;
+    for (size_t v = 0; v < weldedCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<unsigned int> adjacency(model.indices.size());
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < model.indices.size(); ++i) {
+        adjacency[fill[remap[model.indices[i]]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    // Crecimiento voraz: desde una semilla se añade el vecino más cercano al centro del meshlet
+    // que menos abre su cono de normales, hasta llenar el meshlet o quedarse sin vecinos.
+    // Los meshlets no cruzan rangos de material, para que cada material de cada submalla siga
+    // siendo un rango contiguo y los meshlets visibles se puedan agrupar por material.
+    std::vector<char> assigned(triangleCount, 0);
+    std::vector<unsigned int> stamp(triangleCount, UINT_MAX); // Meshlet en cuya frontera ya está
+    std::vector<unsigned int> frontier;
+    std::vector<unsigned int> order;
+    order.reserve(triangleCount);
+
+    MaterialRange whole;
+    whole.indexCount = static_cast<unsigned int>(model.indices.size());
+    std::vector<MaterialRange*> ranges;
+    for (MaterialRange& range : model.materialRanges) ranges.push_back(&range);
+    if (ranges.empty()) ranges.push_back(&whole);
+
+    for (MaterialRange* range : ranges) {
+        size_t rangeBegin = range->firstIndex / 3;
+        size_t rangeEnd = rangeBegin + range->indexCount / 3;
+        range->firstMeshlet = static_cast<unsigned int>(model.meshlets.size());
+
+        size_t seed = rangeBegin;
+        while (true) {
+            while (seed < rangeEnd && assigned[seed]) seed++;
+            if (seed == rangeEnd) break;
+
+            unsigned int meshletId = static_cast<unsigned int>(model.meshlets.size());
+            Meshlet meshlet;
+            meshlet.firstIndex = static_cast<unsigned int>(order.size() * 3);
+
+            glm::vec3 centroidSum(0.0f), normalSum(0.0f);
+            size_t count = 0;
+            frontier.clear();
+            unsigned int next = static_cast<unsigned int>(seed);
+
+            while (true) {
+                assigned[next] = 1;
+                order.push_back(next);
+                centroidSum += centroids[next];
+                normalSum += faceNormals[next];
+                if (++count == MAX_TRIANGLES) break;
+
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int v = remap[model.indices[next * 3 + k]];
+                    for (unsigned int a = offsets[v]; a < offsets[v + 1]; ++a) {
+                        unsigned int neighbor = adjacency[a];
+                        if (neighbor < rangeBegin || neighbor >= rangeEnd) continue;
+                        if (assigned[neighbor] || stamp[neighbor] == meshletId) continue;
+                        stamp[neighbor] = meshletId;
+                        frontier.push_back(neighbor);
+                    }
+                }
+                if (frontier.empty()) break;
+
+                glm::vec3 center = centroidSum / static_cast<float>(count);
+                float axisLength = glm::length(normalSum);
+                glm::vec3 axis = axisLength > 0.0f ? normalSum / axisLength : glm::vec3(0.0f);
+
+                size_t best = 0;
+                float bestScore = FLT_MAX;
+                for (size_t f = 0; f < frontier.size(); ++f) {
+                    unsigned int candidate = frontier[f];
+                    float spread = 1.0f - glm::dot(faceNormals[candidate], axis);
+                    float score = glm::length(centroids[candidate] - center) * (1.0f + CONE_WEIGHT * spread);
+                    if (score < bestScore) { bestScore = score; best = f; }
+                }
+                next = frontier[best];
+                frontier[best] = frontier.back();
+                frontier.pop_back();
+            }
+
+            meshlet.indexCount = static_cast<unsigned int>(count * 3);
+            model.meshlets.push_back(meshlet);
+        }
+        range->meshletCount = static_cast<unsigned int>(model.meshlets.size()) - range->firstMeshlet;
+    }
+
+    // Los rangos de una submalla son consecutivos, así que sus meshlets también
+    for (Submesh& submesh : model.submeshes) {
+        submesh.firstMeshlet = static_cast<unsigned int>(model.meshlets.size());
+        submesh.meshletCount = 0;
+        if (submesh.rangeCount == 0) continue;
+        submesh.firstMeshlet = model.materialRanges[submesh.firstRange].firstMeshlet;
+        for (unsigned int r = submesh.firstRange; r < submesh.firstRange + submesh.rangeCount; ++r) {
+            submesh.meshletCount += model.materialRanges[r].meshletCount;
+        }
+    }
+
+    // Reordenar los índices para que cada meshlet sea un rango contiguo (los rangos de material
+    // se recorren en orden, así que sus límites no cambian)
+    std::vector<unsigned int> reordered;
+    reordered.reserve(model.indices.size());
+    for (unsigned int t : order) {
+        reordered.push_back(model.indices[t * 3 + 0]);
+        reordered.push_back(model.indices[t * 3 + 1]);
+        reordered.push_back(model.indices[t * 3 + 2]);
+    }
+    model.indices.swap(reordered);
+
+    for (Meshlet& meshlet : model.meshlets) ComputeBounds(model, meshlet);
+}
+
+void MeshletBuilder::RecomputeBounds(Model& model) {
+    ThreadPool::Get().ParallelFor(model.meshlets.size(), BOUNDS_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m) ComputeBounds(model, model.meshlets[m]);
+    });
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+class Model;
+
+// Divide el nivel 0 en meshlets de hasta MAX_TRIANGLES triángulos vecinos para poder descartar
+// partes de un modelo grande (fuera del frustum o de espaldas a la cámara) en vez de todo o nada.
+class MeshletBuilder {
+public:
+    static constexpr size_t MAX_TRIANGLES = 124;  // Dentro del rango 64-128 habitual
+    static constexpr size_t MIN_TRIANGLES = 512;  // Mallas más pequeñas se dibujan enteras
+
+    // Rellena model.meshlets (y el rango de meshlets de cada material y submalla) y reordena
+    // model.indices para que cada meshlet sea contiguo
+    static void Build(Model& model);
+    // Recalcula la esfera y el cono de cada meshlet a partir de los vértices actuales, sin
+    // tocar sus rangos (tras hornear una transformación los índices no cambian de orden)
+    static void RecomputeBounds(Model& model);
+};
@@ -1,299 +1,439 @@
 #include "Model.h"
-#include "../include/stb_image.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MaterialLibrary.h"
+#include "PositionStream.h"
+#include "../Graphics/TextureCodec.h"
+#include "../Graphics/VertexLayout.h"
+#include "../Core/ThreadPool.h"
+#include <cmath>
+#include <memory_resource>
 
-unsigned int TextureFromFile(const char* path, const std::string& directory);
 Model::Model() : VAO(0), VBO(0), EBO(0), 
                  color(0.7f, 0.7f, 0.7f), originalColor(0.7f, 0.7f, 0.7f), 
                  localMinBounds(0.0f), localMaxBounds(0.0f) {}
 
 void Model::setupModel() {
-    originalVertices = vertices;
+    // Los materiales equivalentes de otros modelos se comparten (y su textura solo se carga una
+    // vez). Van primero porque el tamaño de las texturas decide la precisión de las UV.
+    materialIds.clear();
+    hasTexture = false;
+    int maxTextureSize = 0;
+    for (MaterialDesc& desc : materialSlots) {
+        int id = MaterialLibrary::Acquire(desc);
+        materialIds.push_back(id);
+        if (MaterialLibrary::Get(id).texture.IsValid()) {
+            hasTexture = true;
+            if (desc.image) maxTextureSize = std::max(maxTextureSize, std::max(desc.image->contentWidth, desc.image->contentHeight));
+        }
+        desc.image.reset();
+    }
+    batches.assign(materialSlots.size(), MaterialBatch());
+
+    vertexFormat = Utils::chooseVertexFormat(vertices, hasTexture ? std::max(maxTextureSize, 1) : 0);
 
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
     glBindVertexArray(VAO);
+    uploadVertices();
+
+    // Malla completa seguida de todos los niveles de detalle en un único EBO, en 16 bits si
+    // todos los índices caben
+    size_t indexCount = indices.size() + lodIndices.size();
+    indexType = vertices.size() / 8 <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    if (indexType == GL_UNSIGNED_SHORT) {
+        std::vector<unsigned short> shortIndices;
+        shortIndices.reserve(indexCount);
+        shortIndices.insert(shortIndices.end(), indices.begin(), indices.end());
+        shortIndices.insert(shortIndices.end(), lodIndices.begin(), lodIndices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(unsigned short), shortIndices.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+        if (!lodIndices.empty()) {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), lodIndices.size() * sizeof(unsigned int), lodIndices.data());
+        }
+    }
+    gpuBytes = vertices.size() / 8 * Utils::vertexStride(vertexFormat) + indexCount * indexSize();
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    Utils::setupVertexAttributes(vertexFormat);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
 
-    GLsizei stride = 8 * sizeof(float);
+void Model::releaseGPU() {
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteVertexArrays(1, &VAO);
+    VAO = VBO = EBO = 0;
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
+    for (int id : materialIds) {
+        MaterialLibrary::Release(id);
+    }
+    materialIds.clear();
+    hasTexture = false;
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    releaseImpostor();
+}
 
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+void Model::releaseImpostor() {
+    if (impostorAlbedo != 0)  { glDeleteTextures(1, &impostorAlbedo);  impostorAlbedo = 0; }
+    if (impostorNormals != 0) { glDeleteTextures(1, &impostorNormals); impostorNormals = 0; }
+}
 
-    glBindVertexArray(0);
+void Model::uploadVertices() {
+    vertexDecode = Utils::computeVertexDecode(vertices, vertexFormat);
+    size_t stride = Utils::vertexStride(vertexFormat);
+    size_t vertexCount = vertices.size() / 8;
 
-    if (!textureToLoad.empty()) {
-        textureID = TextureFromFile(textureToLoad.c_str(), textureBaseDir);
-        hasTexture = true;
-        textureToLoad = "";
+    // Buffer nuevo (orphaning) para no esperar a los draws en vuelo que leen el anterior. Se
+    // empaqueta y sube por tramos desde un buffer intermedio fijo, sin copia completa en CPU
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * stride, nullptr, GL_STATIC_DRAW);
+    size_t chunkVertices = std::max<size_t>(1, UPLOAD_CHUNK_BYTES / stride);
+    std::vector<unsigned char> staging(std::min(vertexCount, chunkVertices) * stride);
+    for (size_t first = 0; first < vertexCount; first += chunkVertices) {
+        size_t count = std::min(chunkVertices, vertexCount - first);
+        Utils::packVertexRange(vertices, vertexFormat, vertexDecode, first, count, staging.data());
+        glBufferSubData(GL_ARRAY_BUFFER, first * stride, count * stride, staging.data());
     }
 }
 
-void Model::updateTransformMatrix() {
-    glm::mat4 mat = glm::mat4(1.0f);
-    mat = glm::translate(mat, position);
-    mat = glm::rotate(mat, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-    mat = glm::rotate(mat, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-    mat = glm::rotate(mat, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-    mat = glm::scale(mat, scale);
-    
-    this->transformMatrix = mat;
+void Model::computeSubmeshBounds() {
+    ThreadPool::Get().ParallelFor(submeshes.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            Submesh& submesh = submeshes[s];
+            submesh.minBounds = glm::vec3(FLT_MAX);
+            submesh.maxBounds = glm::vec3(-FLT_MAX);
+            for (unsigned int i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i) {
+                glm::vec3 pos(vertices[indices[i] * 8], vertices[indices[i] * 8 + 1], vertices[indices[i] * 8 + 2]);
+                submesh.minBounds = glm::min(submesh.minBounds, pos);
+                submesh.maxBounds = glm::max(submesh.maxBounds, pos);
+            }
+        }
+    });
 }
 
-void Model::applyTransformations() {    
-    for (size_t i = 0; i < originalVertices.size(); i += 8) {
-        glm::vec4 position(originalVertices[i], originalVertices[i+1], originalVertices[i+2], 1.0f);
-        position = transformMatrix * position;
-        vertices[i] = position.x;
-        vertices[i + 1] = position.y;
-        vertices[i + 2] = position.z;
-    }
-    position = glm::vec3(0.0f);
-    rotation = glm::vec3(0.0f);
-    scale = glm::vec3(1.0f);
-    updateTransformMatrix();
+void Model::applyTransformations(Transform& transform) {
+    // Se hornea sobre los vértices actuales para que hornear varias veces acumule las
+    // transformaciones
+    glm::mat4 matrix = Transform::Compose(transform.position, transform.rotation, transform.scale);
+    Utils::transformVertices(vertices.data(), vertices.data(), vertices.size() / 8, matrix, localMinBounds, localMaxBounds);
+    computeSubmeshBounds();
+
+    // El error de cada LOD está en unidades locales: crece con la mayor escala de la matriz
+    float maxScale = std::max(glm::length(glm::vec3(matrix[0])), std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+    for (LodLevel& lod : lods) lod.error *= maxScale;
+
+    transform.position = glm::vec3(0.0f);
+    transform.rotation = glm::vec3(0.0f);
+    transform.scale = glm::vec3(1.0f);
+    transform.MarkDirty();
+
+    // Mismo formato (la UV no cambia) con la nueva AABB de cuantización
+    if (VBO != 0) uploadVertices();
 
-    if (debugNormalsVAO != 0) { glDeleteVertexArrays(1, &debugNormalsVAO); debugNormalsVAO = 0; }
-    if (debugBoxVAO != 0)     { glDeleteVertexArrays(1, &debugBoxVAO);     debugBoxVAO = 0; }
+    releaseImpostor();
+
+    // Los rangos de los meshlets siguen valiendo; sus esferas y conos se rehacen con los
+    // vértices horneados
+    MeshletBuilder::RecomputeBounds(*this);
+    computeUvDensity();
 }
 
-void Model::draw(GLuint shaderProgram) const {
+void Model::draw(GLuint shaderProgram, const glm::mat4& worldMatrix) const {
     glUseProgram(shaderProgram);
 
     GLuint colorLoc = glGetUniformLocation(shaderProgram, "objectColor");
     glUniform3fv(colorLoc, 1, &color[0]);
 
     GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(transformMatrix));
+    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(worldMatrix));
+    Utils::applyVertexDecode(shaderProgram, vertexDecode);
 
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+    if (!materialRanges.empty()) {
+        for (size_t slot = 0; slot < batches.size(); ++slot) {
+            drawBatch(static_cast<int>(slot));
+        }
+        glBindVertexArray(0);
+        return;
+    }
+
+    size_t first = 0;
+    size_t count = indices.size();
+    if (activeLod > 0 && activeLod < static_cast<int>(lods.size())) {
+        first = lods[activeLod].firstIndex;
+        count = lods[activeLod].indexCount;
+    }
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count), indexType, indexOffset(first));
     glBindVertexArray(0);
 }
 
-void Model::Normalize(Model& model) {
-    glm::vec3 minBounds(std::numeric_limits<float>::max());
-    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+void Model::drawBatch(int slot) const {
+    const MaterialBatch& batch = batches[slot];
+    if (batch.counts.empty()) return;
+    glBindVertexArray(VAO);
+    glMultiDrawElements(GL_TRIANGLES, batch.counts.data(), indexType, batch.offsets.data(),
+                        static_cast<GLsizei>(batch.counts.size()));
+}
 
-    for (size_t i = 0; i < model.vertices.size(); i += 8) {
-        glm::vec3 pos(model.vertices[i], model.vertices[i + 1], model.vertices[i + 2]);
-        minBounds = glm::min(minBounds, pos);
-        maxBounds = glm::max(maxBounds, pos);
+void Model::clearBatches() {
+    if (batches.size() != materialSlots.size()) batches.assign(materialSlots.size(), MaterialBatch());
+    for (MaterialBatch& batch : batches) {
+        batch.counts.clear();
+        batch.offsets.clear();
+        batch.rangeEnd = 0;
     }
+}
 
-    glm::vec3 size = maxBounds - minBounds;
-    float scale = 1.0f / std::max(size.x, std::max(size.y, size.z)); 
-    glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+void Model::addToBatch(int slot, unsigned int firstIndex, unsigned int indexCount) {
+    MaterialBatch& batch = batches[slot];
+    if (!batch.counts.empty() && batch.rangeEnd == firstIndex) {
+        batch.counts.back() += static_cast<GLsizei>(indexCount);
+    } else {
+        batch.counts.push_back(static_cast<GLsizei>(indexCount));
+        batch.offsets.push_back(indexOffset(firstIndex));
+    }
+    batch.rangeEnd = firstIndex + indexCount;
+}
 
-    for (size_t i = 0; i < model.vertices.size(); i += 8) {
-        model.vertices[i + 0] = (model.vertices[i + 0] - center.x) * scale;
-        model.vertices[i + 1] = (model.vertices[i + 1] - center.y) * scale;
-        model.vertices[i + 2] = (model.vertices[i + 2] - center.z) * scale;
+void Model::collectBatches(int lod) {
+    clearBatches();
+    if (lod > 0 && lod < static_cast<int>(lods.size())) {
+        for (const MaterialRange& range : lods[lod].ranges) {
+            addToBatch(range.slot, range.firstIndex, range.indexCount);
+        }
+        return;
+    }
+    for (const Submesh& submesh : submeshes) {
+        if (!submesh.visible) continue;
+        for (unsigned int r = submesh.firstRange; r < submesh.firstRange + submesh.rangeCount; ++r) {
+            addToBatch(materialRanges[r].slot, materialRanges[r].firstIndex, materialRanges[r].indexCount);
+        }
     }
 }
 
-unsigned int TextureFromFile(const char* path, const std::string& directory) {
-    std::string filename = std::string(path);
-    filename = directory + filename;
-
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    stbi_set_flip_vertically_on_load(true);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-        else format = GL_RGB;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data); 
-        std::cout << "Textura cargada correctamente: " << filename << std::endl;
-    } else {
-        std::cout << "No se pudo cargar la textura (¿Esta en la misma carpeta?): " << filename << std::endl;
-        stbi_image_free(data);
+glm::vec3 Model::slotColor(const glm::vec3& materialDiffuse) const {
+    return color != originalColor ? color : materialDiffuse;
+}
+
+size_t Model::getTriangleCount(int lod) const {
+    if (lod > 0 && lod < static_cast<int>(lods.size())) return lods[lod].indexCount / 3;
+    return indices.size() / 3;
+}
+
+bool Model::hasHiddenSubmeshes() const {
+    for (const Submesh& submesh : submeshes) {
+        if (!submesh.visible) return true;
     }
+    return false;
+}
 
-    return textureID;
+void Model::computeUvDensity() {
+    std::vector<double> surface(materialSlots.size(), 0.0), uvSurface(materialSlots.size(), 0.0);
+    for (const MaterialRange& range : materialRanges) {
+        for (unsigned int i = range.firstIndex; i + 2 < range.firstIndex + range.indexCount; i += 3) {
+            const float* a = &vertices[indices[i] * 8];
+            const float* b = &vertices[indices[i + 1] * 8];
+            const float* c = &vertices[indices[i + 2] * 8];
+            glm::vec3 edge1(b[0] - a[0], b[1] - a[1], b[2] - a[2]);
+            glm::vec3 edge2(c[0] - a[0], c[1] - a[1], c[2] - a[2]);
+            glm::vec2 uv1(b[6] - a[6], b[7] - a[7]);
+            glm::vec2 uv2(c[6] - a[6], c[7] - a[7]);
+            surface[range.slot] += glm::length(glm::cross(edge1, edge2));
+            uvSurface[range.slot] += std::abs(uv1.x * uv2.y - uv1.y * uv2.x);
+        }
+    }
+    for (size_t slot = 0; slot < materialSlots.size(); ++slot) {
+        materialSlots[slot].uvDensity = surface[slot] > 0.0 ? static_cast<float>(std::sqrt(uvSurface[slot] / surface[slot])) : 0.0f;
+    }
+}
+
+void Model::Normalize(Model& model) {
+    Utils::normalizePositions(model.vertices.data(), model.vertices.size() / 8, model.localMinBounds, model.localMaxBounds);
 }
 
 Model Model::Process(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes, const std::vector<tinyobj::material_t>& materials, const std::string& baseDir, bool normalize) {
     Model model;
-    
-    for (const auto& shape : shapes) {
-        for (size_t i = 0; i < shape.mesh.indices.size(); i += 3) {
-            tinyobj::index_t idx0 = shape.mesh.indices[i + 0];
-            tinyobj::index_t idx1 = shape.mesh.indices[i + 1];
-            tinyobj::index_t idx2 = shape.mesh.indices[i + 2];
-
-            tinyobj::index_t current_indices[] = {idx0, idx1, idx2};
-
-            glm::vec3 v0(attrib.vertices[3 * idx0.vertex_index + 0], attrib.vertices[3 * idx0.vertex_index + 1], attrib.vertices[3 * idx0.vertex_index + 2]);
-            glm::vec3 v1(attrib.vertices[3 * idx1.vertex_index + 0], attrib.vertices[3 * idx1.vertex_index + 1], attrib.vertices[3 * idx1.vertex_index + 2]);
-            glm::vec3 v2(attrib.vertices[3 * idx2.vertex_index + 0], attrib.vertices[3 * idx2.vertex_index + 1], attrib.vertices[3 * idx2.vertex_index + 2]);
-
-            glm::vec3 edge1 = v1 - v0;
-            glm::vec3 edge2 = v2 - v0;
-            glm::vec3 triangleNormal = glm::normalize(glm::cross(edge1, edge2));
-
-            glm::vec3 vertices[] = {v0, v1, v2};
-            
-            for (int j = 0; j < 3; ++j) {
-                // 1. Posición
-                model.vertices.push_back(vertices[j].x);
-                model.vertices.push_back(vertices[j].y);
-                model.vertices.push_back(vertices[j].z);
-                
-                // 2. Normales
-                model.vertices.push_back(triangleNormal.x);
-                model.vertices.push_back(triangleNormal.y);
-                model.vertices.push_back(triangleNormal.z);
-
-                // 3. Texturas (NUEVO)
-                tinyobj::index_t idx = current_indices[j];
-                if (idx.texcoord_index >= 0) {
-                    model.vertices.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
-                    model.vertices.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
-                } else {
-                    model.vertices.push_back(0.0f);
-                    model.vertices.push_back(0.0f);
-                }
 
-                model.indices.push_back(static_cast<unsigned int>(model.indices.size()));
+    // Los materiales del .mtl se asignan a slots locales solo cuando alguna cara los usa;
+    // las caras sin material (id -1) comparten un slot gris por defecto
+    std::vector<int> slotOfMaterial(materials.size() + 1, -1);
+    auto slotFor = [&](int materialId) {
+        if (materialId < 0 || materialId >= static_cast<int>(materials.size())) materialId = -1;
+        int& slot = slotOfMaterial[materialId + 1];
+        if (slot == -1) {
+            MaterialDesc desc;
+            if (materialId == -1) {
+                desc.name = "(por defecto)";
+            } else {
+                const tinyobj::material_t& material = materials[materialId];
+                desc.name = material.name;
+                desc.diffuse = glm::vec3(material.diffuse[0], material.diffuse[1], material.diffuse[2]);
+                if (!material.diffuse_texname.empty()) desc.texturePath = baseDir + material.diffuse_texname;
             }
+            slot = static_cast<int>(model.materialSlots.size());
+            model.materialSlots.push_back(desc);
         }
-    }
+        return slot;
+    };
+
+    {
+        // Temporales de la carga en una arena que se libera de una vez al salir del bloque
+        std::pmr::monotonic_buffer_resource arena;
+
+        // 1. Conteo: triángulos por shape y su suma prefija, que da a cada shape su tramo de
+        //    'vertices' e 'indices'. Los slots se asignan aquí, en serie, porque dependen del
+        //    orden en que aparecen los materiales.
+        size_t shapeCount = shapes.size();
+        std::pmr::vector<size_t> firstTriangle(shapeCount + 1, 0, &arena);
+        for (size_t s = 0; s < shapeCount; ++s) {
+            firstTriangle[s + 1] = firstTriangle[s] + shapes[s].mesh.indices.size() / 3;
+        }
+        size_t triangleCount = firstTriangle[shapeCount];
 
-    if (!materials.empty()) {
-        model.color = glm::vec3(materials[0].diffuse[0], materials[0].diffuse[1], materials[0].diffuse[2]);
-        model.originalColor = model.color;
-        if (!materials[0].diffuse_texname.empty()) {
-            model.textureToLoad = materials[0].diffuse_texname;
-            model.textureBaseDir = baseDir;
+        std::pmr::vector<int> faceSlots(triangleCount, &arena);
+        for (size_t s = 0; s < shapeCount; ++s) {
+            const tinyobj::mesh_t& mesh = shapes[s].mesh;
+            for (size_t f = 0; f < firstTriangle[s + 1] - firstTriangle[s]; ++f) {
+                faceSlots[firstTriangle[s] + f] = slotFor(f < mesh.material_ids.size() ? mesh.material_ids[f] : -1);
+            }
+        }
+        model.vertices.resize(triangleCount * 3 * 8);
+        model.indices.resize(triangleCount * 3);
+
+        // 2. Las caras de cada shape se ordenan (de forma estable) por material, así cada material
+        //    de la shape queda en un rango contiguo y se dibuja con una sola llamada. Counting
+        //    sort por shape, en paralelo: 'faceOrder' guarda la cara local de cada posición.
+        std::pmr::vector<unsigned int> faceOrder(triangleCount, &arena);
+        size_t slotCount = model.materialSlots.size();
+        ThreadPool::Get().ParallelFor(shapeCount, 1, [&](size_t begin, size_t end) {
+            std::vector<size_t> slotStart(slotCount + 1);
+            for (size_t s = begin; s < end; ++s) {
+                size_t first = firstTriangle[s], count = firstTriangle[s + 1] - first;
+                std::fill(slotStart.begin(), slotStart.end(), 0);
+                for (size_t f = 0; f < count; ++f) slotStart[faceSlots[first + f] + 1]++;
+                for (size_t slot = 0; slot < slotCount; ++slot) slotStart[slot + 1] += slotStart[slot];
+                for (size_t f = 0; f < count; ++f) {
+                    faceOrder[first + slotStart[faceSlots[first + f]]++] = static_cast<unsigned int>(f);
+                }
+            }
+        });
+
+        // 3. Cada triángulo conoce ya su destino: se emiten en paralelo por bloques, aunque el
+        //    modelo sea una sola shape enorme
+        MeshVertex* meshVertices = reinterpret_cast<MeshVertex*>(model.vertices.data());
+        ThreadPool::Get().ParallelFor(triangleCount, 4096, [&](size_t begin, size_t end) {
+            size_t s = std::upper_bound(firstTriangle.begin(), firstTriangle.end(), begin) - firstTriangle.begin() - 1;
+            for (size_t t = begin; t < end; ++t) {
+                while (t >= firstTriangle[s + 1]) s++;
+                const tinyobj::mesh_t& mesh = shapes[s].mesh;
+                size_t i = static_cast<size_t>(faceOrder[t]) * 3;
+
+                glm::vec3 positions[3];
+                for (int j = 0; j < 3; ++j) {
+                    int vertexIndex = mesh.indices[i + j].vertex_index;
+                    positions[j] = glm::vec3(attrib.vertices[3 * vertexIndex + 0], attrib.vertices[3 * vertexIndex + 1], attrib.vertices[3 * vertexIndex + 2]);
+                }
+                glm::vec3 triangleNormal = glm::normalize(glm::cross(positions[1] - positions[0], positions[2] - positions[0]));
+
+                for (int j = 0; j < 3; ++j) {
+                    MeshVertex vertex = { positions[j], triangleNormal, glm::vec2(0.0f) };
+                    int texcoordIndex = mesh.indices[i + j].texcoord_index;
+                    if (texcoordIndex >= 0) {
+                        vertex.uv = glm::vec2(attrib.texcoords[2 * texcoordIndex + 0], attrib.texcoords[2 * texcoordIndex + 1]);
+                    }
+                    meshVertices[t * 3 + j] = vertex;
+                    model.indices[t * 3 + j] = static_cast<unsigned int>(t * 3 + j);
+                }
+            }
+        });
+
+        // 4. Submallas y rangos de material, recorriendo los slots en el orden ya emitido
+        for (size_t s = 0; s < shapeCount; ++s) {
+            size_t first = firstTriangle[s], end = firstTriangle[s + 1];
+            if (first == end) continue; // Shapes solo de líneas o puntos
+
+            Submesh submesh;
+            submesh.name = shapes[s].name.empty() ? "Submalla " + std::to_string(model.submeshes.size()) : shapes[s].name;
+            submesh.firstIndex = static_cast<unsigned int>(first * 3);
+            submesh.indexCount = static_cast<unsigned int>((end - first) * 3);
+            submesh.firstRange = static_cast<unsigned int>(model.materialRanges.size());
+            for (size_t t = first; t < end; ++t) {
+                int slot = faceSlots[first + faceOrder[t]];
+                if (model.materialRanges.size() == submesh.firstRange || model.materialRanges.back().slot != slot) {
+                    MaterialRange range;
+                    range.firstIndex = static_cast<unsigned int>(t * 3);
+                    range.slot = slot;
+                    model.materialRanges.push_back(range);
+                }
+                model.materialRanges.back().indexCount += 3;
+            }
+            submesh.rangeCount = static_cast<unsigned int>(model.materialRanges.size()) - submesh.firstRange;
+
+            // Para el inspector se guarda el material que cubre más caras de la shape
+            unsigned int mostUsed = 0;
+            for (unsigned int r = submesh.firstRange; r < submesh.firstRange + submesh.rangeCount; ++r) {
+                if (model.materialRanges[r].indexCount > mostUsed) {
+                    mostUsed = model.materialRanges[r].indexCount;
+                    submesh.materialId = model.materialRanges[r].slot;
+                }
+            }
+            model.submeshes.push_back(submesh);
         }
-    } else {
-        model.color = glm::vec3(0.7f, 0.7f, 0.7f);
-        model.originalColor = model.color;
     }
 
-    if (normalize) {
-        Model::Normalize(model);
-    }  
-
-    glm::vec3 minBounds(FLT_MAX);
-    glm::vec3 maxBounds(-FLT_MAX);
-    
-    for (size_t i = 0; i < model.vertices.size(); i += 8) {
-        glm::vec3 pos(model.vertices[i], model.vertices[i + 1], model.vertices[i + 2]);
-        minBounds = glm::min(minBounds, pos);
-        maxBounds = glm::max(maxBounds, pos);
+    // Las texturas se decodifican y comprimen aquí, en el hilo de carga, una vez por ruta
+    std::vector<size_t> textureSlots;
+    for (size_t slot = 0; slot < model.materialSlots.size(); ++slot) {
+        const std::string& path = model.materialSlots[slot].texturePath;
+        if (path.empty()) continue;
+        bool repeated = std::any_of(textureSlots.begin(), textureSlots.end(), [&](size_t other) { return model.materialSlots[other].texturePath == path; });
+        if (!repeated) textureSlots.push_back(slot);
     }
-    model.localMinBounds = minBounds;
-    model.localMaxBounds = maxBounds;
-    
-    return model;
-}
-
-void Model::drawDebugNormals(GLuint shaderProgram, const glm::vec3& color) {
-    if (debugNormalsVAO == 0) {
-        std::vector<float> normalLines;
-        for (size_t i = 0; i < vertices.size(); i += 8) {
-            glm::vec3 pos(vertices[i], vertices[i + 1], vertices[i + 2]);
-            glm::vec3 norm(vertices[i + 3], vertices[i + 4], vertices[i + 5]);
-            
-            normalLines.push_back(pos.x);
-            normalLines.push_back(pos.y);
-            normalLines.push_back(pos.z);
-            
-            glm::vec3 endPos = pos + norm * 0.1f;
-            normalLines.push_back(endPos.x);
-            normalLines.push_back(endPos.y);
-            normalLines.push_back(endPos.z);
+    std::vector<std::string> texturePaths;
+    for (size_t slot : textureSlots) texturePaths.push_back(model.materialSlots[slot].texturePath);
+    int maxTextureSize = TextureCodec::FitToBudget(texturePaths);
+    ThreadPool::Get().ParallelFor(textureSlots.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            MaterialDesc& desc = model.materialSlots[textureSlots[t]];
+            desc.image = TextureCodec::Prepare(desc.texturePath, maxTextureSize);
+        }
+    });
+    for (MaterialDesc& desc : model.materialSlots) {
+        if (desc.image || desc.texturePath.empty()) continue;
+        for (size_t slot : textureSlots) {
+            if (model.materialSlots[slot].texturePath == desc.texturePath) desc.image = model.materialSlots[slot].image;
         }
-
-        glGenVertexArrays(1, &debugNormalsVAO);
-        glGenBuffers(1, &debugNormalsVBO);
-        glBindVertexArray(debugNormalsVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, debugNormalsVBO);
-        glBufferData(GL_ARRAY_BUFFER, normalLines.size() * sizeof(float), normalLines.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        glBindVertexArray(0);
     }
 
-    glBindVertexArray(debugNormalsVAO);
-    glUniform1i(glGetUniformLocation(shaderProgram, "useNormalsColor"), true);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "normalsColor"), 1, glm::value_ptr(color));
-
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size() / 8 * 2));
-
-    glBindVertexArray(0);
-    glUniform1i(glGetUniformLocation(shaderProgram, "useNormalsColor"), false);
-}
+    // El color del modelo solo se usa sin material propio (luces, alambre) o como sobrescritura
+    model.color = model.materialSlots.empty() ? glm::vec3(0.7f, 0.7f, 0.7f) : model.materialSlots[0].diffuse;
+    model.originalColor = model.color;
 
-void Model::drawDebugBoundingBox(GLuint shaderProgram, const glm::vec3& color) {
-    if (debugBoxVAO == 0) {
-        glm::vec3 min = localMinBounds;
-        glm::vec3 max = localMaxBounds;
-
-        std::vector<glm::vec3> lines = {
-            {min.x, min.y, min.z}, {max.x, min.y, min.z}, // Base
-            {max.x, min.y, min.z}, {max.x, min.y, max.z},
-            {max.x, min.y, max.z}, {min.x, min.y, max.z},
-            {min.x, min.y, max.z}, {min.x, min.y, min.z},
-            
-            {min.x, max.y, min.z}, {max.x, max.y, min.z}, // Tope
-            {max.x, max.y, min.z}, {max.x, max.y, max.z},
-            {max.x, max.y, max.z}, {min.x, max.y, max.z},
-            {min.x, max.y, max.z}, {min.x, max.y, min.z},
-            
-            {min.x, min.y, min.z}, {min.x, max.y, min.z}, // Columnas
-            {max.x, min.y, min.z}, {max.x, max.y, min.z},
-            {max.x, min.y, max.z}, {max.x, max.y, max.z},
-            {min.x, min.y, max.z}, {min.x, max.y, max.z}
-        };
-
-        glGenVertexArrays(1, &debugBoxVAO);
-        glGenBuffers(1, &debugBoxVBO);
-        glBindVertexArray(debugBoxVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, debugBoxVBO);
-        glBufferData(GL_ARRAY_BUFFER, lines.size() * sizeof(glm::vec3), lines.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-        glEnableVertexAttribArray(0);
-        glBindVertexArray(0);
+    // Una pasada de lectura para la AABB y, si se normaliza, otra que reescala y mide la final
+    Utils::positionBounds(model.vertices.data(), model.vertices.size() / 8, model.localMinBounds, model.localMaxBounds);
+    if (normalize) {
+        Model::Normalize(model);
     }
-
-    glUseProgram(shaderProgram);
-    glBindVertexArray(debugBoxVAO);
+    model.computeUvDensity();
+
+    model.computeSubmeshBounds();
+
+    // Se ejecuta en el hilo de carga: meshlets y cadena de LOD llegan listos al hilo principal.
+    // Los meshlets reordenan 'indices' dentro de cada rango de material, por eso se construyen
+    // primero; el optimizador ordena los triángulos dentro de cada meshlet y renumera los
+    // vértices, y los LOD, que heredan el material de cada vértice a partir de esos rangos, ya
+    // se generan sobre la numeración final.
+    MeshletBuilder::Build(model);
+    MeshOptimizer::Optimize(model);
+    MeshSimplifier::BuildLods(model);
     
-    glUniform1i(glGetUniformLocation(shaderProgram, "useBoundingBoxColor"), true);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "boundingBoxColor"), 1, glm::value_ptr(color));
-   
-    glDrawArrays(GL_LINES, 0, 24);
-
-    glBindVertexArray(0);
-    glUniform1i(glGetUniformLocation(shaderProgram, "useBoundingBoxColor"), false);
-}
\ No newline at end of file
+    return model;
+}
@@ -9,48 +9,169 @@
 #include <iostream>
 #include <limits>
 #include <algorithm> 
+#include <memory>
 
 #include <tinyfiledialogs.h> 
 #include "tiny_obj_loader.h" 
+#include "Transform.h"
+#include "../Graphics/VertexFormat.h"
+
+struct TextureImage;
+
+// Material tal como viene del .mtl; al subir el modelo se registra en MaterialLibrary
+struct MaterialDesc {
+    std::string name;
+    glm::vec3 diffuse = glm::vec3(0.7f);
+    std::string texturePath; // Ruta completa de la textura difusa, vacía si no tiene
+    std::shared_ptr<const TextureImage> image; // Textura ya comprimida en el hilo de carga; se suelta al subirla
+    float uvDensity = 0.0f;  // Unidades de UV por unidad local (raíz del cociente de áreas), para el streaming
+};
+
+// Caras consecutivas (dentro del EBO) que comparten material
+struct MaterialRange {
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    int slot = 0;                  // Índice en Model::materialSlots
+    unsigned int firstMeshlet = 0;
+    unsigned int meshletCount = 0;
+};
+
+// Rangos de un material que se dibujan este frame con un único glMultiDrawElements
+struct MaterialBatch {
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    unsigned int rangeEnd = 0; // Fin del último rango añadido, para fusionar los contiguos
+};
+
+// Rango de un nivel de detalle dentro del EBO del modelo
+struct LodLevel {
+    size_t firstIndex = 0;
+    size_t indexCount = 0;
+    float error = 0.0f; // Error geométrico máximo respecto a la malla completa (espacio local)
+    std::vector<MaterialRange> ranges; // Triángulos del nivel agrupados por material
+};
+
+// Shape (g/o) del OBJ original: rango propio dentro de 'indices' con su AABB local y sus
+// rangos de material, para poder descartarla, seleccionarla u ocultarla por separado
+struct Submesh {
+    std::string name;
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    glm::vec3 minBounds = glm::vec3(0.0f);
+    glm::vec3 maxBounds = glm::vec3(0.0f);
+    int materialId = -1;          // Slot del material que cubre más caras
+    unsigned int firstRange = 0;  // Rangos de material en Model::materialRanges
+    unsigned int rangeCount = 0;
+    unsigned int firstMeshlet = 0;
+    unsigned int meshletCount = 0;
+    bool visible = true;          // Ocultada desde el inspector
+};
+
+// Grupo de triángulos contiguos en 'indices' con su esfera envolvente y su cono de normales
+// (espacio local). coneCutoff = 1 significa que las normales están demasiado abiertas para
+// descartar el cluster por orientación.
+struct Meshlet {
+    unsigned int firstIndex = 0;
+    unsigned int indexCount = 0;
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+    glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    float coneCutoff = 1.0f;
+};
+
+// Eficiencia de la caché post-transformación del nivel 0 antes y después de MeshOptimizer:
+// ACMR = vértices transformados por triángulo, ATVR = por vértice distinto (1 es el óptimo)
+struct VertexCacheStats {
+    float acmrBefore = 0.0f;
+    float acmrAfter = 0.0f;
+    float atvrBefore = 0.0f;
+    float atvrAfter = 0.0f;
+};
 
 class Model {
 public:
     GLuint VAO, VBO, EBO;
     std::vector<float> vertices;
-    std::vector<float> originalVertices;
     std::vector<unsigned int> indices;
 
-    glm::vec3 position = glm::vec3(0.0f);
-    glm::vec3 rotation = glm::vec3(0.0f); 
-    glm::vec3 scale    = glm::vec3(1.0f);
-    glm::mat4 transformMatrix = glm::mat4(1.0f);
+    // Cadena de LOD: lods[0] es la malla completa ('indices'); los demás niveles viven en
+    // 'lodIndices', que se sube al EBO a continuación de 'indices'
+    std::vector<unsigned int> lodIndices;
+    std::vector<LodLevel> lods;
+    int activeLod = 0; // Nivel elegido este frame según el error proyectado en pantalla
+
+    // Submallas, materiales y meshlets del nivel 0. 'indices' está ordenado por submalla, dentro
+    // de cada una por material y dentro de cada material por meshlet, de modo que todos son
+    // rangos contiguos del EBO.
+    std::vector<Submesh> submeshes;
+    std::vector<MaterialDesc> materialSlots;   // Materiales que usa el modelo
+    std::vector<int> materialIds;              // Slot -> id en MaterialLibrary (tras setupModel)
+    std::vector<MaterialRange> materialRanges;
+    std::vector<Meshlet> meshlets;
+    VertexCacheStats vertexCache;
+
+    // Rangos a dibujar este frame, uno por slot de material (ver collectBatches y cullClusters)
+    std::vector<MaterialBatch> batches;
 
     glm::vec3 color;
     glm::vec3 originalColor;
+    float lightRadius = 5.0f; // Solo luces: alcance como luz puntual (la principal no tiene)
     glm::vec3 localMinBounds;
     glm::vec3 localMaxBounds;
 
     Model();
     std::string path;
-    bool isLight = false;
 
-    unsigned int textureID = 0;
-    bool hasTexture = false;
+    bool hasTexture = false; // Algún material del modelo tiene textura
 
-    std::string textureToLoad = "";
-    std::string textureBaseDir = "";
+    // Formato en GPU, elegido en setupModel: 'vertices' sigue en float en CPU
+    VertexFormat vertexFormat = VertexFormat::Float;
+    VertexDecode vertexDecode;
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT si todos los vértices caben en 16 bits
+    size_t gpuBytes = 0;                // VBO + EBO
+    static constexpr size_t UPLOAD_CHUNK_BYTES = 4 << 20;
 
-    GLuint debugNormalsVAO = 0, debugNormalsVBO = 0;
-    GLuint debugBoxVAO = 0, debugBoxVBO = 0;
+    size_t indexSize() const { return indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int); }
+    // Desplazamiento en el EBO del índice 'first', listo para glDrawElements
+    const void* indexOffset(size_t first) const { return reinterpret_cast<const void*>(first * indexSize()); }
 
+    // Atlas del impostor (albedo y normales locales); 0 hasta que se captura por primera vez
+    GLuint impostorAlbedo = 0, impostorNormals = 0;
+
+    // Registra los materiales en MaterialLibrary y sube la geometría en el formato más compacto
+    // que admite el modelo (hilo principal)
     void setupModel();
-    void updateTransformMatrix();
-    void applyTransformations();
-    void draw(GLuint shaderProgram) const;
+    // Libera VAO/VBO/EBO, sus materiales y el impostor
+    void releaseGPU();
+    // Descarta el atlas del impostor para que se vuelva a capturar
+    void releaseImpostor();
+    // Hornea la transformación en los vértices (posiciones, normales, AABB y submallas, en
+    // paralelo con SSE2), la deja como identidad y vuelve a subir el VBO
+    void applyTransformations(Transform& transform);
+    // Empaqueta 'vertices' en vertexFormat y los sube al VBO por tramos de UPLOAD_CHUNK_BYTES
+    void uploadVertices();
+    void computeSubmeshBounds();
+    // Dibuja la geometría de todos los lotes del frame sin cambiar de material (capas de
+    // alambre y vértices, luces). Los modelos sin materiales dibujan el nivel activo entero.
+    void draw(GLuint shaderProgram, const glm::mat4& worldMatrix) const;
+    // Dibuja los rangos del frame de un único slot de material
+    void drawBatch(int slot) const;
+
+    void clearBatches();
+    void addToBatch(int slot, unsigned int firstIndex, unsigned int indexCount);
+    // Rellena los lotes con los rangos del nivel 'lod' sin culling por submalla ni meshlet
+    // (en el nivel 0 se saltan las submallas ocultas)
+    void collectBatches(int lod);
+    // Color con el que se dibuja un slot: el del material, salvo que se haya cambiado el del modelo
+    glm::vec3 slotColor(const glm::vec3& materialDiffuse) const;
+    size_t getTriangleCount(int lod) const;
+    // Los LOD simplifican el modelo entero, así que ocultar una submalla obliga a usar el nivel 0
+    bool hasHiddenSubmeshes() const;
+    // Recalcula la densidad de UV de cada slot a partir de los vértices actuales
+    void computeUvDensity();
 
     static Model Process(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes, const std::vector<tinyobj::material_t>& materials, const std::string& baseDir, bool normalize);
+    // Centra el modelo y lo escala a tamaño 1. Parte de localMin/MaxBounds, que deben estar al
+    // día, y los deja con la AABB ya normalizada
     static void Normalize(Model& model);
-
-    void drawDebugNormals(GLuint shaderProgram, const glm::vec3& color);
-    void drawDebugBoundingBox(GLuint shaderProgram, const glm::vec3& color);
 };
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "PositionStream.h"
+#include "../Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POSITION_STREAM_SSE2 1
+#endif
+
+namespace {
+    const size_t VERTICES_PER_JOB = 16384;
+
+    struct BlockBounds {
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+    };
+
+#ifdef POSITION_STREAM_SSE2
+    glm::vec3 ToVec3(__m128 v) {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, v);
+        return glm::vec3(lanes[0], lanes[1], lanes[2]);
+    }
+#endif
+
+    void BoundsRange(const float* vertices, size_t begin, size_t end, BlockBounds& bounds) {
+#ifdef POSITION_STREAM_SSE2
+        // Dos acumuladores para no encadenar cada min/max con el anterior
+        __m128 min0 = _mm_set1_ps(FLT_MAX), min1 = min0;
+        __m128 max0 = _mm_set1_ps(-FLT_MAX), max1 = max0;
+        size_t v = begin;
+        for (; v + 1 < end; v += 2) {
+            __m128 p0 = _mm_loadu_ps(vertices + v * 8);
+            __m128 p1 = _mm_loadu_ps(vertices + v * 8 + 8);
+            min0 = _mm_min_ps(min0, p0); max0 = _mm_max_ps(max0, p0);
+            min1 = _mm_min_ps(min1, p1); max1 = _mm_max_ps(max1, p1);
+        }
+        if (v < end) {
+            __m128 p = _mm_loadu_ps(vertices + v * 8);
+            min0 = _mm_min_ps(min0, p); max0 = _mm_max_ps(max0, p);
+        }
+        bounds.min = ToVec3(_mm_min_ps(min0, min1));
+        bounds.max = ToVec3(_mm_max_ps(max0, max1));
+#else
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 p(vertices[v * 8], vertices[v * 8 + 1], vertices[v * 8 + 2]);
+            bounds.min = glm::min(bounds.min, p);
+            bounds.max = glm::max(bounds.max, p);
+        }
+#endif
+    }
+
+    // (p - center) * scale sobre las posiciones de [begin, end), midiendo la AABB escrita
+    void NormalizeRange(float* vertices, size_t begin, size_t end, const glm::vec3& center, float scale, BlockBounds& bounds) {
+#ifdef POSITION_STREAM_SSE2
+        // El cuarto canal (x de la normal) pasa intacto: (nx - 0) * 1
+        __m128 offset = _mm_setr_ps(center.x, center.y, center.z, 0.0f);
+        __m128 factor = _mm_setr_ps(scale, scale, scale, 1.0f);
+        __m128 minBounds = _mm_set1_ps(FLT_MAX), maxBounds = _mm_set1_ps(-FLT_MAX);
+        for (size_t v = begin; v < end; ++v) {
+            float* p = vertices + v * 8;
+            __m128 r = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p), offset), factor);
+            _mm_storeu_ps(p, r);
+            minBounds = _mm_min_ps(minBounds, r);
+            maxBounds = _mm_max_ps(maxBounds, r);
+        }
+        bounds.min = ToVec3(minBounds);
+        bounds.max = ToVec3(maxBounds);
+#else
+        for (size_t v = begin; v < end; ++v) {
+            float* p = vertices + v * 8;
+            glm::vec3 r = (glm::vec3(p[0], p[1], p[2]) - center) * scale;
+            p[0] = r.x; p[1] = r.y; p[2] = r.z;
+            bounds.min = glm::min(bounds.min, r);
+            bounds.max = glm::max(bounds.max, r);
+        }
+#endif
+    }
+
+    void TransformRange(const float* src, float* dst, size_t begin, size_t end, const glm::mat4& matrix,
+                        const glm::mat3& normalMatrix, BlockBounds& bounds) {
+#ifdef POSITION_STREAM_SSE2
+        __m128 p0 = _mm_loadu_ps(&matrix[0][0]), p1 = _mm_loadu_ps(&matrix[1][0]);
+        __m128 p2 = _mm_loadu_ps(&matrix[2][0]), p3 = _mm_loadu_ps(&matrix[3][0]);
+        __m128 n0 = _mm_setr_ps(normalMatrix[0][0], normalMatrix[0][1], normalMatrix[0][2], 0.0f);
+        __m128 n1 = _mm_setr_ps(normalMatrix[1][0], normalMatrix[1][1], normalMatrix[1][2], 0.0f);
+        __m128 n2 = _mm_setr_ps(normalMatrix[2][0], normalMatrix[2][1], normalMatrix[2][2], 0.0f);
+        __m128 minBounds = _mm_set1_ps(FLT_MAX), maxBounds = _mm_set1_ps(-FLT_MAX);
+        for (size_t v = begin; v < end; ++v) {
+            const float* in = src + v * 8;
+            __m128 a = _mm_loadu_ps(in);     // x, y, z, nx
+            __m128 b = _mm_loadu_ps(in + 4); // ny, nz, u, v
+
+            __m128 position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0))),
+                                                    _mm_mul_ps(p1, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)))),
+                                         _mm_add_ps(_mm_mul_ps(p2, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2))), p3));
+            __m128 normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n0, _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3))),
+                                                  _mm_mul_ps(n1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)))),
+                                       _mm_mul_ps(n2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1))));
+            __m128 squared = _mm_mul_ps(normal, normal);
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_shuffle_ps(squared, squared, _MM_SHUFFLE(0, 0, 0, 0)),
+                                                              _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))),
+                                                   _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2))));
+            // Las normales nulas (triángulos degenerados) se quedan en cero
+            normal = _mm_and_ps(_mm_div_ps(normal, length), _mm_cmpgt_ps(length, _mm_setzero_ps()));
+
+            // (px, py, pz, nx) y (ny, nz, u, v)
+            __m128 mixed = _mm_shuffle_ps(position, normal, _MM_SHUFFLE(0, 0, 2, 2));
+            float* out = dst + v * 8;
+            _mm_storeu_ps(out, _mm_shuffle_ps(position, mixed, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(out + 4, _mm_shuffle_ps(normal, b, _MM_SHUFFLE(3, 2, 2, 1)));
+
+            minBounds = _mm_min_ps(minBounds, position);
+            maxBounds = _mm_max_ps(maxBounds, position);
+        }
+        bounds.min = ToVec3(minBounds);
+        bounds.max = ToVec3(maxBounds);
+#else
+        for (size_t v = begin; v < end; ++v) {
+            const float* in = src + v * 8;
+            glm::vec3 position = glm::vec3(matrix * glm::vec4(in[0], in[1], in[2], 1.0f));
+            glm::vec3 normal = normalMatrix * glm::vec3(in[3], in[4], in[5]);
+            float length = glm::length(normal);
+            normal = length > 0.0f ? normal / length : glm::vec3(0.0f);
+            float u = in[6], w = in[7];
+
+            float* out = dst + v * 8;
+            out[0] = position.x; out[1] = position.y; out[2] = position.z;
+            out[3] = normal.x;   out[4] = normal.y;   out[5] = normal.z;
+            out[6] = u;          out[7] = w;
+            bounds.min = glm::min(bounds.min, position);
+            bounds.max = glm::max(bounds.max, position);
+        }
+#endif
+    }
+
+    // Reparte [0, vertexCount) en bloques y combina la AABB de cada uno
+    template <typename Fn>
+    void ReduceBounds(size_t vertexCount, glm::vec3& minBounds, glm::vec3& maxBounds, Fn&& fn) {
+        std::vector<BlockBounds> blocks((vertexCount + VERTICES_PER_JOB - 1) / VERTICES_PER_JOB);
+        ThreadPool::Get().ParallelFor(vertexCount, VERTICES_PER_JOB, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; block += VERTICES_PER_JOB) {
+                fn(block, std::min(end, block + VERTICES_PER_JOB), blocks[block / VERTICES_PER_JOB]);
+            }
+        });
+        minBounds = glm::vec3(FLT_MAX);
+        maxBounds = glm::vec3(-FLT_MAX);
+        for (const BlockBounds& block : blocks) {
+            minBounds = glm::min(minBounds, block.min);
+            maxBounds = glm::max(maxBounds, block.max);
+        }
+    }
+}
+
+namespace Utils {
+    void positionBounds(const float* vertices, size_t vertexCount, glm::vec3& minBounds, glm::vec3& maxBounds) {
+        ReduceBounds(vertexCount, minBounds, maxBounds, [&](size_t begin, size_t end, BlockBounds& bounds) {
+            BoundsRange(vertices, begin, end, bounds);
+        });
+    }
+
+    void normalizePositions(float* vertices, size_t vertexCount, glm::vec3& minBounds, glm::vec3& maxBounds) {
+        if (vertexCount == 0) return;
+        glm::vec3 size = maxBounds - minBounds;
+        float scale = 1.0f / std::max(size.x, std::max(size.y, size.z));
+        glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+        ReduceBounds(vertexCount, minBounds, maxBounds, [&](size_t begin, size_t end, BlockBounds& bounds) {
+            NormalizeRange(vertices, begin, end, center, scale, bounds);
+        });
+    }
+
+    void transformVertices(const float* src, float* dst, size_t vertexCount, const glm::mat4& matrix,
+                           glm::vec3& minBounds, glm::vec3& maxBounds) {
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
+        ReduceBounds(vertexCount, minBounds, maxBounds, [&](size_t begin, size_t end, BlockBounds& bounds) {
+            TransformRange(src, dst, begin, end, matrix, normalMatrix, bounds);
+        });
+    }
+}
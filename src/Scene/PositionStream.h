@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Pasadas sobre las posiciones de Model::vertices (stride de 8 floats: posición, normal, UV),
+// repartidas entre los hilos del pool y con SSE2 cuando está disponible. Cada vértice se lee
+// con una sola carga de 4 floats (x, y, z y la x de la normal, que se ignora o se conserva).
+namespace Utils {
+    // AABB de las posiciones. Con 0 vértices deja min = FLT_MAX y max = -FLT_MAX
+    void positionBounds(const float* vertices, size_t vertexCount, glm::vec3& minBounds, glm::vec3& maxBounds);
+
+    // Centra la AABB [minBounds, maxBounds] en el origen y escala su lado mayor a 1. En la misma
+    // pasada de escritura mide y devuelve en 'minBounds'/'maxBounds' la AABB resultante
+    void normalizePositions(float* vertices, size_t vertexCount, glm::vec3& minBounds, glm::vec3& maxBounds);
+
+    // Aplica 'matrix' a las posiciones y su inversa traspuesta a las normales (que se vuelven a
+    // normalizar); la UV se copia. 'src' y 'dst' pueden ser el mismo array. Devuelve la AABB
+    // de las posiciones escritas, medida en la misma pasada
+    void transformVertices(const float* src, float* dst, size_t vertexCount, const glm::mat4& matrix,
+                           glm::vec3& minBounds, glm::vec3& maxBounds);
+}
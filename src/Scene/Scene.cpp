@@ -0,0 +1,105 @@
+#include "Scene.h"
+
+ModelHandle Scene::Insert(Model&& mesh, const Transform& transform, uint8_t modelFlags) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(Slot());
+    }
+
+    uint32_t dense = static_cast<uint32_t>(meshes.size());
+    slots[slot].dense = dense;
+    denseToSlot.push_back(slot);
+
+    transforms.push_back(transform);
+    transforms.back().MarkDirty();
+    bounds.push_back(Bounds());
+    meshes.push_back(std::move(mesh));
+    flags.push_back(modelFlags);
+    generation++;
+
+    ModelHandle handle;
+    handle.slot = slot;
+    handle.generation = slots[slot].generation;
+    return handle;
+}
+
+void Scene::Remove(ModelHandle handle) {
+    int index = IndexOf(handle);
+    if (index == -1) return;
+
+    meshes[index].releaseGPU();
+
+    // Swap-and-pop: el último modelo ocupa el hueco y se corrigen los enlaces que apuntaban a él
+    int last = static_cast<int>(meshes.size()) - 1;
+    if (index != last) {
+        transforms[index] = std::move(transforms[last]);
+        bounds[index] = bounds[last];
+        meshes[index] = std::move(meshes[last]);
+        flags[index] = flags[last];
+        denseToSlot[index] = denseToSlot[last];
+        slots[denseToSlot[index]].dense = static_cast<uint32_t>(index);
+
+        Transform& moved = transforms[index];
+        if (moved.parent != -1) {
+            for (int& child : transforms[moved.parent].children) {
+                if (child == last) child = index;
+            }
+        }
+        for (int child : moved.children) {
+            transforms[child].parent = index;
+        }
+    }
+
+    transforms.pop_back();
+    bounds.pop_back();
+    meshes.pop_back();
+    flags.pop_back();
+    denseToSlot.pop_back();
+
+    slots[handle.slot].generation++;
+    freeSlots.push_back(handle.slot);
+    generation++;
+}
+
+void Scene::Clear() {
+    for (auto& mesh : meshes) {
+        mesh.releaseGPU();
+    }
+    for (uint32_t slot : denseToSlot) {
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    transforms.clear();
+    bounds.clear();
+    meshes.clear();
+    flags.clear();
+    denseToSlot.clear();
+    generation++;
+}
+
+int Scene::IndexOf(ModelHandle handle) const {
+    if (handle.slot >= slots.size()) return -1;
+    const Slot& slot = slots[handle.slot];
+    if (slot.generation != handle.generation) return -1;
+    return static_cast<int>(slot.dense);
+}
+
+ModelHandle Scene::HandleOf(int index) const {
+    ModelHandle handle;
+    if (index < 0 || index >= static_cast<int>(denseToSlot.size())) return handle;
+    handle.slot = denseToSlot[index];
+    handle.generation = slots[handle.slot].generation;
+    return handle;
+}
+
+int Scene::FindLight() const {
+    for (size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i] & MODEL_LIGHT) return static_cast<int>(i);
+    }
+    return -1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Model.h"
+#include "Transform.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Referencia estable a un modelo. Sigue siendo válida aunque otros modelos se borren o se
+// reordenen, y deja de resolverse en cuanto el suyo se elimina (cambia la generación del slot).
+struct ModelHandle {
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return slot == INVALID_SLOT; }
+    bool operator==(const ModelHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const ModelHandle& other) const { return !(*this == other); }
+};
+
+enum ModelFlags : uint8_t {
+    MODEL_LIGHT = 1 << 0,
+    MODEL_GROUP = 1 << 1  // Nodo vacío del grafo de escena que solo agrupa a sus hijos
+};
+
+// AABB de mundo de la geometría propia y la unión con todos los descendientes
+struct Bounds {
+    glm::vec3 worldMin = glm::vec3(0.0f);
+    glm::vec3 worldMax = glm::vec3(0.0f);
+    glm::vec3 subtreeMin = glm::vec3(0.0f);
+    glm::vec3 subtreeMax = glm::vec3(0.0f);
+};
+
+// Almacenamiento de la escena orientado a datos: cada componente vive en su propio array
+// denso (mismo índice = mismo modelo), así los bucles de transformación y culling recorren
+// solo la memoria que necesitan. Un slot map traduce handles estables a índices densos;
+// insertar es un push_back y borrar un swap-and-pop, ambos O(1).
+class Scene {
+public:
+    std::vector<Transform> transforms;
+    std::vector<Bounds> bounds;
+    std::vector<Model> meshes;   // Geometría, buffers de GPU, color y textura
+    std::vector<uint8_t> flags;
+
+    // Aumenta cada vez que se insertan o eliminan modelos (los índices densos cambian)
+    unsigned long long generation = 0;
+
+    ModelHandle Insert(Model&& mesh, const Transform& transform = Transform(), uint8_t modelFlags = 0);
+
+    // Libera sus recursos de GPU y mueve el último modelo a su hueco. El nodo no debe tener
+    // padre ni hijos (ver SceneGraph::Detach).
+    void Remove(ModelHandle handle);
+    void Clear();
+
+    // Índice denso actual del handle, o -1 si el modelo ya no existe
+    int IndexOf(ModelHandle handle) const;
+    ModelHandle HandleOf(int index) const;
+    bool IsAlive(ModelHandle handle) const { return IndexOf(handle) != -1; }
+
+    size_t Size() const { return meshes.size(); }
+    bool IsLight(int index) const { return (flags[index] & MODEL_LIGHT) != 0; }
+    bool IsGroup(int index) const { return (flags[index] & MODEL_GROUP) != 0; }
+    int FindLight() const;
+
+private:
+    struct Slot {
+        uint32_t dense = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<uint32_t> freeSlots;
+};
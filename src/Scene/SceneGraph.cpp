@@ -0,0 +1,147 @@
+#include "SceneGraph.h"
+#include <algorithm>
+#include <cfloat>
+
+glm::mat4 SceneGraph::ComputeWorldMatrix(const Scene& scene, int node) {
+    // Se compone desde cero por si algún ancestro está sucio y su caché no es válida
+    const Transform& t = scene.transforms[node];
+    glm::mat4 local = Transform::Compose(t.position, t.rotation, t.scale);
+    if (t.parent == -1) return local;
+    return ComputeWorldMatrix(scene, t.parent) * local;
+}
+
+void SceneGraph::RefreshSubtreeBounds(Scene& scene, int node) {
+    Bounds& b = scene.bounds[node];
+    b.subtreeMin = b.worldMin;
+    b.subtreeMax = b.worldMax;
+    for (int child : scene.transforms[node].children) {
+        b.subtreeMin = glm::min(b.subtreeMin, scene.bounds[child].subtreeMin);
+        b.subtreeMax = glm::max(b.subtreeMax, scene.bounds[child].subtreeMax);
+    }
+}
+
+void SceneGraph::RefreshAncestorBounds(Scene& scene, int node) {
+    for (int p = node; p != -1; p = scene.transforms[p].parent) {
+        RefreshSubtreeBounds(scene, p);
+    }
+}
+
+void SceneGraph::UpdateSubtree(Scene& scene, int node, const glm::mat4& parentWorld, std::vector<int>& changedModels) {
+    Transform& t = scene.transforms[node];
+    t.UpdateWorld(parentWorld);
+
+    const Model& mesh = scene.meshes[node];
+    Bounds& b = scene.bounds[node];
+    if (!mesh.indices.empty()) {
+        Transform::TransformBounds(t.worldMatrix, mesh.localMinBounds, mesh.localMaxBounds, b.worldMin, b.worldMax);
+    } else {
+        // Nodo sin geometría (grupo): AABB vacía para que no aporte nada al unir
+        b.worldMin = glm::vec3(FLT_MAX);
+        b.worldMax = glm::vec3(-FLT_MAX);
+    }
+    changedModels.push_back(node);
+
+    for (int child : t.children) {
+        UpdateSubtree(scene, child, t.worldMatrix, changedModels);
+    }
+    RefreshSubtreeBounds(scene, node);
+}
+
+void SceneGraph::Update(Scene& scene, std::vector<int>& changedModels) {
+    changedModels.clear();
+
+    for (size_t i = 0; i < scene.transforms.size(); ++i) {
+        const Transform& t = scene.transforms[i];
+        if (!t.dirty) continue;
+
+        // Solo el ancestro sucio más alto recorre el subárbol; los demás quedan incluidos en él
+        bool ancestorDirty = false;
+        for (int p = t.parent; p != -1; p = scene.transforms[p].parent) {
+            if (scene.transforms[p].dirty) { ancestorDirty = true; break; }
+        }
+        if (ancestorDirty) continue;
+
+        int node = static_cast<int>(i);
+        glm::mat4 parentWorld = t.parent == -1 ? glm::mat4(1.0f) : scene.transforms[t.parent].worldMatrix;
+        UpdateSubtree(scene, node, parentWorld, changedModels);
+        RefreshAncestorBounds(scene, scene.transforms[node].parent);
+    }
+}
+
+void SceneGraph::Attach(Scene& scene, int child, int parent) {
+    Transform& t = scene.transforms[child];
+    if (t.parent != -1) {
+        std::vector<int>& siblings = scene.transforms[t.parent].children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), child), siblings.end());
+        RefreshAncestorBounds(scene, t.parent);
+    }
+
+    t.parent = parent;
+    if (parent != -1) scene.transforms[parent].children.push_back(child);
+    t.MarkDirty();
+}
+
+bool SceneGraph::IsDescendant(const Scene& scene, int node, int ancestor) {
+    for (int p = scene.transforms[node].parent; p != -1; p = scene.transforms[p].parent) {
+        if (p == ancestor) return true;
+    }
+    return false;
+}
+
+bool SceneGraph::SetParent(Scene& scene, int child, int parent) {
+    if (child == parent) return false;
+    if (parent != -1 && IsDescendant(scene, parent, child)) return false;
+
+    glm::mat4 world = ComputeWorldMatrix(scene, child);
+    glm::mat4 parentWorld = parent == -1 ? glm::mat4(1.0f) : ComputeWorldMatrix(scene, parent);
+
+    Attach(scene, child, parent);
+
+    Transform& t = scene.transforms[child];
+    Transform::Decompose(glm::inverse(parentWorld) * world, t.position, t.rotation, t.scale);
+    return true;
+}
+
+void SceneGraph::TranslateSubtree(Scene& scene, int root, const glm::vec3& offset, std::vector<int>& changedModels) {
+    std::vector<int> stack = { root };
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+
+        Transform& t = scene.transforms[node];
+        t.worldMatrix[3] += glm::vec4(offset, 0.0f);
+        Bounds& b = scene.bounds[node];
+        b.worldMin += offset;
+        b.worldMax += offset;
+        b.subtreeMin += offset;
+        b.subtreeMax += offset;
+        changedModels.push_back(node);
+
+        stack.insert(stack.end(), t.children.begin(), t.children.end());
+    }
+
+    // La posición local solo cambia en la raíz; los hijos siguen relativos a ella
+    Transform& rootTransform = scene.transforms[root];
+    if (rootTransform.parent == -1) {
+        rootTransform.position += offset;
+    } else {
+        glm::mat4 parentInverse = glm::inverse(scene.transforms[rootTransform.parent].worldMatrix);
+        rootTransform.position += glm::vec3(parentInverse * glm::vec4(offset, 0.0f));
+        RefreshAncestorBounds(scene, rootTransform.parent);
+    }
+    rootTransform.localMatrix = Transform::Compose(rootTransform.position, rootTransform.rotation, rootTransform.scale);
+}
+
+void SceneGraph::Detach(Scene& scene, int index) {
+    std::vector<int> children = scene.transforms[index].children;
+    int parent = scene.transforms[index].parent;
+    for (int child : children) {
+        SetParent(scene, child, parent);
+    }
+    Attach(scene, index, -1);
+}
+
+int SceneGraph::GetRoot(const Scene& scene, int node) {
+    while (scene.transforms[node].parent != -1) node = scene.transforms[node].parent;
+    return node;
+}
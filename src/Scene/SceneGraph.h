@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Scene.h"
+#include <vector>
+
+// Jerarquía padre/hijo sobre los arrays de la escena. Cada nodo guarda su transformación local;
+// el grafo compone las de mundo y solo recorre los subárboles que tienen algún nodo sucio,
+// de modo que mover un ensamblaje completo cuesta una única actualización de su subárbol.
+class SceneGraph {
+public:
+    // Recalcula los subárboles sucios y devuelve en 'changedModels' todos los nodos tocados
+    static void Update(Scene& scene, std::vector<int>& changedModels);
+
+    // Enlaza 'child' bajo 'parent' (-1 = raíz) sin tocar su transformación local (carga de escenas)
+    static void Attach(Scene& scene, int child, int parent);
+    // Cambia el padre de 'child' conservando su posición en el mundo. Falla si crearía un ciclo.
+    static bool SetParent(Scene& scene, int child, int parent);
+    static bool IsDescendant(const Scene& scene, int node, int ancestor);
+
+    // Desplaza en el mundo un subárbol ya actualizado sin recomponer sus matrices
+    static void TranslateSubtree(Scene& scene, int root, const glm::vec3& offset, std::vector<int>& changedModels);
+
+    // Prepara el borrado de un nodo: reengancha sus hijos a su padre y lo desengancha del grafo
+    static void Detach(Scene& scene, int index);
+
+    static int GetRoot(const Scene& scene, int node);
+
+private:
+    static glm::mat4 ComputeWorldMatrix(const Scene& scene, int node);
+    static void UpdateSubtree(Scene& scene, int node, const glm::mat4& parentWorld, std::vector<int>& changedModels);
+    static void RefreshSubtreeBounds(Scene& scene, int node);
+    static void RefreshAncestorBounds(Scene& scene, int node);
+};
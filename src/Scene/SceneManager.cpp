@@ -1,6 +1,8 @@
 #include "SceneManager.h"
 #include "../Graphics/PickingShader.h"
 #include "../Graphics/Shader.h"
+#include "../Graphics/VertexLayout.h"
+#include "SceneGraph.h"
 #include <filesystem>
 #include <sstream>
 #include <GLFW/glfw3.h>
@@ -12,33 +14,26 @@
 std::atomic<bool> SceneManager::isImportingAsync{false};
 std::future<Model> SceneManager::futureModel;
 std::atomic<bool> SceneManager::isLoadingSceneAsync{false};
-std::future<std::vector<Model>> SceneManager::futureScene;
+std::future<std::vector<SceneEntry>> SceneManager::futureScene;
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-void SceneManager::Clear(std::vector<Model>& models) {
-    for (auto& model : models) {
-        glDeleteBuffers(1, &model.VBO);
-        glDeleteBuffers(1, &model.EBO);
-        glDeleteVertexArrays(1, &model.VAO);
-        if (model.hasTexture) {
-            glDeleteTextures(1, &model.textureID);
-        }
-    }
-    models.clear();
+void SceneManager::Clear(Scene& scene) {
+    // Scene::Clear libera VAO/VBO/EBO y texturas de todos los modelos
+    scene.Clear();
 
-    AddLight(models);
-    
-    if (!models.empty()) {
-        models[0].position = glm::vec3(1.2f, 1.0f, 2.0f);
-        models[0].updateTransformMatrix();
+    ModelHandle light = AddLight(scene);
+    int lightIndex = scene.IndexOf(light);
+    if (lightIndex != -1) {
+        scene.transforms[lightIndex].position = glm::vec3(1.2f, 1.0f, 2.0f);
+        scene.transforms[lightIndex].MarkDirty();
     }
     std::cout << "Escena eliminada correctamente.\n";
 }
 
-bool SceneManager::Save(const std::vector<Model>& models) {
+bool SceneManager::Save(const Scene& scene) {
     if (!std::filesystem::exists("scenes")) {
         std::filesystem::create_directory("scenes");
     }
@@ -60,13 +55,26 @@ bool SceneManager::Save(const std::vector<Model>& models) {
         return false;
     }
 
-    for (const auto& model : models) {
+    // El padre se guarda como índice de línea dentro del archivo (-1 = raíz)
+    std::vector<int> lineIndex(scene.Size(), -1);
+    int savedLines = 0;
+    for (size_t i = 0; i < scene.Size(); ++i) {
+        if (!scene.meshes[i].path.empty()) lineIndex[i] = savedLines++;
+    }
+
+    for (size_t i = 0; i < scene.Size(); ++i) {
+        const Model& model = scene.meshes[i];
+        const Transform& transform = scene.transforms[i];
         if (model.path.empty()) continue;
+        int parentLine = transform.parent == -1 ? -1 : lineIndex[transform.parent];
         file << std::quoted(model.path) << " "
-             << model.position.x << " " << model.position.y << " " << model.position.z << " "
-             << model.rotation.x << " " << model.rotation.y << " " << model.rotation.z << " "
-             << model.scale.x << " " << model.scale.y << " " << model.scale.z << " "
-             << model.color.r << " " << model.color.g << " " << model.color.b << "\n";
+             << transform.position.x << " " << transform.position.y << " " << transform.position.z << " "
+             << transform.rotation.x << " " << transform.rotation.y << " " << transform.rotation.z << " "
+             << transform.scale.x << " " << transform.scale.y << " " << transform.scale.z << " "
+             << model.color.r << " " << model.color.g << " " << model.color.b << " "
+             << parentLine;
+        if (model.path == "Internal:LightSphere") file << " " << model.lightRadius;
+        file << "\n";
     }
     
     file.close();
@@ -74,7 +82,7 @@ bool SceneManager::Save(const std::vector<Model>& models) {
     return true;
 }
 
-void SceneManager::Load(std::vector<Model>& models) {
+void SceneManager::Load(Scene& scene) {
     if (isLoadingSceneAsync.load() || isImportingAsync.load()) return;
     if (!std::filesystem::exists("scenes")) {
         std::filesystem::create_directory("scenes");
@@ -89,24 +97,51 @@ void SceneManager::Load(std::vector<Model>& models) {
     isLoadingSceneAsync.store(true);
 
     futureScene = std::async(std::launch::async, [pathStr]() {
-        std::vector<Model> loadedModels;
+        std::vector<SceneEntry> loadedModels;
+        std::vector<int> lineParents;
+        std::vector<int> lineToLoaded; // -1 si el modelo de esa línea no se pudo cargar
         std::ifstream file(pathStr);
         if (!file.is_open()) {
             std::cerr << "Error: No se encuentra el archivo de escena.\n";
             return loadedModels; 
         }
 
-        std::string path;
+        std::string line, path;
         glm::vec3 pos, rot, scl, col;
 
-        while (file >> std::quoted(path) >> pos.x >> pos.y >> pos.z >> rot.x >> rot.y >> rot.z >> scl.x >> scl.y >> scl.z >> col.x >> col.y >> col.z) {
+        while (std::getline(file, line)) {
+            std::istringstream in(line);
+            if (!(in >> std::quoted(path) >> pos.x >> pos.y >> pos.z >> rot.x >> rot.y >> rot.z >> scl.x >> scl.y >> scl.z >> col.x >> col.y >> col.z)) continue;
+
+            // Las escenas antiguas no guardan el padre
+            int parentLine = -1;
+            if (!(in >> parentLine)) parentLine = -1;
+            lineParents.push_back(parentLine);
+            lineToLoaded.push_back(-1);
+
             if (path == "Internal:LightSphere") {
-                Model lightData;
-                lightData.isLight = true;
-                lightData.path = path;
-                lightData.position = pos;
-                lightData.color = col;
-                loadedModels.push_back(lightData);
+                SceneEntry lightData;
+                lightData.flags = MODEL_LIGHT;
+                lightData.mesh.path = path;
+                lightData.transform.position = pos;
+                lightData.mesh.color = col;
+                float radius;
+                if (in >> radius) lightData.mesh.lightRadius = radius; // Las escenas antiguas no lo guardan
+                lineToLoaded.back() = static_cast<int>(loadedModels.size());
+                loadedModels.push_back(std::move(lightData));
+                continue;
+            }
+
+            if (path == "Internal:Group") {
+                SceneEntry groupData;
+                groupData.flags = MODEL_GROUP;
+                groupData.mesh.path = path;
+                groupData.transform.position = pos;
+                groupData.transform.rotation = rot;
+                groupData.transform.scale = scl;
+                groupData.mesh.color = col;
+                lineToLoaded.back() = static_cast<int>(loadedModels.size());
+                loadedModels.push_back(std::move(groupData));
                 continue;
             }
 
@@ -117,43 +152,77 @@ void SceneManager::Load(std::vector<Model>& models) {
             std::string baseDir = std::filesystem::path(path).parent_path().string() + "/";
 
             if (tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), baseDir.c_str())) {
-                Model newModel = Model::Process(attrib, shapes, materials, baseDir, true); // Matematica en RAM
-                newModel.path = path;
-                newModel.position = pos;
-                newModel.rotation = rot;
-                newModel.scale = scl;
-                newModel.color = col;
-                newModel.updateTransformMatrix(); 
-                loadedModels.push_back(newModel);
+                SceneEntry newModel;
+                newModel.mesh = Model::Process(attrib, shapes, materials, baseDir, true); // Matematica en RAM
+                newModel.mesh.path = path;
+                newModel.mesh.color = col;
+                newModel.transform.position = pos;
+                newModel.transform.rotation = rot;
+                newModel.transform.scale = scl;
+                lineToLoaded.back() = static_cast<int>(loadedModels.size());
+                loadedModels.push_back(std::move(newModel));
             } else {
                 std::cerr << "No se pudo recargar el modelo: " << path << "\n";
             }
         }
         file.close();
+
+        // Traducir los padres de índice de línea a índice en 'loadedModels'. Si el padre
+        // falló al cargar, el hijo queda como raíz.
+        for (size_t line = 0; line < lineToLoaded.size(); ++line) {
+            int loaded = lineToLoaded[line];
+            if (loaded == -1) continue;
+            int parentLine = lineParents[line];
+            bool validParent = parentLine >= 0 && parentLine < static_cast<int>(lineToLoaded.size()) && parentLine != static_cast<int>(line);
+            loadedModels[loaded].transform.parent = validParent ? lineToLoaded[parentLine] : -1;
+        }
         return loadedModels; 
     });
 }
 
-bool SceneManager::CheckAsyncSceneLoad(std::vector<Model>& models, bool& outHasTexture) {
+bool SceneManager::CheckAsyncSceneLoad(Scene& scene, bool& outHasTexture) {
     outHasTexture = false;
     if (isLoadingSceneAsync.load()) {
         if (futureScene.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            std::vector<Model> loadedModels = futureScene.get(); 
+            std::vector<SceneEntry> loadedModels = futureScene.get(); 
             
             if (!loadedModels.empty()) {
-                Clear(models); 
-
-                for (auto& m : loadedModels) {
-                    if (m.isLight) {
-                        models[0].position = m.position;
-                        models[0].color = m.color;
-                        models[0].updateTransformMatrix();
+                Clear(scene); 
+
+                // La primera luz cargada reutiliza la esfera creada por Clear (la principal); las
+                // demás se añaden como luces puntuales
+                int lightIndex = scene.FindLight();
+                bool keyLightLoaded = false;
+                std::vector<int> loadedToScene(loadedModels.size(), -1);
+                for (size_t j = 0; j < loadedModels.size(); ++j) {
+                    SceneEntry& entry = loadedModels[j];
+                    if (entry.flags & MODEL_LIGHT) {
+                        int target = keyLightLoaded || lightIndex == -1 ? scene.IndexOf(AddLight(scene)) : lightIndex;
+                        keyLightLoaded = true;
+                        scene.transforms[target].position = entry.transform.position;
+                        scene.transforms[target].MarkDirty();
+                        scene.meshes[target].color = entry.mesh.color;
+                        scene.meshes[target].lightRadius = entry.mesh.lightRadius;
+                        loadedToScene[j] = target;
                     } else {
-                        m.setupModel(); 
-                        if (m.hasTexture) outHasTexture = true;
-                        models.push_back(m);
+                        if (!(entry.flags & MODEL_GROUP)) entry.mesh.setupModel(); 
+                        if (entry.mesh.hasTexture) outHasTexture = true;
+                        entry.transform.parent = -1;
+                        ModelHandle handle = scene.Insert(std::move(entry.mesh), entry.transform, entry.flags);
+                        loadedToScene[j] = scene.IndexOf(handle);
                     }
                 }
+
+                // Reconstruir la jerarquía una vez que todos los nodos tienen su índice definitivo
+                for (size_t j = 0; j < loadedModels.size(); ++j) {
+                    int parent = loadedModels[j].transform.parent;
+                    int child = loadedToScene[j];
+                    if (parent == -1 || child == -1 || scene.IsLight(child)) continue;
+                    int sceneParent = loadedToScene[parent];
+                    if (sceneParent == -1 || scene.IsLight(sceneParent)) continue;
+                    if (SceneGraph::IsDescendant(scene, sceneParent, child)) continue;
+                    SceneGraph::Attach(scene, child, sceneParent);
+                }
                 std::cout << "Escena cargada completamente.\n";
             }
             isLoadingSceneAsync.store(false);
@@ -163,28 +232,26 @@ bool SceneManager::CheckAsyncSceneLoad(std::vector<Model>& models, bool& outHasT
     return false;
 }
 
-void SceneManager::CheckCollisionWithPlatform(Model& model, float platformHeight) {
-    glm::vec3 corners[8] = {
-        model.localMinBounds,
-        {model.localMinBounds.x, model.localMinBounds.y, model.localMaxBounds.z},
-        {model.localMinBounds.x, model.localMaxBounds.y, model.localMinBounds.z},
-        {model.localMinBounds.x, model.localMaxBounds.y, model.localMaxBounds.z},
-        {model.localMaxBounds.x, model.localMinBounds.y, model.localMinBounds.z},
-        {model.localMaxBounds.x, model.localMinBounds.y, model.localMaxBounds.z},
-        {model.localMaxBounds.x, model.localMaxBounds.y, model.localMinBounds.z},
-        model.localMaxBounds
-    };
-
-    float minY = FLT_MAX;
-    for (const auto& corner : corners) {
-        glm::vec4 transformed = model.transformMatrix * glm::vec4(corner, 1.0f);
-        minY = glm::min(minY, transformed.y);
+void SceneManager::CheckCollisionWithPlatform(Scene& scene, int rootIndex, float platformHeight, std::vector<int>& changedModels) {
+    // La AABB del subárbol ya está en caché: no hace falta transformar las 8 esquinas
+    float minY = scene.bounds[rootIndex].subtreeMin.y;
+    if (minY < platformHeight) {
+        SceneGraph::TranslateSubtree(scene, rootIndex, glm::vec3(0.0f, platformHeight - minY, 0.0f), changedModels);
     }
+}
 
-    if (minY < platformHeight) {
-        float offset = platformHeight - minY;
-        model.position.y += offset;
-        model.updateTransformMatrix();
+void SceneManager::UpdateTransforms(Scene& scene, float platformHeight, std::vector<int>& changedModels) {
+    SceneGraph::Update(scene, changedModels);
+    if (changedModels.empty()) return;
+
+    // Los ensamblajes se apoyan como una sola pieza: solo se comprueban las raíces afectadas
+    std::vector<int> roots;
+    for (int i : changedModels) {
+        int root = SceneGraph::GetRoot(scene, i);
+        if (std::find(roots.begin(), roots.end(), root) == roots.end()) roots.push_back(root);
+    }
+    for (int root : roots) {
+        CheckCollisionWithPlatform(scene, root, platformHeight, changedModels);
     }
 }
 
@@ -215,7 +282,7 @@ bool SceneManager::RayIntersectsBoundingBox(const glm::vec3& rayOrigin, const gl
     return true;
 }
 
-void SceneManager::ImportModel(std::vector<Model>& models) {
+void SceneManager::ImportModel(Scene& scene) {
     if (isImportingAsync.load()) return; // Prevenir múltiples clics
 
     const char* fileFilter[1] = { "*.obj" };
@@ -248,54 +315,32 @@ void SceneManager::ImportModel(std::vector<Model>& models) {
 }
 
 // Función para revisar si el hilo terminó
-bool SceneManager::CheckAsyncLoad(std::vector<Model>& models) {
+bool SceneManager::CheckAsyncLoad(Scene& scene) {
     if (isImportingAsync.load()) {
         if (futureModel.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
             Model newModel = futureModel.get(); 
+            bool hasTexture = false;
             if (newModel.path != "ERROR") {
                 newModel.setupModel(); 
-                models.push_back(newModel);
+                hasTexture = newModel.hasTexture;
                 std::cout << "Modelo asíncrono cargado: " << std::filesystem::path(newModel.path).filename() << std::endl;
+                scene.Insert(std::move(newModel));
             }
             isImportingAsync.store(false);
-            return newModel.hasTexture;
+            return hasTexture;
         }
     }
     return false;
 }
 
-int SceneManager::PickModel(GLFWwindow* window, const std::vector<Model>& models, const Camera& camera) {
-    static Shader pickingShader(pickingVertexShaderSource, pickingFragmentShaderSource);
-    
+static glm::vec3 EncodePickingID(int id) {
+    return glm::vec3((id & 0xFF) / 255.0f, ((id >> 8) & 0xFF) / 255.0f, ((id >> 16) & 0xFF) / 255.0f);
+}
+
+// Lee el ID codificado en el píxel bajo el cursor (0 = fondo)
+static int ReadPickingID(GLFWwindow* window) {
     int width, height;
     glfwGetFramebufferSize(window, &width, &height);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    pickingShader.use();
-    pickingShader.setMat4("view", camera.getViewMatrix());
-    pickingShader.setMat4("projection", camera.getProjectionMatrix());
-
-    for (int i = 0; i < models.size(); ++i) {
-        float r = ((i + 1) & 0xFF) / 255.0f;
-        float g = (((i + 1) >> 8) & 0xFF) / 255.0f;
-        float b = (((i + 1) >> 16) & 0xFF) / 255.0f;
-        
-        pickingShader.setVec3("pickingColor", glm::vec3(r, g, b));
-        
-        glm::mat4 modelMatrix = glm::mat4(1.0f);
-        modelMatrix = glm::translate(modelMatrix, models[i].position);
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(models[i].rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(models[i].rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(models[i].rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        modelMatrix = glm::scale(modelMatrix, models[i].scale);
-
-        pickingShader.setMat4("model", modelMatrix);
-        
-        glBindVertexArray(models[i].VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(models[i].indices.size()), GL_UNSIGNED_INT, 0);
-    }
-    glBindVertexArray(0);
 
     double xpos, ypos;
     glfwGetCursorPos(window, &xpos, &ypos);
@@ -310,37 +355,101 @@ int SceneManager::PickModel(GLFWwindow* window, const std::vector<Model>& models
     unsigned char data[4];
     glReadPixels(pixelX, pixelY, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
 
-    int pickedID = data[0] + (data[1] * 256) + (data[2] * 256 * 256);
+    return data[0] + (data[1] * 256) + (data[2] * 256 * 256);
+}
 
-    if (pickedID > 0 && (pickedID - 1) < models.size()) {
-        return pickedID - 1;
+// Dibuja las submallas visibles del modelo; con 'submeshIDs' cada una lleva su propio color
+static void DrawPickingSubmeshes(const Shader& shader, const Model& mesh, bool submeshIDs) {
+    glBindVertexArray(mesh.VAO);
+    Utils::applyVertexDecode(shader.ID, mesh.vertexDecode);
+    if (mesh.submeshes.empty()) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices.size()), mesh.indexType, 0);
+        return;
+    }
+    for (size_t s = 0; s < mesh.submeshes.size(); ++s) {
+        const Submesh& submesh = mesh.submeshes[s];
+        if (!submesh.visible) continue;
+        if (submeshIDs) shader.setVec3("pickingColor", EncodePickingID(static_cast<int>(s) + 1));
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(submesh.indexCount), mesh.indexType, mesh.indexOffset(submesh.firstIndex));
     }
-
-    return -1; 
 }
 
-void SceneManager::DeleteSelectedModel(std::vector<Model>& models, int& selectedIndex) {
-    if (selectedIndex < 0 || selectedIndex >= static_cast<int>(models.size())) return;
+ModelHandle SceneManager::PickModel(GLFWwindow* window, const Scene& scene, const Camera& camera, int* pickedSubmesh) {
+    static Shader pickingShader(pickingVertexShaderSource, pickingFragmentShaderSource);
+    if (pickedSubmesh) *pickedSubmesh = -1;
+    
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    pickingShader.use();
+    pickingShader.setMat4("view", camera.getViewMatrix());
+    pickingShader.setMat4("projection", camera.getProjectionMatrix());
+
+    // 1ª pasada: un ID por modelo
+    for (int i = 0; i < static_cast<int>(scene.Size()); ++i) {
+        const Model& mesh = scene.meshes[i];
+        if (mesh.indices.empty()) continue; // Los grupos no tienen geometría que seleccionar
 
-    Model& model = models[selectedIndex];
-    glDeleteBuffers(1, &model.VBO);
-    glDeleteBuffers(1, &model.EBO);
-    glDeleteVertexArrays(1, &model.VAO);
+        pickingShader.setVec3("pickingColor", EncodePickingID(i + 1));
+        pickingShader.setMat4("model", scene.transforms[i].worldMatrix);
+        DrawPickingSubmeshes(pickingShader, mesh, false);
+    }
+    glBindVertexArray(0);
+
+    int pickedID = ReadPickingID(window);
+
+    // El ID codifica el índice denso; se devuelve un handle para que la selección sobreviva a borrados
+    if (pickedID <= 0 || (pickedID - 1) >= static_cast<int>(scene.Size())) {
+        return ModelHandle();
+    }
+    int pickedIndex = pickedID - 1;
+
+    // 2ª pasada: solo el modelo elegido, con un ID por submalla. Se mantiene la profundidad de
+    // la primera para que no aparezcan submallas tapadas por otros modelos.
+    const Model& pickedMesh = scene.meshes[pickedIndex];
+    if (pickedSubmesh && pickedMesh.submeshes.size() > 1) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDepthFunc(GL_LEQUAL);
+        pickingShader.setMat4("model", scene.transforms[pickedIndex].worldMatrix);
+        DrawPickingSubmeshes(pickingShader, pickedMesh, true);
+        glBindVertexArray(0);
+        glDepthFunc(GL_LESS);
+
+        int submeshID = ReadPickingID(window);
+        if (submeshID > 0 && submeshID <= static_cast<int>(pickedMesh.submeshes.size())) {
+            *pickedSubmesh = submeshID - 1;
+        }
+    }
+
+    return scene.HandleOf(pickedIndex);
+}
+
+void SceneManager::DeleteSelectedModel(Scene& scene, ModelHandle& selectedModel) {
+    int selectedIndex = scene.IndexOf(selectedModel);
+    if (selectedIndex == -1) return;
 
-    models.erase(models.begin() + selectedIndex);
+    // Los hijos pasan al abuelo conservando su posición en el mundo
+    SceneGraph::Detach(scene, selectedIndex);
+    scene.Remove(selectedModel);
 
-    selectedIndex = -1;
+    selectedModel = ModelHandle();
     
     std::cout << "Modelo eliminado correctamente." << std::endl;
 }
 
-void SceneManager::AddLight(std::vector<Model>& models) {
+ModelHandle SceneManager::AddGroup(Scene& scene) {
+    Model group;
+    group.path = "Internal:Group";
+    return scene.Insert(std::move(group), Transform(), MODEL_GROUP);
+}
+
+ModelHandle SceneManager::AddLight(Scene& scene) {
     Model lightModel;
-    lightModel.isLight = true;
+    Transform lightTransform;
     lightModel.color = glm::vec3(1.0f, 1.0f, 1.0f);
     lightModel.originalColor = glm::vec3(1.0f, 1.0f, 1.0f);
-    lightModel.position = glm::vec3(2.0f, 2.0f, 2.0f); 
-    lightModel.scale = glm::vec3(0.1f); 
+    lightTransform.position = glm::vec3(2.0f, 2.0f, 2.0f); 
+    lightTransform.scale = glm::vec3(0.1f); 
     lightModel.path = "Internal:LightSphere";
 
     const int X_SEGMENTS = 30;
@@ -354,19 +463,8 @@ void SceneManager::AddLight(std::vector<Model>& models) {
             float yPos = std::cos(ySegment * M_PI);
             float zPos = std::sin(xSegment * 2.0f * M_PI) * std::sin(ySegment * M_PI);
 
-            // 1. Posición (3 floats)
-            lightModel.vertices.push_back(xPos); 
-            lightModel.vertices.push_back(yPos); 
-            lightModel.vertices.push_back(zPos);
-            
-            // 2. Normales (3 floats)
-            lightModel.vertices.push_back(xPos); 
-            lightModel.vertices.push_back(yPos); 
-            lightModel.vertices.push_back(zPos);
-
-            // 3. Texturas (2 floats)!
-            lightModel.vertices.push_back(xSegment); 
-            lightModel.vertices.push_back(ySegment); 
+            glm::vec3 position(xPos, yPos, zPos);
+            Utils::appendVertex(lightModel.vertices, { position, position, glm::vec2(xSegment, ySegment) });
         }
     }
 
@@ -390,21 +488,12 @@ void SceneManager::AddLight(std::vector<Model>& models) {
     glBufferData(GL_ARRAY_BUFFER, lightModel.vertices.size() * sizeof(float), lightModel.vertices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lightModel.EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, lightModel.indices.size() * sizeof(unsigned int), lightModel.indices.data(), GL_STATIC_DRAW);
+    lightModel.gpuBytes = (lightModel.vertices.size() + lightModel.indices.size()) * 4;
 
-    GLsizei stride = 8 * sizeof(float);
-
-    // 1. Posición
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // 2. Normales (Offset 3)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // 3. Texturas (Offset 6)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    Utils::setupVertexAttributes<MeshVertex>();
 
-    lightModel.originalVertices = lightModel.vertices;
-    models.push_back(lightModel);
+    // Límites locales de la esfera unitaria para el culling
+    lightModel.localMinBounds = glm::vec3(-1.0f);
+    lightModel.localMaxBounds = glm::vec3(1.0f);
+    return scene.Insert(std::move(lightModel), lightTransform, MODEL_LIGHT);
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include <atomic>
 #include <future>
 
-#include "Model.h"
+#include "Scene.h"
 #include "../Core/Camera.h"
 #include <vector>
 #include <string>
@@ -13,31 +13,45 @@
 
 struct GLFWwindow;
 
+// Modelo leído de un archivo de escena en el hilo de carga. El padre se guarda en
+// transform.parent como índice dentro del vector de entradas.
+struct SceneEntry {
+    Model mesh;
+    Transform transform;
+    uint8_t flags = 0;
+};
+
 class SceneManager {
 public:
     // Gestión de Archivos
-    static bool Save(const std::vector<Model>& models);
-    static void Load(std::vector<Model>& models);
-    static void Clear(std::vector<Model>& models);
+    static bool Save(const Scene& scene);
+    static void Load(Scene& scene);
+    static void Clear(Scene& scene);
+
+    // Físicas y Colisiones: apoya sobre la plataforma el subárbol completo de la raíz 'rootIndex'
+    static void CheckCollisionWithPlatform(Scene& scene, int rootIndex, float platformHeight, std::vector<int>& changedModels);
 
-    // Físicas y Colisiones
-    static void CheckCollisionWithPlatform(Model& model, float platformHeight);
+    // Recalcula matrices y AABB de mundo solo de los subárboles con nodos sucios,
+    // los apoya sobre la plataforma y devuelve sus índices en 'changedModels'
+    static void UpdateTransforms(Scene& scene, float platformHeight, std::vector<int>& changedModels);
     
     // Raycasting (Mouse picking)
     static glm::vec3 GetRayFromMouse(double mouseX, double mouseY, int windowWidth, int windowHeight, const glm::mat4& projection, const glm::mat4& view);
     static bool RayIntersectsBoundingBox(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const glm::vec3& minBounds, const glm::vec3& maxBounds);
 
     // Importar un modelo usando diálogo de archivo
-    static void ImportModel(std::vector<Model>& models);
-    static void DeleteSelectedModel(std::vector<Model>& models, int& selectedIndex);
-    static int PickModel(GLFWwindow* window, const std::vector<Model>& models, const Camera& camera);
-    static void AddLight(std::vector<Model>& models);
+    static void ImportModel(Scene& scene);
+    static void DeleteSelectedModel(Scene& scene, ModelHandle& selectedModel);
+    // Si 'pickedSubmesh' no es nulo recibe la submalla bajo el cursor (-1 si no hay modelo)
+    static ModelHandle PickModel(GLFWwindow* window, const Scene& scene, const Camera& camera, int* pickedSubmesh = nullptr);
+    static ModelHandle AddLight(Scene& scene);
+    static ModelHandle AddGroup(Scene& scene);
 
     static std::atomic<bool> isImportingAsync;
     static std::future<Model> futureModel;
-    static bool CheckAsyncLoad(std::vector<Model>& models);
+    static bool CheckAsyncLoad(Scene& scene);
 
     static std::atomic<bool> isLoadingSceneAsync;
-    static std::future<std::vector<Model>> futureScene;
-    static bool CheckAsyncSceneLoad(std::vector<Model>& models, bool& outHasTexture);
+    static std::future<std::vector<SceneEntry>> futureScene;
+    static bool CheckAsyncSceneLoad(Scene& scene, bool& outHasTexture);
 };
\ No newline at end of file
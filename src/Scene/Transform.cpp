@@ -0,0 +1,52 @@
+#include "Transform.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/euler_angles.hpp>
+
+glm::mat4 Transform::Compose(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+    glm::mat4 mat = glm::mat4(1.0f);
+    mat = glm::translate(mat, position);
+    mat = glm::rotate(mat, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    mat = glm::rotate(mat, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    mat = glm::rotate(mat, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    mat = glm::scale(mat, scale);
+    return mat;
+}
+
+void Transform::Decompose(const glm::mat4& matrix, glm::vec3& position, glm::vec3& rotation, glm::vec3& scale) {
+    position = glm::vec3(matrix[3]);
+    scale = glm::vec3(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])));
+
+    glm::mat4 rotationMatrix(1.0f);
+    for (int column = 0; column < 3; ++column) {
+        if (scale[column] > 0.0f) rotationMatrix[column] = glm::vec4(glm::vec3(matrix[column]) / scale[column], 0.0f);
+    }
+
+    // Compose aplica Ry * Rx * Rz, que es justo el orden YXZ de GLM
+    float yaw, pitch, roll;
+    glm::extractEulerAngleYXZ(rotationMatrix, yaw, pitch, roll);
+    rotation = glm::degrees(glm::vec3(pitch, yaw, roll));
+}
+
+// Método de Arvo: cada eje de la AABB resultante se obtiene sumando la contribución
+// mínima y máxima de cada columna, sin transformar las 8 esquinas.
+void Transform::TransformBounds(const glm::mat4& matrix, const glm::vec3& localMin, const glm::vec3& localMax, glm::vec3& outMin, glm::vec3& outMax) {
+    glm::vec3 translation(matrix[3]);
+    outMin = translation;
+    outMax = translation;
+
+    for (int column = 0; column < 3; ++column) {
+        glm::vec3 axis(matrix[column]);
+        glm::vec3 a = axis * localMin[column];
+        glm::vec3 b = axis * localMax[column];
+        outMin += glm::min(a, b);
+        outMax += glm::max(a, b);
+    }
+}
+
+void Transform::UpdateWorld(const glm::mat4& parentWorld) {
+    localMatrix = Compose(position, rotation, scale);
+    worldMatrix = parentWorld * localMatrix;
+    dirty = false;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Componente de transformación con caché. Quien modifique position/rotation/scale debe
+// llamar a MarkDirty(); las matrices de mundo (y las AABB en Scene::bounds) solo se
+// recalculan al actualizar el grafo de escena (SceneGraph::Update), que propaga el cambio
+// a todo el subárbol.
+struct Transform {
+    // Transformación local, relativa al padre (o al mundo si es raíz)
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f); // Grados (orden de aplicación Y, X, Z)
+    glm::vec3 scale    = glm::vec3(1.0f);
+
+    glm::mat4 localMatrix = glm::mat4(1.0f);
+    glm::mat4 worldMatrix = glm::mat4(1.0f);
+
+    // Jerarquía (índices densos en la escena)
+    int parent = -1;
+    std::vector<int> children;
+
+    bool dirty = true;
+
+    void MarkDirty() { dirty = true; }
+
+    // Recalcula la matriz local y la de mundo a partir de la del padre
+    void UpdateWorld(const glm::mat4& parentWorld);
+
+    static glm::mat4 Compose(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+    // Inversa de Compose: extrae posición, rotación (grados) y escala de una matriz sin cizalla
+    static void Decompose(const glm::mat4& matrix, glm::vec3& position, glm::vec3& rotation, glm::vec3& scale);
+    static void TransformBounds(const glm::mat4& matrix, const glm::vec3& localMin, const glm::vec3& localMax, glm::vec3& outMin, glm::vec3& outMax);
+};
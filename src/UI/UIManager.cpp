@@ -1,10 +1,21 @@
 #include "UIManager.h"
+#include "../Scene/SceneGraph.h"
+#include "../Scene/MaterialLibrary.h"
 #include <imgui_internal.h>
+#include <chrono>
+#include <filesystem>
 #include <string>
 
 static float notificationTimer = 0.0f;
 static std::string notificationText = "";
 
+// Nombre corto para listas y combos: los grupos no tienen archivo asociado
+// El ID mostrado es el slot del handle, que no cambia al borrar otros modelos
+static std::string NodeLabel(const Scene& scene, int index) {
+    std::string name = scene.IsGroup(index) ? "Grupo" : std::filesystem::path(scene.meshes[index].path).filename().string();
+    return name + " (ID: " + std::to_string(scene.HandleOf(index).slot) + ")";
+}
+
 void UIManager::ShowNotification(const std::string& message) {
     notificationText = message;
     notificationTimer = 3.0f; 
@@ -21,6 +32,13 @@ static void HelpMarker(const char* desc) {
     }
 }
 
+// Muestra de color de la leyenda seguida de su texto
+static void LegendSwatch(const glm::vec3& color, const char* label) {
+    ImGui::ColorButton(label, ImVec4(color.r, color.g, color.b, 1.0f), ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoPicker, ImVec2(14.0f, 14.0f));
+    ImGui::SameLine();
+    ImGui::TextUnformatted(label);
+}
+
 void UIManager::Init(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -50,7 +68,9 @@ void UIManager::Shutdown() {
     ImGui::DestroyContext();
 }
 
-void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& models, int& selectedModelIndex, double fps) {
+void UIManager::Render(GLFWwindow* window, UIState& state, Scene& scene, ModelHandle& selectedModel, double fps, const FrameStats& stats) {
+    int selectedModelIndex = scene.IndexOf(selectedModel);
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -109,21 +129,27 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
     if (ImGui::BeginMainMenuBar()) {
         if (ImGui::BeginMenu("Archivo")) {
             if (ImGui::MenuItem("Importar Modelo", "Ctrl+O")) {
-                SceneManager::ImportModel(models);
-                if (!models.empty() && models.back().hasTexture) {
+                SceneManager::ImportModel(scene);
+                if (!scene.meshes.empty() && scene.meshes.back().hasTexture) {
                     state.renderMode = 1; 
                 }
             }
+            if (ImGui::MenuItem("Nuevo Grupo")) {
+                selectedModel = SceneManager::AddGroup(scene);
+            }
+            if (ImGui::MenuItem("Nueva Luz")) {
+                selectedModel = SceneManager::AddLight(scene);
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Guardar Escena", "Ctrl+S")) {
-                if (SceneManager::Save(models)) {
+                if (SceneManager::Save(scene)) {
                     UIManager::ShowNotification("Escena guardada correctamente.");
                 }
             }
             if (ImGui::MenuItem("Cargar Escena", "Ctrl+L")) {
-                selectedModelIndex = -1;
-                SceneManager::Load(models);
-                for (const auto& m : models) {
+                selectedModel = ModelHandle();
+                SceneManager::Load(scene);
+                for (const auto& m : scene.meshes) {
                     if (m.hasTexture) { 
                         state.renderMode = 1; 
                         break; 
@@ -131,9 +157,9 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                 }
             }
             if (ImGui::MenuItem("Limpiar Escena", "Ctrl+N")) {
-                selectedModelIndex = -1;
+                selectedModel = ModelHandle();
                 UIManager::ShowNotification("Escena limpiada correctamente.");
-                SceneManager::Clear(models);
+                SceneManager::Clear(scene);
             }
             ImGui::Separator();
             if (ImGui::MenuItem("Salir", "Esc")) {
@@ -164,11 +190,12 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                 
                 const char* renderModes[] = { 
                     "1. Vista Solida", "2. Vista con Textura", "3. Sin Iluminacion", 
-                    "4. Normal (Phong)", "5. Caricatura", "6. Boceto", "7. Holograma" 
+                    "4. Normal (Phong)", "5. Caricatura", "6. Boceto", "7. Holograma",
+                    "8. Sobredibujado", "9. Densidad de Triangulos", "10. Nivel de Detalle", "11. Meshlets"
                 };
 
                 bool hasAnyTexture = false;
-                for (const auto& m : models) {
+                for (const auto& m : scene.meshes) {
                     if (m.hasTexture) { hasAnyTexture = true; break; }
                 }
 
@@ -191,12 +218,12 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                 
                 ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "COLOR GLOBAL");
                 ImGui::Separator();
-                if (!models.empty()) {
+                if (!scene.meshes.empty()) {
                     if (ImGui::Checkbox("Sobrescribir Color Base", &state.enableColorChange)) {
                         if (!state.enableColorChange) {
-                            for (size_t i = 0; i < models.size(); ++i) {
-                                if (static_cast<int>(i) != selectedModelIndex && !models[i].isLight) {
-                                    models[i].color = models[i].originalColor;
+                            for (size_t i = 0; i < scene.Size(); ++i) {
+                                if (static_cast<int>(i) != selectedModelIndex && !scene.IsLight(static_cast<int>(i))) {
+                                    scene.meshes[i].color = scene.meshes[i].originalColor;
                                 }
                             }
                         }
@@ -205,9 +232,9 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                         ImGui::SetNextItemWidth(-1);
                         ImGui::ColorEdit3("##NewColor", (float*)&state.newColor);
                         
-                        for (size_t i = 0; i < models.size(); ++i) {
-                            if (static_cast<int>(i) != selectedModelIndex && !models[i].isLight) {
-                                models[i].color = state.newColor;
+                        for (size_t i = 0; i < scene.Size(); ++i) {
+                            if (static_cast<int>(i) != selectedModelIndex && !scene.IsLight(static_cast<int>(i))) {
+                                scene.meshes[i].color = state.newColor;
                             }
                         }
                     }
@@ -266,13 +293,202 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
 
                 ImGui::Checkbox("Z-buffer (Depth Test)", &state.enableDepthTest);
                 ImGui::SameLine(); HelpMarker("Evita que objetos lejanos se dibujen sobre los cercanos.");
+                if (state.enableDepthTest) {
+                    ImGui::Indent();
+                    const char* prepassModes[] = { "Desactivada", "Automática", "Siempre" };
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::Combo("Pre-pasada Z", &state.depthPrepassMode, prepassModes, IM_ARRAYSIZE(prepassModes));
+                    ImGui::SameLine(); HelpMarker("Antes de la capa base se dibuja solo la profundidad de los modelos y después cada píxel se sombrea una única vez, con el fragmento visible. Compensa con modelos que se tapan mucho entre sí y modos de render caros. En automático se activa cuando la capa base sombrea más fragmentos por píxel que el umbral. No se usa con el alambrado ni con el modo holograma, que son transparentes.");
+                    if (state.depthPrepassMode == static_cast<int>(DepthPrepassMode::Auto)) {
+                        ImGui::SetNextItemWidth(150.0f);
+                        ImGui::SliderFloat("Umbral de sobredibujado", &state.depthPrepassThreshold, 1.0f, 4.0f, "%.2f");
+                    }
+                    ImGui::TextDisabled("Pre-pasada: %s", stats.depthPrepass.active ? "activa" : "inactiva");
+                    ImGui::TextDisabled("Sobredibujado: %.2f  Sombreados: %.2f por muestra", stats.depthPrepass.overdraw, stats.depthPrepass.shaded);
+                    ImGui::Unindent();
+                }
 
                 ImGui::Checkbox("Culling (Caras traseras)", &state.enableBackFaceCulling);
                 ImGui::SameLine(); HelpMarker("No dibuja las caras traseras para ganar rendimiento.");
 
                 ImGui::Checkbox("Antialiasing (MSAA)", &state.enableAntialiasing);
                 ImGui::SameLine(); HelpMarker("Suaviza los bordes dentados.");
+
+                ImGui::Checkbox("Culling por oclusión (CPU)", &state.enableOcclusionCulling);
+                ImGui::SameLine(); HelpMarker("Rasteriza en CPU los modelos grandes en un Z-buffer de baja resolución y descarta los que quedan completamente ocultos.");
+                if (state.enableOcclusionCulling) {
+                    ImGui::Indent();
+                    ImGui::TextDisabled("Oclusores: %d (%d triángulos)", stats.occlusion.occluders, stats.occlusion.occluderTriangles);
+                    ImGui::TextDisabled("Ocultos: %d  Dibujados: %d", stats.occlusion.occluded, stats.occlusion.drawn);
+                    ImGui::TextDisabled("Tiempo: %.3f ms", stats.occlusion.timeMs);
+                    ImGui::Unindent();
+                }
+
+                ImGui::Checkbox("Culling por clusters (meshlets)", &state.enableClusterCulling);
+                ImGui::SameLine(); HelpMarker("Las mallas grandes se dividen al importar en grupos de ~124 triángulos con esfera y cono de normales. Se descartan los que quedan fuera de cámara o de espaldas (esto último solo con el culling de caras traseras activo).");
+                if (state.enableClusterCulling) {
+                    ImGui::Indent();
+                    int drawn = stats.clusters.tested - stats.clusters.frustumCulled - stats.clusters.backfaceCulled;
+                    ImGui::TextDisabled("Meshlets: %d de %d en %d rangos", drawn, stats.clusters.tested, stats.clusters.drawRanges);
+                    ImGui::TextDisabled("Fuera: %d  De espaldas: %d", stats.clusters.frustumCulled, stats.clusters.backfaceCulled);
+                    if (selectedModelIndex != -1) {
+                        ImGui::TextDisabled("Seleccionado: %zu meshlets", scene.meshes[selectedModelIndex].meshlets.size());
+                    }
+                    ImGui::Unindent();
+                }
+                if (stats.clusters.submeshesTested > 0) {
+                    ImGui::Indent();
+                    ImGui::TextDisabled("Submallas descartadas: %d de %d", stats.clusters.submeshesCulled, stats.clusters.submeshesTested);
+                    ImGui::Unindent();
+                }
+
+                ImGui::Text("Caché de visibilidad");
+                ImGui::SameLine(); HelpMarker("Si la cámara y la escena no cambian se reutiliza la lista de visibles del frame anterior; si solo se mueven algunos modelos, se vuelven a probar únicamente esos.");
+                ImGui::Indent();
+                if (stats.visibility.reused) {
+                    ImGui::TextDisabled("Reutilizada (%.3f ms)", stats.visibility.timeMs);
+                } else {
+                    ImGui::TextDisabled("Re-evaluados: %d  Movidos: %d (%.3f ms)", stats.visibility.retested, stats.visibility.dirty, stats.visibility.timeMs);
+                    if (stats.visibility.culledSubtrees > 0) {
+                        ImGui::TextDisabled("Subárboles descartados: %d", stats.visibility.culledSubtrees);
+                    }
+                }
+                ImGui::Unindent();
+
+                ImGui::Spacing();
+                ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "NIVEL DE DETALLE");
+                ImGui::Separator();
+                ImGui::Checkbox("LOD automático", &state.enableLod);
+                ImGui::SameLine(); HelpMarker("Al importar se generan hasta 4 versiones simplificadas de cada malla. Se dibuja la más simple cuyo error, proyectado en pantalla, no supera el umbral.");
+                if (state.enableLod) {
+                    ImGui::Indent();
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::SliderFloat("Error máximo (px)", &state.lodMaxPixelError, 0.25f, 8.0f, "%.2f");
+
+                    int saved = stats.lod.fullTriangles - stats.lod.drawnTriangles;
+                    float savedPercent = stats.lod.fullTriangles > 0 ? 100.0f * saved / stats.lod.fullTriangles : 0.0f;
+                    ImGui::TextDisabled("Triángulos: %d de %d", stats.lod.drawnTriangles, stats.lod.fullTriangles);
+                    ImGui::TextDisabled("Ahorro: %d (%.1f%%)", saved, savedPercent);
+
+                    if (selectedModelIndex != -1) {
+                        const Model& selectedMesh = scene.meshes[selectedModelIndex];
+                        if (selectedMesh.lods.size() > 1) {
+                            int active = selectedMesh.activeLod;
+                            size_t full = selectedMesh.getTriangleCount(0);
+                            size_t drawn = selectedMesh.getTriangleCount(active);
+                            float meshPercent = full > 0 ? 100.0f * (full - drawn) / full : 0.0f;
+                            ImGui::TextDisabled("Seleccionado: LOD %d/%d, %zu tri (-%.1f%%)",
+                                                active, static_cast<int>(selectedMesh.lods.size()) - 1, drawn, meshPercent);
+                        } else {
+                            ImGui::TextDisabled("Seleccionado: sin LOD (malla pequeña)");
+                        }
+                    }
+                    ImGui::Unindent();
+                }
+
+                ImGui::Checkbox("Culling por tamaño en pantalla", &state.enableScreenSizeCulling);
+                ImGui::SameLine(); HelpMarker("Descarta los modelos cuya caja envolvente proyectada mide menos que el umbral.");
+                if (state.enableScreenSizeCulling) {
+                    ImGui::Indent();
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::SliderFloat("Tamaño mínimo (px)", &state.minScreenSize, 0.5f, 32.0f, "%.1f");
+                    ImGui::TextDisabled("Descartados: %d", stats.visibility.smallCulled);
+                    ImGui::Unindent();
+                }
+
+                ImGui::Checkbox("Impostores", &state.enableImpostors);
+                ImGui::SameLine(); HelpMarker("Los modelos lejanos se sustituyen por un quad con una de 16 vistas pre-renderizadas (albedo y normales), que se iluminan con la luz actual.");
+                if (state.enableImpostors) {
+                    ImGui::Indent();
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::SliderFloat("Distancia", &state.impostorDistance, 2.0f, 100.0f, "%.1f");
+                    ImGui::TextDisabled("Impostores: %d  Capturados: %d", stats.impostorsDrawn, stats.impostorsCaptured);
+                    ImGui::Unindent();
+                }
+
+                ImGui::Text("Cola por material");
+                ImGui::SameLine(); HelpMarker("Al importar, las caras se agrupan por material y los materiales iguales de distintos modelos se comparten. Las texturas se comprimen en bloques (BCn) al importar y se guardan en cache/textures; las del mismo tamaño comparten un array de texturas y las irregulares se empaquetan en un atlas, así que la pasada base cambia de textura solo entre arrays.");
+                ImGui::Indent();
+                TextureArrayStats textureStats = TextureArrays::GetStats();
+                ImGui::TextDisabled("Materiales únicos: %d", MaterialLibrary::ActiveCount());
+                ImGui::TextDisabled("Texturas: %d en %d arrays (%d atlas, %.1f MB)", textureStats.textures, textureStats.pages,
+                                    textureStats.atlasPages, textureStats.bytes / (1024.0 * 1024.0));
+                TextureCodecStats codecStats = TextureCodec::GetStats();
+                ImGui::TextDisabled("%s: %d comprimidas (%.0f ms), %d desde caché", TextureCodec::CompressionEnabled() ? "BC1/BC3/BC5" : "RGBA8",
+                                    codecStats.encoded, codecStats.encodeMs, codecStats.cacheHits);
+                if (codecStats.resized > 0) ImGui::TextDisabled("Reducidas al tamaño máximo: %d", codecStats.resized);
+                ImGui::TextDisabled("Residentes: %.1f de %.1f MB  Cargando: %d", textureStats.bytes / (1024.0 * 1024.0),
+                                    textureStats.fullBytes / (1024.0 * 1024.0), textureStats.pendingLoads);
+                ImGui::TextDisabled("Niveles subidos: %d  Expulsados: %d", textureStats.streamedLevels, textureStats.evictedLevels);
+                ImGui::TextDisabled("Cambios de textura: %d  Material: %d  Draws: %d", stats.renderQueue.textureBinds,
+                                    stats.renderQueue.materialBinds, stats.renderQueue.drawCalls);
+                ImGui::Unindent();
+
+                ImGui::Text("Formato de vértices");
+                ImGui::SameLine(); HelpMarker("En GPU cada vértice ocupa 12-20 bytes en vez de 32: posición en 16 bits dentro de la caja del modelo, normal octaédrica en 2x16 bits y UV en half (en float si la textura es tan grande que half perdería precisión; sin texturas no se sube). Los índices van en 16 bits si el modelo tiene menos de 65536 vértices.");
+                ImGui::Indent();
+                size_t geometryBytes = 0, floatBytes = 0;
+                for (const Model& mesh : scene.meshes) {
+                    geometryBytes += mesh.gpuBytes;
+                    floatBytes += (mesh.vertices.size() + mesh.indices.size() + mesh.lodIndices.size()) * 4;
+                }
+                ImGui::TextDisabled("Geometría: %.1f MB (%.1f MB en float)", geometryBytes / (1024.0 * 1024.0), floatBytes / (1024.0 * 1024.0));
+                if (selectedModelIndex != -1) {
+                    static const char* formatNames[] = { "float (32 B)", "compacto (16 B)", "compacto, UV float (20 B)", "compacto, sin UV (12 B)" };
+                    const Model& selectedMesh = scene.meshes[selectedModelIndex];
+                    ImGui::TextDisabled("Seleccionado: %s, índices de %d bits", formatNames[static_cast<int>(selectedMesh.vertexFormat)],
+                                        selectedMesh.indexType == GL_UNSIGNED_SHORT ? 16 : 32);
+                }
+                ImGui::Unindent();
+
+                ImGui::Text("Orden de triángulos");
+                ImGui::SameLine(); HelpMarker("Al importar se sueldan los vértices repetidos, los triángulos de cada meshlet se ordenan para la caché de vértices de la GPU (Tipsify), los meshlets que miran hacia fuera se dibujan antes para que el Z-buffer descarte más píxeles y los vértices se renumeran en orden de uso. ACMR: vértices transformados por triángulo (0.5-0.7 es muy bueno, 3 es sin caché). ATVR: por vértice distinto (1 es el óptimo).");
+                ImGui::Indent();
+                if (selectedModelIndex != -1) {
+                    const VertexCacheStats& cache = scene.meshes[selectedModelIndex].vertexCache;
+                    if (cache.acmrBefore > 0.0f) {
+                        ImGui::TextDisabled("ACMR: %.3f -> %.3f", cache.acmrBefore, cache.acmrAfter);
+                        ImGui::TextDisabled("ATVR: %.3f -> %.3f", cache.atvrBefore, cache.atvrAfter);
+                    } else {
+                        ImGui::TextDisabled("Seleccionado: sin optimizar (generado)");
+                    }
+                } else {
+                    ImGui::TextDisabled("Selecciona un modelo");
+                }
+                ImGui::Unindent();
+
+                ImGui::Text("Tamaño de texturas");
+                ImGui::SameLine(); HelpMarker("Al importar, las texturas más grandes que el tope se reducen (filtro Kaiser en espacio lineal) y los mipmaps se generan en los hilos de carga. Al cargar solo se sube la cola de mipmaps (hasta 128 px); los niveles finos se leen de cache/textures cuando la densidad de texels en pantalla los pide y, si no caben en el presupuesto de VRAM, se expulsan los de las texturas usadas hace más tiempo. Si las texturas de un modelo no caben en el presupuesto ni siquiera así, el tope baja a la mitad hasta que caben. El tope se aplica a las texturas que se carguen después del cambio.");
+                ImGui::Indent();
+                static const int textureSizes[] = { 512, 1024, 2048, 4096, 8192, 16384 };
+                static const char* textureSizeNames[] = { "512", "1024", "2048", "4096", "8192", "16384" };
+                int sizeIndex = 0;
+                while (sizeIndex < 5 && textureSizes[sizeIndex] < state.textureMaxSize) sizeIndex++;
+                ImGui::SetNextItemWidth(150.0f);
+                if (ImGui::Combo("Tamaño máximo", &sizeIndex, textureSizeNames, IM_ARRAYSIZE(textureSizeNames))) {
+                    state.textureMaxSize = textureSizes[sizeIndex];
+                }
+                ImGui::SetNextItemWidth(150.0f);
+                ImGui::SliderInt("Presupuesto VRAM", &state.textureBudgetMB, 0, 4096, state.textureBudgetMB == 0 ? "Sin límite" : "%d MB");
+                ImGui::Unindent();
                 
+                ImGui::Spacing();
+                ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "ILUMINACIÓN");
+                ImGui::Separator();
+                ImGui::Checkbox("Luces agrupadas (clustered)", &state.enableClusteredLights);
+                ImGui::SameLine(); HelpMarker("Además de la luz principal, cada luz de la escena (Archivo > Nueva Luz) ilumina como luz puntual dentro de su alcance. El frustum se divide en 16x9x24 celdas; cada frame la CPU reparte las luces entre las celdas que tocan y cada píxel solo evalúa las de su celda.");
+                if (state.enableClusteredLights) {
+                    ImGui::Indent();
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::SliderInt("Luces de prueba", &state.testLightCount, 0, 4096);
+                    ImGui::SetNextItemWidth(150.0f);
+                    ImGui::SliderFloat("Alcance de prueba", &state.testLightRadius, 0.25f, 8.0f, "%.2f");
+                    ImGui::TextDisabled("Luces: %d (%d en cámara)  Asignación: %.3f ms", stats.lights.lights, stats.lights.visibleLights, stats.lights.assignMs);
+                    ImGui::TextDisabled("Celdas con luz: %d de %d  Máximo: %d", stats.lights.litClusters, LightClusters::CLUSTER_COUNT, stats.lights.maxPerCluster);
+                    ImGui::TextDisabled("Índices: %d", stats.lights.indices);
+                    ImGui::Unindent();
+                }
+
                 ImGui::Spacing();
                 ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "INTERFAZ");
                 ImGui::Separator();
@@ -281,14 +497,15 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                 ImGui::EndTabItem();
             }
 
-            static int lastSelected = -1;
-            if (selectedModelIndex == -1 || selectedModelIndex >= (int)models.size()) {
-                lastSelected = -1;
+            static ModelHandle lastSelected;
+            if (selectedModelIndex == -1) {
+                lastSelected = ModelHandle();
             } else {              
-                Model& currentModel = models[selectedModelIndex];           
-                bool selectTransformTab = (selectedModelIndex != lastSelected);
+                Model& currentModel = scene.meshes[selectedModelIndex];
+                Transform& currentTransform = scene.transforms[selectedModelIndex];
+                bool selectTransformTab = (selectedModel != lastSelected);
                 if (selectTransformTab) {
-                    lastSelected = selectedModelIndex;
+                    lastSelected = selectedModel;
                 }
                 
                 if (ImGui::BeginTabItem("Transformación",
@@ -299,8 +516,8 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                     float itemW = (ImGui::GetContentRegionAvail().x - 90.0f) / 3.0f;
                     float alignRButton = ImGui::GetContentRegionAvail().x - 24.0f - ImGui::GetStyle().ItemSpacing.x;
 
-                    if (currentModel.isLight) {
-                        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "FUENTE DE LUZ (ID: %d)", selectedModelIndex);
+                    if (scene.IsLight(selectedModelIndex)) {
+                        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "FUENTE DE LUZ (ID: %u)", selectedModel.slot);
                         ImGui::Separator();
                         ImGui::Spacing();
                         
@@ -308,24 +525,37 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                         ImGui::AlignTextToFramePadding();
                         ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "X"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##LPX", &currentModel.position.x, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##LPX", &currentTransform.position.x, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Y"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##LPY", &currentModel.position.y, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##LPY", &currentTransform.position.y, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 0.6f, 1.0f, 1.0f), "Z"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##LPZ", &currentModel.position.z, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##LPZ", &currentTransform.position.z, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
-                        if (ImGui::Button("R##LRPos", ImVec2(24, 0))) { currentModel.position = glm::vec3(0.0f); currentModel.updateTransformMatrix(); }
+                        if (ImGui::Button("R##LRPos", ImVec2(24, 0))) { currentTransform.position = glm::vec3(0.0f); currentTransform.MarkDirty(); }
                         
                         ImGui::Spacing();
                         ImGui::Text("Color / Intensidad");
                         ImGui::SetNextItemWidth(-1);
                         ImGui::ColorEdit3("##LightColor", (float*)&currentModel.color);
+
+                        ImGui::Spacing();
+                        if (selectedModelIndex == scene.FindLight()) {
+                            ImGui::TextDisabled("Luz principal: ilumina toda la escena");
+                        } else {
+                            ImGui::Text("Alcance");
+                            ImGui::SetNextItemWidth(-1);
+                            ImGui::DragFloat("##LightRadius", &currentModel.lightRadius, 0.05f, 0.1f, 100.0f, "%.2f");
+                        }
                     } else {
-                        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.6f, 1.0f), "MODELO SELECCIONADO (ID: %d)", selectedModelIndex);
+                        if (scene.IsGroup(selectedModelIndex)) {
+                            ImGui::TextColored(ImVec4(0.9f, 0.7f, 0.3f, 1.0f), "GRUPO (ID: %u)", selectedModel.slot);
+                        } else {
+                            ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.6f, 1.0f), "MODELO SELECCIONADO (ID: %u)", selectedModel.slot);
+                        }
                         ImGui::Separator();
                         ImGui::Spacing();
 
@@ -334,17 +564,17 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                         ImGui::AlignTextToFramePadding();
                         ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "X"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##PX", &currentModel.position.x, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##PX", &currentTransform.position.x, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Y"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##PY", &currentModel.position.y, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##PY", &currentTransform.position.y, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 0.6f, 1.0f, 1.0f), "Z"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##PZ", &currentModel.position.z, 0.05f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##PZ", &currentTransform.position.z, 0.05f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
-                        if (ImGui::Button("R##RPos", ImVec2(24, 0))) { currentModel.position = glm::vec3(0.0f); currentModel.updateTransformMatrix(); }
+                        if (ImGui::Button("R##RPos", ImVec2(24, 0))) { currentTransform.position = glm::vec3(0.0f); currentTransform.MarkDirty(); }
                         ImGui::Spacing();
 
                         // --- ROTACIÓN ---
@@ -352,17 +582,17 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                         ImGui::AlignTextToFramePadding();
                         ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "X"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##RX", &currentModel.rotation.x, 0.5f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##RX", &currentTransform.rotation.x, 0.5f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Y"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##RY", &currentModel.rotation.y, 0.5f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##RY", &currentTransform.rotation.y, 0.5f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 0.6f, 1.0f, 1.0f), "Z"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        if (ImGui::DragFloat("##RZ", &currentModel.rotation.z, 0.5f)) currentModel.updateTransformMatrix(); ImGui::SameLine();
+                        if (ImGui::DragFloat("##RZ", &currentTransform.rotation.z, 0.5f)) currentTransform.MarkDirty(); ImGui::SameLine();
                         
-                        if (ImGui::Button("R##RRot", ImVec2(24, 0))) { currentModel.rotation = glm::vec3(0.0f); currentModel.updateTransformMatrix(); }
+                        if (ImGui::Button("R##RRot", ImVec2(24, 0))) { currentTransform.rotation = glm::vec3(0.0f); currentTransform.MarkDirty(); }
                         ImGui::Spacing();
 
                         // --- ESCALA INDIVIDUAL ---
@@ -370,33 +600,123 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                         ImGui::AlignTextToFramePadding();
                         ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "X"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        bool sX = ImGui::DragFloat("##SX", &currentModel.scale.x, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
+                        bool sX = ImGui::DragFloat("##SX", &currentTransform.scale.x, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Y"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        bool sY = ImGui::DragFloat("##SY", &currentModel.scale.y, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
+                        bool sY = ImGui::DragFloat("##SY", &currentTransform.scale.y, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
                         
                         ImGui::TextColored(ImVec4(0.4f, 0.6f, 1.0f, 1.0f), "Z"); ImGui::SameLine(0, 2);
                         ImGui::SetNextItemWidth(itemW);
-                        bool sZ = ImGui::DragFloat("##SZ", &currentModel.scale.z, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
+                        bool sZ = ImGui::DragFloat("##SZ", &currentTransform.scale.z, 0.02f, 0.01f, 100.0f, "%.2f"); ImGui::SameLine();
                         
                         if (sX || sY || sZ) {
-                            if(currentModel.scale.x < 0.01f) currentModel.scale.x = 0.01f;
-                            if(currentModel.scale.y < 0.01f) currentModel.scale.y = 0.01f;
-                            if(currentModel.scale.z < 0.01f) currentModel.scale.z = 0.01f;
-                            currentModel.updateTransformMatrix();
+                            if(currentTransform.scale.x < 0.01f) currentTransform.scale.x = 0.01f;
+                            if(currentTransform.scale.y < 0.01f) currentTransform.scale.y = 0.01f;
+                            if(currentTransform.scale.z < 0.01f) currentTransform.scale.z = 0.01f;
+                            currentTransform.MarkDirty();
                         }
-                        if (ImGui::Button("R##RScl", ImVec2(24, 0))) { currentModel.scale = glm::vec3(1.0f); currentModel.updateTransformMatrix(); }
+                        if (ImGui::Button("R##RScl", ImVec2(24, 0))) { currentTransform.scale = glm::vec3(1.0f); currentTransform.MarkDirty(); }
                         ImGui::Spacing();
 
                         // --- ESCALA UNIFORME ---
                         ImGui::Text("Escala Uniforme");
-                        float uScale = currentModel.scale.x; 
+                        float uScale = currentTransform.scale.x; 
                         ImGui::SetNextItemWidth(alignRButton); 
                         if (ImGui::DragFloat("##Uniform", &uScale, 0.02f, 0.01f, 100.0f, "%.2f")) {
-                            currentModel.scale = glm::vec3(uScale);
-                            if (currentModel.scale.x < 0.01f) currentModel.scale = glm::vec3(0.01f);
-                            currentModel.updateTransformMatrix();
+                            currentTransform.scale = glm::vec3(uScale);
+                            if (currentTransform.scale.x < 0.01f) currentTransform.scale = glm::vec3(0.01f);
+                            currentTransform.MarkDirty();
+                        }
+
+                        if (!scene.IsGroup(selectedModelIndex)) {
+                            // Los hijos son relativos al padre: hornearlo los movería
+                            static float lastBakeMs = -1.0f;
+                            bool hasChildren = !currentTransform.children.empty();
+                            ImGui::Spacing();
+                            ImGui::BeginDisabled(hasChildren);
+                            if (ImGui::Button("Aplicar transformación", ImVec2(alignRButton, 0))) {
+                                auto start = std::chrono::steady_clock::now();
+                                currentModel.applyTransformations(currentTransform);
+                                lastBakeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+                            }
+                            ImGui::EndDisabled();
+                            ImGui::SameLine(); HelpMarker(hasChildren ? "No disponible con hijos: sus transformaciones son relativas a esta."
+                                                                      : "Hornea posición, rotación y escala en los vértices y normales, deja la transformación en identidad y vuelve a subir la geometría a la GPU.");
+                            if (lastBakeMs >= 0.0f) ImGui::TextDisabled("Último horneado: %.1f ms", lastBakeMs);
+                        }
+
+                        // --- JERARQUÍA ---
+                        ImGui::Spacing();
+                        ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "JERARQUÍA");
+                        ImGui::SameLine(); HelpMarker("Los valores de arriba son relativos al padre. Al cambiar de padre el modelo conserva su posición en el mundo.");
+                        ImGui::Separator();
+
+                        int parent = currentTransform.parent;
+                        std::string parentLabel = parent == -1 ? "(Ninguno)" : NodeLabel(scene, parent);
+                        ImGui::Text("Padre");
+                        ImGui::SetNextItemWidth(alignRButton);
+                        if (ImGui::BeginCombo("##Parent", parentLabel.c_str())) {
+                            if (ImGui::Selectable("(Ninguno)", parent == -1)) {
+                                SceneGraph::SetParent(scene, selectedModelIndex, -1);
+                            }
+                            // No se ofrecen la luz, el propio modelo ni sus descendientes (crearían un ciclo)
+                            for (int i = 0; i < static_cast<int>(scene.Size()); ++i) {
+                                if (i == selectedModelIndex || scene.IsLight(i)) continue;
+                                if (SceneGraph::IsDescendant(scene, i, selectedModelIndex)) continue;
+                                if (ImGui::Selectable(NodeLabel(scene, i).c_str(), parent == i)) {
+                                    SceneGraph::SetParent(scene, selectedModelIndex, i);
+                                }
+                            }
+                            ImGui::EndCombo();
+                        }
+                        ImGui::TextDisabled("Hijos: %d", static_cast<int>(currentTransform.children.size()));
+                        if (parent != -1) {
+                            ImGui::SameLine();
+                            if (ImGui::SmallButton("Seleccionar padre")) selectedModel = scene.HandleOf(parent);
+                        }
+
+                        // --- SUBMALLAS ---
+                        int submeshCount = static_cast<int>(currentModel.submeshes.size());
+                        if (submeshCount > 0) {
+                            ImGui::Spacing();
+                            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "SUBMALLAS (%d)", submeshCount);
+                            ImGui::SameLine(); HelpMarker("Cada grupo u objeto (g/o) del OBJ se conserva con su propia caja: se descarta por separado, se selecciona con clic y se puede ocultar desde aquí.");
+                            ImGui::Separator();
+
+                            if (ImGui::SmallButton("Mostrar todas")) {
+                                for (Submesh& submesh : currentModel.submeshes) submesh.visible = true;
+                            }
+                            if (state.selectedSubmesh != -1) {
+                                ImGui::SameLine();
+                                if (ImGui::SmallButton("Quitar selección")) state.selectedSubmesh = -1;
+                            }
+
+                            // Lista virtualizada: solo se emiten las filas que caben en pantalla
+                            float rowHeight = ImGui::GetFrameHeightWithSpacing();
+                            float listHeight = std::min(submeshCount, 8) * rowHeight + ImGui::GetStyle().WindowPadding.y * 2.0f;
+                            ImGui::BeginChild("##Submeshes", ImVec2(0, listHeight), ImGuiChildFlags_Borders);
+                            ImGuiListClipper clipper;
+                            clipper.Begin(submeshCount, rowHeight);
+                            while (clipper.Step()) {
+                                for (int s = clipper.DisplayStart; s < clipper.DisplayEnd; ++s) {
+                                    Submesh& submesh = currentModel.submeshes[s];
+                                    ImGui::PushID(s);
+                                    ImGui::Checkbox("##Visible", &submesh.visible);
+                                    ImGui::SameLine();
+
+                                    const char* material = "sin material";
+                                    if (submesh.materialId >= 0 && submesh.materialId < static_cast<int>(currentModel.materialSlots.size())) {
+                                        material = currentModel.materialSlots[submesh.materialId].name.c_str();
+                                    }
+                                    std::string label = submesh.name + "  (" + std::to_string(submesh.indexCount / 3) + " tri, " + material + ")";
+                                    if (ImGui::Selectable(label.c_str(), state.selectedSubmesh == s)) {
+                                        state.selectedSubmesh = state.selectedSubmesh == s ? -1 : s;
+                                    }
+                                    ImGui::PopID();
+                                }
+                            }
+                            ImGui::EndChild();
                         }
                     }
 
@@ -405,17 +725,19 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
                     float windowWidth = ImGui::GetWindowSize().x;
                     float deselWidth = ImGui::CalcTextSize("Deseleccionar").x + 30.0f; 
                     ImGui::SetCursorPosX((windowWidth - deselWidth) * 0.5f);
-                    if (ImGui::Button("Deseleccionar", ImVec2(deselWidth, 30))) selectedModelIndex = -1;
+                    if (ImGui::Button("Deseleccionar", ImVec2(deselWidth, 30))) selectedModel = ModelHandle();
                     
-                    if (!currentModel.isLight) {
+                    if (selectedModelIndex != scene.FindLight()) {
                         ImGui::Spacing();
                         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.8f, 0.2f, 0.2f, 1.0f));
                         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
                         
-                        float elimWidth = ImGui::CalcTextSize("ELIMINAR MODELO").x + 30.0f;
+                        const char* elimLabel = scene.IsGroup(selectedModelIndex) ? "ELIMINAR GRUPO"
+                                              : scene.IsLight(selectedModelIndex) ? "ELIMINAR LUZ" : "ELIMINAR MODELO";
+                        float elimWidth = ImGui::CalcTextSize(elimLabel).x + 30.0f;
                         ImGui::SetCursorPosX((windowWidth - elimWidth) * 0.5f);
-                        if (ImGui::Button("ELIMINAR MODELO", ImVec2(elimWidth, 30))) {
-                            SceneManager::DeleteSelectedModel(models, selectedModelIndex);
+                        if (ImGui::Button(elimLabel, ImVec2(elimWidth, 30))) {
+                            SceneManager::DeleteSelectedModel(scene, selectedModel);
                         }
                         ImGui::PopStyleColor(2);
                     }
@@ -437,7 +759,63 @@ void UIManager::Render(GLFWwindow* window, UIState& state, std::vector<Model>& m
         ImGui::End();
     }
 
-    // 4. Notificaciones TIPO TOAST
+    // 4. Leyenda de las vistas de depuración
+    if (DebugViews::IsDebugMode(state.renderMode)) {
+        ImGui::SetNextWindowBgAlpha(0.75f);
+        ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 15.0f, ImGui::GetIO().DisplaySize.y - 15.0f), ImGuiCond_Always, ImVec2(1.0f, 1.0f));
+        ImGui::Begin("Leyenda", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove);
+        char label[64];
+        switch (DebugViews::FromRenderMode(state.renderMode)) {
+        case DebugView::Overdraw: {
+            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "SOBREDIBUJADO");
+            ImGui::TextDisabled("Fragmentos sombreados por píxel");
+            for (int stop = 0; stop < DebugViews::OVERDRAW_STOPS; ++stop) {
+                float layers = DebugViews::OverdrawStopLayers(stop);
+                snprintf(label, sizeof(label), stop + 1 < DebugViews::OVERDRAW_STOPS ? "%.0f" : "%.0f o más", layers);
+                LegendSwatch(DebugViews::OverdrawColor(layers), label);
+            }
+            ImGui::Separator();
+            ImGui::Text("Media de la escena: %.2f", stats.debugView.overdraw);
+            ImGui::TextDisabled("Por modelo (sombreados / visibles):");
+            const int MAX_ROWS = 8;
+            int rows = 0;
+            for (const ModelOverdraw& entry : stats.debugView.models) {
+                int index = scene.IndexOf(entry.model);
+                if (index == -1) continue;
+                ImGui::Text("%5.2f  %s", entry.overdraw, NodeLabel(scene, index).c_str());
+                if (++rows == MAX_ROWS) break;
+            }
+            if (rows == 0) ImGui::TextDisabled("Midiendo...");
+            break;
+        }
+        case DebugView::TriangleDensity:
+            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "DENSIDAD DE TRIÁNGULOS");
+            ImGui::TextDisabled("Píxeles por triángulo");
+            for (int stop = 0; stop < DebugViews::DENSITY_STOPS; ++stop) {
+                float pixels = DebugViews::DensityStopPixels(stop);
+                const char* format = stop == 0 ? "%.0f o menos" : (stop + 1 < DebugViews::DENSITY_STOPS ? "%.0f" : "%.0f o más");
+                snprintf(label, sizeof(label), format, pixels);
+                LegendSwatch(DebugViews::DensityColor(stop), label);
+            }
+            break;
+        case DebugView::LodLevel:
+            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "NIVEL DE DETALLE");
+            for (int level = 0; level < DebugViews::LOD_LEVELS; ++level) {
+                snprintf(label, sizeof(label), level == 0 ? "LOD 0 (malla completa)" : "LOD %d", level);
+                LegendSwatch(DebugViews::LodColor(level), label);
+            }
+            break;
+        case DebugView::Meshlets:
+            ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "MESHLETS");
+            ImGui::TextDisabled("Un color por meshlet dibujado.");
+            ImGui::TextDisabled("Los modelos sin meshlets o a LOD > 0");
+            ImGui::TextDisabled("se ven de un solo color.");
+            break;
+        }
+        ImGui::End();
+    }
+
+    // 5. Notificaciones TIPO TOAST
     if (notificationTimer > 0.0f) {
         float dt = ImGui::GetIO().DeltaTime;
         if (dt > 0.1f) dt = 0.016f; 
@@ -3,8 +3,16 @@
 #include "../imgui/imgui.h"
 #include "../imgui/imgui_impl_glfw.h"
 #include "../imgui/imgui_impl_opengl3.h"
-#include "../Scene/Model.h"
+#include "../Scene/Scene.h"
 #include <Scene/SceneManager.h>
+#include <Core/OcclusionCulling.h>
+#include <Core/VisibilityCache.h>
+#include <Core/LodSelection.h>
+#include <Core/ClusterCulling.h>
+#include <Graphics/RenderQueue.h>
+#include <Graphics/LightClusters.h>
+#include <Graphics/DepthPrepass.h>
+#include <Graphics/DebugViews.h>
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -22,12 +30,42 @@ struct UIState {
     bool showWireframe = false;
     bool showNormals = false;
     bool enableDepthTest = true;
+    int depthPrepassMode = static_cast<int>(DepthPrepassMode::Auto);
+    float depthPrepassThreshold = 1.5f; // Fragmentos por muestra a partir de los que se activa sola
     bool enableBackFaceCulling = true;
     bool showFPS = true;
     bool enableAntialiasing = true;
     bool showBoundingBox = true;
     bool enableColorChange = false;
     bool showPropertiesPanel = true;
+    bool enableOcclusionCulling = true;
+    bool enableClusterCulling = true;
+    int selectedSubmesh = -1; // Submalla seleccionada dentro del modelo seleccionado (-1 = ninguna)
+    bool enableLod = true;
+    float lodMaxPixelError = 1.0f; // Error máximo tolerado al elegir LOD, en píxeles
+    bool enableScreenSizeCulling = true;
+    float minScreenSize = 2.0f;    // Lado mínimo en píxeles de la AABB proyectada
+    bool enableImpostors = true;
+    float impostorDistance = 25.0f; // A partir de esta distancia el modelo se dibuja como impostor
+    int textureMaxSize = 4096;      // Lado máximo de las texturas al importar
+    int textureBudgetMB = 512;      // VRAM para texturas (0 = sin límite)
+    bool enableClusteredLights = true;
+    int testLightCount = 0;         // Rejilla de luces sintéticas (LightClusters::MakeTestGrid)
+    float testLightRadius = 1.5f;
+};
+
+// Métricas del frame que el bucle principal entrega a la interfaz
+struct FrameStats {
+    OcclusionStats occlusion;
+    VisibilityStats visibility;
+    LodStats lod;
+    ClusterStats clusters;
+    int impostorsDrawn = 0;
+    int impostorsCaptured = 0; // Atlas generados este frame
+    RenderQueueStats renderQueue;
+    LightClusterStats lights;
+    DepthPrepassStats depthPrepass;
+    DebugViewStats debugView;
 };
 
 class UIManager {
@@ -37,5 +75,5 @@ public:
     static void ShowNotification(const std::string& message);
     
     // Función principal que dibuja toda la interfaz
-    static void Render(GLFWwindow* window, UIState& state, std::vector<Model>& models, int& selectedModelIndex, double fps);
+    static void Render(GLFWwindow* window, UIState& state, Scene& scene, ModelHandle& selectedModel, double fps, const FrameStats& stats);
 };
\ No newline at end of file
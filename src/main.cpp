@@ -1,14 +1,25 @@
 // Librerias necesarias 
 #include "Graphics/Shader.h"
 #include "Core/Camera.h"
-#include "Scene/Model.h"
+#include "Scene/Scene.h"
 #include "Graphics/Grid.h"
 #include "Scene/SceneManager.h"
 #include "Core/Window.h"
 #include "Core/InputController.h"
 #include "UI/UIManager.h"
 #include "Graphics/Shaders.h"
-#include "Core/FrustumCulling.h"
+#include "Core/OcclusionCulling.h"
+#include "Core/VisibilityCache.h"
+#include "Core/LodSelection.h"
+#include "Core/ClusterCulling.h"
+#include "Graphics/Impostor.h"
+#include "Graphics/DebugDraw.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/LightClusters.h"
+#include "Graphics/DepthPrepass.h"
+#include "Graphics/DebugViews.h"
+#include "Graphics/TextureCodec.h"
+#include "Scene/MaterialLibrary.h"
 
 // Librerias estandar
 #include <iostream>
@@ -41,6 +52,7 @@ int main() {
     GLFWwindow* window = Window::Init(screenWidth, screenHeight, "ViewerOBJ Pro");
     if (!window) return -1;
     Window::ShowSplashScreen(window, "icon.png");
+    TextureCodec::Init();
 
     glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
     glfwGetFramebufferSize(window, &screenWidth, &screenHeight);
@@ -52,19 +64,34 @@ int main() {
     globalCameraPtr = &camera;
     UIState ui;
     UIManager::Init(window); 
-    Grid grid(20.0f, 20, 5);
+    Grid grid(-0.5f, 0.2f, 5, 30.0f);
+    ImpostorRenderer impostors;
+    DebugDraw::Init();
+    RenderQueue renderQueue;
+    LightClusters lightClusters;
+    DepthPrepass depthPrepass;
+    DebugViews debugViews;
+    std::vector<PointLight> pointLights; // Se rellena cada frame
+    std::vector<PointLight> testLights;
+    float testLightRadius = 0.0f;
     glfwSetScrollCallback(window, ScrollCallback);
 
     glm::vec3 bgColor(0.46f, 0.46f, 0.46f); // Color de fondo inicial
 
-    std::vector<Model> models; 
-    SceneManager::AddLight(models);
-    if (!models.empty()) {
-        models[0].position = glm::vec3(1.2f, 1.0f, 2.0f);
-        models[0].updateTransformMatrix(); 
+    Scene scene; 
+    int lightIndex = scene.IndexOf(SceneManager::AddLight(scene));
+    if (lightIndex != -1) {
+        scene.transforms[lightIndex].position = glm::vec3(1.2f, 1.0f, 2.0f);
+        scene.transforms[lightIndex].MarkDirty(); 
     }
 
-    int selectedModelIndex = -1; // Índice del modelo seleccionado
+    ModelHandle selectedModel; // Handle estable del modelo seleccionado
+    ModelHandle submeshOwner;  // Modelo al que pertenece ui.selectedSubmesh
+    OcclusionCulling occlusionCulling;
+    VisibilityCache visibilityCache; // Evita repetir el culling si nada cambió
+    std::vector<int> changedModels;  // Modelos cuya transformación se recalculó este frame
+    FrameStats frameStats;
+    std::vector<char> drawAsImpostor; // Por índice denso; se rellena cada frame
     glm::vec2 lastMousePos(0.0f, 0.0f); // Obtener la posición del cursor
       
     // Variables para FPS promedio
@@ -115,13 +142,21 @@ int main() {
             glDisable(GL_MULTISAMPLE); 
         }
 
+        // Límites de tamaño de las texturas que se importen a partir de ahora
+        TextureCodec::SetLimits(ui.textureMaxSize, static_cast<size_t>(ui.textureBudgetMB) * 1024 * 1024);
+
         // Activar el blending
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         
+        // Vistas de depuración: el mapa de sobredibujado suma colores y necesita fondo negro
+        bool debugView = DebugViews::IsDebugMode(ui.renderMode);
+        bool overdrawView = debugView && DebugViews::FromRenderMode(ui.renderMode) == DebugView::Overdraw;
+
         // Actualizar el color de fondo y limpiar buffers
         InputController::changeBackgroundColor(window, bgColor);
-        glClearColor(bgColor.r, bgColor.g, bgColor.b, 1.0f);
+        glm::vec3 clearColor = overdrawView ? glm::vec3(0.0f) : bgColor;
+        glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
 
         glfwPollEvents();
@@ -144,37 +179,38 @@ int main() {
             float distance = glm::length(mouseReleaseEnd - mousePressStart);
 
             if (distance < 5.0f) {
-                int pickedIndex = SceneManager::PickModel(window, models, camera);
-                
-                if (pickedIndex != -1) {
-                    selectedModelIndex = pickedIndex;
-                } else {
-                    selectedModelIndex = -1; 
-                }
-                glClearColor(bgColor.r, bgColor.g, bgColor.b, 1.0f); 
+                // Devuelve un handle nulo si se hizo clic en el vacío
+                selectedModel = SceneManager::PickModel(window, scene, camera, &ui.selectedSubmesh);
+                submeshOwner = selectedModel;
+                glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f); 
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
               
             }
         }
         
+        // Si la selección cambió por otra vía (inspector, borrado...) la submalla ya no aplica
+        if (selectedModel != submeshOwner) {
+            ui.selectedSubmesh = -1;
+            submeshOwner = selectedModel;
+        }
+
         // Manejo de cámara y transformación
+        int selectedModelIndex = scene.IndexOf(selectedModel);
         if (selectedModelIndex == -1) {
             camera.handleInput(window);           
         } else {
-            InputController::handleModelRotation(window, models[selectedModelIndex], lastMousePos, 0.3f);
+            InputController::handleModelRotation(window, scene.transforms[selectedModelIndex], lastMousePos, 0.3f);
         }
   
-        // Verificar colisiones
-        for (auto& model : models) {
-            SceneManager::CheckCollisionWithPlatform(model, -0.5f);
-        }
+        // Actualizar matrices, AABB y colisiones solo de los modelos modificados
+        SceneManager::UpdateTransforms(scene, -0.5f, changedModels);
 
         // Renderizar la cuadrícula
         glUniform1i(glGetUniformLocation(shaderProgram, "isLightSource"), 0); 
         glUniform1i(glGetUniformLocation(shaderProgram, "useVertexColor"), 0);
         glUniform1i(glGetUniformLocation(shaderProgram, "useWireframeColor"), 0);
         glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, glm::value_ptr(glm::vec3(0.7f)));
-        grid.draw(shaderProgram, camera.getViewMatrix(), camera.getProjectionMatrix(), glm::vec3(0.7f, 0.7f, 0.7f));
+        if (!overdrawView) grid.draw(camera.getViewMatrix(), camera.getProjectionMatrix(), glm::vec3(0.7f, 0.7f, 0.7f));
 /*
         for (size_t i = 0; i < models.size(); ++i) {
             if ((int)i == selectedModelIndex && !models[i].isLight) {
@@ -195,42 +231,160 @@ int main() {
         glm::vec3 currentLightPos(1.2f, 1.0f, 2.0f); // Creamos una luz
         glm::vec3 currentLightColor(1.0f);
 
-        for (const auto& m : models) {
-            if (m.isLight) {
-                currentLightPos = m.position; 
-                currentLightColor = m.color;  
-                break; 
-            }
+        lightIndex = scene.FindLight();
+        if (lightIndex != -1) {
+            currentLightPos = scene.transforms[lightIndex].position; 
+            currentLightColor = scene.meshes[lightIndex].color;  
         }
 
         glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 1, glm::value_ptr(currentLightPos));
         glUniform3fv(glGetUniformLocation(shaderProgram, "lightColor"), 1, glm::value_ptr(currentLightColor));
+
+        // Luces puntuales: las de la escena salvo la principal, más la rejilla de prueba
+        if (ui.testLightCount != static_cast<int>(testLights.size()) || ui.testLightRadius != testLightRadius) {
+            testLights = LightClusters::MakeTestGrid(ui.testLightCount, ui.testLightRadius);
+            testLightRadius = ui.testLightRadius;
+        }
+        pointLights.assign(testLights.begin(), testLights.end());
+        for (int i = 0; i < static_cast<int>(scene.Size()); ++i) {
+            if (!scene.IsLight(i) || i == lightIndex) continue;
+            PointLight light;
+            light.position = glm::vec3(scene.transforms[i].worldMatrix[3]);
+            light.radius = scene.meshes[i].lightRadius;
+            light.color = scene.meshes[i].color;
+            pointLights.push_back(light);
+        }
+        if (ui.enableClusteredLights) {
+            lightClusters.Assign(pointLights, camera.getViewMatrix(), camera.getProjectionMatrix());
+            lightClusters.Upload();
+            frameStats.lights = lightClusters.GetStats();
+            for (const PointLight& light : testLights) DebugDraw::Point(light.position, light.color);
+        } else {
+            frameStats.lights = LightClusterStats();
+        }
+        // Los samplers se asignan siempre: sin unidad propia chocarían con el array de texturas
+        lightClusters.Bind(shaderProgram, glm::vec2(currentWidth, currentHeight));
+        glUniform1i(glGetUniformLocation(shaderProgram, "useClusteredLights"), ui.enableClusteredLights && !pointLights.empty() ? 1 : 0);
         glm::mat4 viewProjMatrix = camera.getProjectionMatrix() * camera.getViewMatrix();
 
-        for (size_t i = 0; i < models.size(); ++i) {
-            if (!models[i].isLight && !Utils::isAABBInFrustum(models[i], viewProjMatrix)) {
-                continue; 
+        VisibilitySettings visibilitySettings;
+        visibilitySettings.occlusion = ui.enableOcclusionCulling ? &occlusionCulling : nullptr;
+        visibilitySettings.minScreenSize = ui.enableScreenSizeCulling ? ui.minScreenSize : 0.0f;
+        visibilitySettings.viewportSize = glm::vec2(currentWidth, currentHeight);
+        const std::vector<int>& visibleModels = visibilityCache.Resolve(scene, changedModels, viewProjMatrix, camera.generation, visibilitySettings);
+        frameStats.visibility = visibilityCache.GetStats();
+        if (ui.enableOcclusionCulling) {
+            frameStats.occlusion = occlusionCulling.GetStats();
+        } else {
+            frameStats.occlusion = OcclusionStats();
+            frameStats.occlusion.drawn = static_cast<int>(visibleModels.size());
+        }
+
+        // Elegir el nivel de detalle de cada modelo visible según su error proyectado en pantalla
+        frameStats.lod = LodStats();
+        float lodPixelScale = Utils::lodPixelScale(camera.getProjectionMatrix(), static_cast<float>(currentHeight));
+        for (int i : visibleModels) {
+            Model& mesh = scene.meshes[i];
+            bool useLod = ui.enableLod && !mesh.hasHiddenSubmeshes();
+            mesh.activeLod = useLod ? Utils::selectLod(mesh, scene.bounds[i], scene.transforms[i].worldMatrix, camPos, lodPixelScale, ui.lodMaxPixelError) : 0;
+            frameStats.lod.fullTriangles += static_cast<int>(mesh.getTriangleCount(0));
+            frameStats.lod.drawnTriangles += static_cast<int>(mesh.getTriangleCount(mesh.activeLod));
+        }
+
+        // Streaming de texturas: cada material visible pide el mip que necesita según cuántas
+        // unidades de UV caen en un píxel; después se suben o expulsan niveles dentro del presupuesto
+        for (int i : visibleModels) {
+            const Model& mesh = scene.meshes[i];
+            if (!mesh.hasTexture) continue;
+            float pixelsPerUnit = Utils::pixelsPerLocalUnit(scene.bounds[i], scene.transforms[i].worldMatrix, camPos, lodPixelScale);
+            for (size_t slot = 0; slot < mesh.materialIds.size(); ++slot) {
+                if (mesh.materialSlots[slot].uvDensity <= 0.0f) continue; // Sin UV basta la cola de mips
+                TextureArrays::Touch(MaterialLibrary::Get(mesh.materialIds[slot]).texture, mesh.materialSlots[slot].uvDensity / pixelsPerUnit);
             }
+        }
+        TextureArrays::UpdateStreaming(static_cast<size_t>(ui.textureBudgetMB) * 1024 * 1024);
+
+        // Los modelos lejanos se sustituyen por su impostor; el atlas se captura la primera vez
+        // que hace falta, con un máximo de capturas por frame para no provocar tirones
+        const int MAX_CAPTURES_PER_FRAME = 2;
+        drawAsImpostor.assign(scene.Size(), 0);
+        frameStats.impostorsDrawn = 0;
+        frameStats.impostorsCaptured = 0;
+        if (ui.enableImpostors && !debugView) {
+            for (int i : visibleModels) {
+                if (scene.IsLight(i) || i == selectedModelIndex || scene.meshes[i].hasHiddenSubmeshes()) continue;
+                const Bounds& b = scene.bounds[i];
+                if (glm::length((b.worldMin + b.worldMax) * 0.5f - camPos) < ui.impostorDistance) continue;
+
+                Model& mesh = scene.meshes[i];
+                if (mesh.impostorAlbedo == 0) {
+                    if (frameStats.impostorsCaptured >= MAX_CAPTURES_PER_FRAME) continue;
+                    frameStats.impostorsCaptured++;
+                    if (!impostors.Capture(mesh)) continue;
+                }
+                drawAsImpostor[i] = 1;
+                frameStats.impostorsDrawn++;
+            }
+        }
 
-            glUniform1i(glGetUniformLocation(shaderProgram, "isLightSource"), models[i].isLight ? 1 : 0);
-            glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, glm::value_ptr(models[i].color));
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(models[i].transformMatrix));
-            
-            if (models[i].hasTexture) {
-                glActiveTexture(GL_TEXTURE0); 
-                glBindTexture(GL_TEXTURE_2D, models[i].textureID);
-                glUniform1i(glGetUniformLocation(shaderProgram, "hasTexture"), 1);
-                glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0); 
+        // En los modelos dibujados a LOD 0, descartar submallas ocultas o fuera de cámara y los
+        // meshlets fuera de cámara o de espaldas
+        frameStats.clusters = ClusterStats();
+        Utils::Frustum frustum = Utils::extractFrustum(viewProjMatrix);
+        for (int i : visibleModels) {
+            Model& mesh = scene.meshes[i];
+            bool useMeshlets = ui.enableClusterCulling && !mesh.meshlets.empty();
+            bool splitDraw = useMeshlets || mesh.submeshes.size() > 1;
+            if (splitDraw && !drawAsImpostor[i] && mesh.activeLod == 0) {
+                Utils::cullClusters(mesh, scene.transforms[i].worldMatrix, frustum, camPos, useMeshlets, ui.enableBackFaceCulling, frameStats.clusters);
             } else {
-                glUniform1i(glGetUniformLocation(shaderProgram, "hasTexture"), 0);
+                mesh.collectBatches(mesh.activeLod);
             }
+        }
 
-            // 1. CAPA BASE: Relleno sólido/Textura
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            glUniform1i(glGetUniformLocation(shaderProgram, "useVertexColor"), 0);
-            glUniform1i(glGetUniformLocation(shaderProgram, "useWireframeColor"), 0);
-            glUniform1f(glGetUniformLocation(shaderProgram, "globalAlpha"), ui.showWireframe ? 0.5f : 1.0f);
-            models[i].draw(shaderProgram);
+        // 1. CAPA BASE: Relleno sólido/Textura. Las luces y los modelos sin materiales se dibujan
+        // sueltos; el resto pasa por la cola ordenada por material
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glUniform1i(glGetUniformLocation(shaderProgram, "useVertexColor"), 0);
+        glUniform1i(glGetUniformLocation(shaderProgram, "useWireframeColor"), 0);
+        glUniform1f(glGetUniformLocation(shaderProgram, "globalAlpha"), ui.showWireframe ? 0.5f : 1.0f);
+        glUniform1i(glGetUniformLocation(shaderProgram, "hasTexture"), 0);
+        if (debugView) {
+            debugViews.Draw(DebugViews::FromRenderMode(ui.renderMode), scene, visibleModels, drawAsImpostor,
+                            camera.getViewMatrix(), camera.getProjectionMatrix(), glm::vec2(currentWidth, currentHeight));
+            frameStats.debugView = debugViews.GetStats();
+        } else {
+            renderQueue.Build(scene, visibleModels, drawAsImpostor);
+            // Con GL_EQUAL el orden deja de importar, así que solo vale si la capa es opaca: sin la
+            // transparencia del alambrado ni la del holograma
+            bool opaqueBase = ui.enableDepthTest && !ui.showWireframe && ui.renderMode != 6;
+            depthPrepass.Begin(static_cast<DepthPrepassMode>(ui.depthPrepassMode), ui.depthPrepassThreshold, opaqueBase,
+                               scene, visibleModels, drawAsImpostor, camera.getViewMatrix(), camera.getProjectionMatrix(),
+                               currentWidth * currentHeight);
+            for (int i : visibleModels) {
+                if (drawAsImpostor[i]) continue;
+                Model& mesh = scene.meshes[i];
+                bool isLight = scene.IsLight(i);
+                if (!isLight && !mesh.materialRanges.empty()) continue;
+
+                glUniform1i(glGetUniformLocation(shaderProgram, "isLightSource"), isLight ? 1 : 0);
+                mesh.draw(shaderProgram, scene.transforms[i].worldMatrix);
+            }
+            glUniform1i(glGetUniformLocation(shaderProgram, "isLightSource"), 0);
+            renderQueue.Draw(shaderProgram, scene);
+            depthPrepass.End();
+            frameStats.renderQueue = renderQueue.GetStats();
+            frameStats.depthPrepass = depthPrepass.GetStats();
+        }
+        glUniform1i(glGetUniformLocation(shaderProgram, "hasTexture"), 0);
+
+        for (int i : visibleModels) {
+            if (drawAsImpostor[i]) continue;
+            Model& mesh = scene.meshes[i];
+            const glm::mat4& worldMatrix = scene.transforms[i].worldMatrix;
+            bool isLight = scene.IsLight(i);
+            glUniform1i(glGetUniformLocation(shaderProgram, "isLightSource"), isLight ? 1 : 0);
+            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(worldMatrix));
 
             // Evitar el Z-fighting desplazando sutilmente la profundidad de líneas y puntos hacia la cámara
             glEnable(GL_POLYGON_OFFSET_LINE);
@@ -238,22 +392,22 @@ int main() {
             glPolygonOffset(-1.0f, -1.0f);
 
             // 2. CAPA SUPERPUESTA: Alambrado
-            if (ui.showWireframe && !models[i].isLight) {
+            if (ui.showWireframe && !isLight) {
                 glUniform1f(glGetUniformLocation(shaderProgram, "globalAlpha"), 1.0f);
                 glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
                 glUniform1i(glGetUniformLocation(shaderProgram, "useWireframeColor"), 1);
                 glUniform3fv(glGetUniformLocation(shaderProgram, "wireframeColor"), 1, glm::value_ptr(ui.wireframeColor));
-                models[i].draw(shaderProgram);
+                mesh.draw(shaderProgram, worldMatrix);
                 glUniform1i(glGetUniformLocation(shaderProgram, "useWireframeColor"), 0); // Restaurar
             }
 
             // 3. CAPA SUPERPUESTA: Vértices
-            if (ui.showVertices && !models[i].isLight) {
+            if (ui.showVertices && !isLight) {
                 glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
                 glUniform1f(glGetUniformLocation(shaderProgram, "pointSize"), ui.vertexSize);
                 glUniform3fv(glGetUniformLocation(shaderProgram, "vertexColor"), 1, glm::value_ptr(ui.vertexColor));
                 glUniform1i(glGetUniformLocation(shaderProgram, "useVertexColor"), 1);
-                models[i].draw(shaderProgram);
+                mesh.draw(shaderProgram, worldMatrix);
                 glUniform1i(glGetUniformLocation(shaderProgram, "useVertexColor"), 0); // Restaurar
             }
 
@@ -261,15 +415,29 @@ int main() {
             glDisable(GL_POLYGON_OFFSET_LINE);
             glDisable(GL_POLYGON_OFFSET_POINT);
             
-            // 4. CAPA SUPERPUESTA: Debug (Normales y Cajas)
+            // 4. CAPA SUPERPUESTA: Debug (Normales y Cajas), se dibuja toda junta al final
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); 
-            if (ui.showNormals && !models[i].isLight) {
-                models[i].drawDebugNormals(shaderProgram, ui.normalsColor);
+            if (ui.showNormals && !isLight) {
+                DebugDraw::Normals(mesh, worldMatrix, 0.1f, ui.normalsColor);
+            }
+            if (ui.showBoundingBox && selectedModelIndex == i) {
+                if (ui.selectedSubmesh >= 0 && ui.selectedSubmesh < static_cast<int>(mesh.submeshes.size())) {
+                    const Submesh& submesh = mesh.submeshes[ui.selectedSubmesh];
+                    DebugDraw::Box(submesh.minBounds, submesh.maxBounds, worldMatrix, ui.boundingBoxColor);
+                } else if (ui.selectedSubmesh == -1) {
+                    DebugDraw::Box(mesh.localMinBounds, mesh.localMaxBounds, worldMatrix, ui.boundingBoxColor);
+                }
             }
-            if (ui.showBoundingBox && selectedModelIndex == (int)i) {
-                models[selectedModelIndex].drawDebugBoundingBox(shaderProgram, ui.boundingBoxColor);             
+        }
+
+        if (frameStats.impostorsDrawn > 0) {
+            impostors.Begin(camera.getViewMatrix(), camera.getProjectionMatrix(), currentLightPos, currentLightColor, ui.renderMode);
+            for (int i : visibleModels) {
+                if (drawAsImpostor[i]) impostors.Draw(scene.meshes[i], scene.transforms[i].worldMatrix, camPos);
             }
+            impostors.End();
         }
+        DebugDraw::Flush(camera.getViewMatrix(), camera.getProjectionMatrix());
 
         // Atajos del teclado  
         bool ctrlPressed = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || 
@@ -279,7 +447,7 @@ int main() {
         static bool isImporting = false; 
         if (ctrlPressed && glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
             if (!isImporting) {
-                SceneManager::ImportModel(models);
+                SceneManager::ImportModel(scene);
                 isImporting = true; 
             }
         } else {
@@ -290,7 +458,7 @@ int main() {
         static bool isSaving = false;
         if (ctrlPressed && glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
             if (!isSaving) {
-                if (SceneManager::Save(models)) {
+                if (SceneManager::Save(scene)) {
                     UIManager::ShowNotification("Escena guardada correctamente.");
                 }
                 isSaving = true;
@@ -303,8 +471,8 @@ int main() {
         static bool isLoading = false;
         if (ctrlPressed && glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
             if (!isLoading) {
-                selectedModelIndex = -1;
-                SceneManager::Load(models); 
+                selectedModel = ModelHandle();
+                SceneManager::Load(scene); 
                 isLoading = true;
             }
         } else {
@@ -315,8 +483,8 @@ int main() {
         static bool isClearing = false;
         if (ctrlPressed && glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS) {
             if (!isClearing) {
-                selectedModelIndex = -1;
-                SceneManager::Clear(models);
+                selectedModel = ModelHandle();
+                SceneManager::Clear(scene);
                 UIManager::ShowNotification("Escena limpiada correctamente.");
                 isClearing = true;
             }
@@ -326,8 +494,9 @@ int main() {
 
         // ELIMINAR MODELO SELECCIONADO (Backspace o Supr)
         if ((glfwGetKey(window, GLFW_KEY_BACKSPACE) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_DELETE) == GLFW_PRESS)) {
-            if (selectedModelIndex != -1 && !models[selectedModelIndex].isLight) {
-                SceneManager::DeleteSelectedModel(models, selectedModelIndex);
+            int deleteIndex = scene.IndexOf(selectedModel);
+            if (deleteIndex != -1 && deleteIndex != scene.FindLight()) {
+                SceneManager::DeleteSelectedModel(scene, selectedModel);
             }
         }
 
@@ -336,22 +505,29 @@ int main() {
             glfwSetWindowShouldClose(window, true);
         }
 
-        if (SceneManager::CheckAsyncLoad(models)) {
+        if (SceneManager::CheckAsyncLoad(scene)) {
             ui.renderMode = 1;
             UIManager::ShowNotification("Modelo cargado correctamente."); 
         }
 
         bool sceneHasTexture = false;
-        if (SceneManager::CheckAsyncSceneLoad(models, sceneHasTexture)) {
-            selectedModelIndex = -1;
+        if (SceneManager::CheckAsyncSceneLoad(scene, sceneHasTexture)) {
+            selectedModel = ModelHandle();
             if (sceneHasTexture) ui.renderMode = 1;
             UIManager::ShowNotification("Escena cargada correctamente.");
         }
 
-        UIManager::Render(window, ui, models, selectedModelIndex, fps);
+        UIManager::Render(window, ui, scene, selectedModel, fps, frameStats);
         glfwSwapBuffers(window);
     }
 
+    impostors.Release();
+    lightClusters.Release();
+    depthPrepass.Release();
+    debugViews.Release();
+    grid.release();
+    DebugDraw::Shutdown();
+
     // Finalizar Dear ImGui
     UIManager::Shutdown();
 